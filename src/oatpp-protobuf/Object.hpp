@@ -25,8 +25,11 @@
 #ifndef oatpp_protobuf_Object_hpp
 #define oatpp_protobuf_Object_hpp
 
+#include "codec/Codec.hpp"
 #include "reflection/DynamicObject.hpp"
 
+#include <atomic>
+
 namespace oatpp { namespace protobuf {
 
 namespace __class {
@@ -37,6 +40,55 @@ namespace __class {
   class AbstractObject {
   public:
     static const oatpp::ClassId CLASS_ID;
+  public:
+
+    /**
+     * Polymorphic Dispatcher. Gives type-erased access to the proto object held by &l:Object;.
+     */
+    class PolymorphicDispatcher {
+    public:
+
+      /**
+       * Virtual destructor.
+       */
+      virtual ~PolymorphicDispatcher() = default;
+
+      /**
+       * Get &id:oatpp::protobuf::reflection::DynamicClass; of the proto object type.
+       * @return
+       */
+      virtual reflection::DynamicClass* getDynamicClass() const = 0;
+
+      /**
+       * Create new empty proto object.
+       * @return - &l:Object;.
+       */
+      virtual oatpp::Void createObject() const = 0;
+
+      /**
+       * Create new empty proto object on the arena. <br>
+       * Nested messages and strings of the object are allocated on the same arena.
+       * The object holds shared ownership of the arena.
+       * @param arena - `google::protobuf::Arena`. If `nullptr` - the object is heap-allocated.
+       * @return - &l:Object;.
+       */
+      virtual oatpp::Void createObject(const std::shared_ptr<google::protobuf::Arena>& arena) const = 0;
+
+      /**
+       * Get proto object held by the object wrapper.
+       * @param object - &l:Object;.
+       * @return
+       */
+      virtual reflection::Message* getMessage(const oatpp::Void& object) const = 0;
+
+      /**
+       * Get generated codec of the proto object type.
+       * @return - &id:oatpp::protobuf::codec::AbstractCodec;. `nullptr` if no codec is registered for the type.
+       */
+      virtual const codec::AbstractCodec* getCodec() const = 0;
+
+    };
+
   };
 
   template<class T>
@@ -55,27 +107,94 @@ namespace __class {
   class Object : public AbstractObject {
   private:
 
+    /*
+     * Class of T is bound once per T - conversions don't go to the registry.
+     */
+    static reflection::DynamicClass* getDynamicClass() {
+      static reflection::DynamicClass* clazz = reflection::DynamicClass::registryGetClass<T>();
+      return clazz;
+    }
+
     class Inter : public oatpp::Type::AbstractInterpretation {
+    private:
+      bool m_useArena;
+      bool m_zeroCopy;
     public:
 
+      Inter(bool useArena, bool zeroCopy)
+        : m_useArena(useArena)
+        , m_zeroCopy(zeroCopy)
+      {}
+
       oatpp::Void toInterpretation(const Void& originalValue) const override {
         const auto& value = originalValue.staticCast<oatpp::protobuf::Object<T>>();
-        auto ptr = reflection::DynamicObject::createShared(*value.getPtr());
-        return oatpp::Void(ptr, ptr->getClass()->getType());
+        std::shared_ptr<const reflection::Message> owner;
+        if(m_zeroCopy) {
+          owner = value.getPtr();
+        }
+        auto ptr = reflection::DynamicObject::createShared(getDynamicClass(), *value.getPtr(), owner);
+        return oatpp::Void(ptr, getInterpretationType());
       }
 
       oatpp::Void fromInterpretation(const Void& interValue) const override {
         if(interValue) {
           auto obj = static_cast<reflection::DynamicObject*>(interValue.get());
-          auto ptr = obj->toProto();
+          auto ptr = obj->toProto(m_useArena ? std::make_shared<google::protobuf::Arena>() : nullptr);
           return oatpp::Void(ptr, Object::getType());
         }
         return nullptr;
       }
 
       const oatpp::Type* getInterpretationType() const override {
-        auto clazz = reflection::DynamicClass::registryGetClass<T>();
-        return clazz->getType();
+        static const oatpp::Type* type = getDynamicClass()->getType();
+        return type;
+      }
+
+    };
+
+    class PolymorphicDispatcher : public AbstractObject::PolymorphicDispatcher {
+    public:
+
+      reflection::DynamicClass* getDynamicClass() const override {
+        return Object::getDynamicClass();
+      }
+
+      oatpp::Void createObject() const override {
+        return oatpp::Void(std::make_shared<T>(), Object::getType());
+      }
+
+      oatpp::Void createObject(const std::shared_ptr<google::protobuf::Arena>& arena) const override {
+        if(arena) {
+          auto message = google::protobuf::Arena::CreateMessage<T>(arena.get());
+          return oatpp::Void(std::shared_ptr<T>(arena, message), Object::getType());
+        }
+        return createObject();
+      }
+
+      reflection::Message* getMessage(const oatpp::Void& object) const override {
+        return static_cast<T*>(object.get());
+      }
+
+      const codec::AbstractCodec* getCodec() const override {
+        /*
+         * codecs are registered during static initialization, which may run after the first lookup
+         * (static initializers of other translation units, late-linked static libraries) -
+         * a found codec is cached for good, a miss is re-checked once new codecs are registered.
+         */
+        static std::atomic<const codec::AbstractCodec*> cachedCodec(nullptr);
+        static std::atomic<v_int64> cachedVersion(-1);
+        auto codec = cachedCodec.load(std::memory_order_acquire);
+        if(codec == nullptr) {
+          v_int64 version = codec::AbstractCodec::registryGetVersion();
+          if(cachedVersion.load(std::memory_order_acquire) != version) {
+            codec = codec::AbstractCodec::registryGetCodec(T::descriptor()->full_name());
+            if(codec != nullptr) {
+              cachedCodec.store(codec, std::memory_order_release);
+            }
+            cachedVersion.store(version, std::memory_order_release);
+          }
+        }
+        return codec;
       }
 
     };
@@ -84,9 +203,11 @@ namespace __class {
 
     static oatpp::Type* getType(){
       static Type type(
-        CLASS_ID, nullptr, nullptr,
+        CLASS_ID, nullptr, new PolymorphicDispatcher(),
         {
-          {"protobuf", new Inter()}
+          {"protobuf", new Inter(false, false)},
+          {"protobuf-arena", new Inter(true, false)},
+          {"protobuf-zero-copy", new Inter(false, true)}
         }
       );
       return &type;
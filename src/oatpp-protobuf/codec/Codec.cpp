@@ -0,0 +1,75 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#include "Codec.hpp"
+
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+
+namespace oatpp { namespace protobuf { namespace codec {
+
+namespace {
+
+/*
+ * Codecs are registered from static initializers of other translation units - the registry must be
+ * initialized on first use.
+ */
+struct Registry {
+  std::mutex mutex;
+  std::unordered_map<std::string, const AbstractCodec*> codecs;
+  std::atomic<v_int64> version{0};
+};
+
+Registry& getRegistry() {
+  static Registry registry;
+  return registry;
+}
+
+}
+
+bool AbstractCodec::registryAddCodec(const char* typeName, const AbstractCodec* codec) {
+  auto& registry = getRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  registry.codecs[typeName] = codec;
+  registry.version.fetch_add(1, std::memory_order_release);
+  return true;
+}
+
+const AbstractCodec* AbstractCodec::registryGetCodec(const std::string& typeName) {
+  auto& registry = getRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  auto it = registry.codecs.find(typeName);
+  if(it != registry.codecs.end()) {
+    return it->second;
+  }
+  return nullptr;
+}
+
+v_int64 AbstractCodec::registryGetVersion() {
+  return getRegistry().version.load(std::memory_order_acquire);
+}
+
+}}}
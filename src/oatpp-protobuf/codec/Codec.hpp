@@ -0,0 +1,112 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#ifndef oatpp_protobuf_codec_Codec_hpp
+#define oatpp_protobuf_codec_Codec_hpp
+
+#include "oatpp-protobuf/reflection/Utils.hpp"
+
+#include "oatpp/parser/json/mapping/Serializer.hpp"
+#include "oatpp/parser/json/mapping/Deserializer.hpp"
+
+namespace oatpp { namespace protobuf { namespace codec {
+
+/**
+ * Type-erased codec of the proto object type. <br>
+ * Codecs are generated by the `protoc-gen-oatpp` plugin. They use generated accessors of the proto object
+ * and don't go through `google::protobuf::Reflection`.
+ */
+class AbstractCodec {
+public:
+  typedef oatpp::parser::json::mapping::Serializer JsonSerializer;
+  typedef oatpp::parser::json::mapping::Deserializer JsonDeserializer;
+  typedef oatpp::data::stream::ConsistentOutputStream ConsistentOutputStream;
+public:
+
+  /**
+   * Virtual destructor.
+   */
+  virtual ~AbstractCodec() = default;
+
+  /**
+   * Write proto message as json. <br>
+   * Same output as of &id:oatpp::protobuf::json::Serializer::serializeMessage;.
+   * @param serializer - oatpp json serializer. Its config is respected.
+   * @param stream - output stream.
+   * @param message - proto message. Must be of the codec type.
+   */
+  virtual void writeJson(JsonSerializer* serializer, ConsistentOutputStream* stream, const reflection::Message& message) const = 0;
+
+  /**
+   * Read json object into the proto message. <br>
+   * Same behaviour as of &id:oatpp::protobuf::json::Deserializer::deserializeMessage;.
+   * @param deserializer - oatpp json deserializer. Its config is respected.
+   * @param caret - parsing caret. Errors are reported via the caret.
+   * @param message - proto message. Must be of the codec type.
+   */
+  virtual void readJson(JsonDeserializer* deserializer, parser::Caret& caret, reflection::Message& message) const = 0;
+
+public:
+
+  /**
+   * Register codec of the proto object type. <br>
+   * Called by the generated `<name>.oatpp.hpp` headers during static initialization.
+   * Registering the same codec again has no effect.
+   * @param typeName - full name of the proto object type. Ex.: `package.Message`.
+   * @param codec - codec instance. Must live as long as the program.
+   * @return - always `true`.
+   */
+  static bool registryAddCodec(const char* typeName, const AbstractCodec* codec);
+
+  /**
+   * Get codec of the proto object type.
+   * @param typeName - full name of the proto object type.
+   * @return - &l:AbstractCodec;. `nullptr` if no codec is registered for the type - the type is converted via reflection.
+   */
+  static const AbstractCodec* registryGetCodec(const std::string& typeName);
+
+  /**
+   * Get version of the registry - incremented each time a codec is registered. <br>
+   * Lets callers cache a miss of &l:AbstractCodec::registryGetCodec (); until new codecs are registered.
+   * @return
+   */
+  static v_int64 registryGetVersion();
+
+};
+
+/**
+ * Codec of the proto object type. <br>
+ * The plugin generates a specialization for each message type in the `<name>.oatpp.hpp` header. <br>
+ * The primary template is declared only - there is no "no codec" definition which could be instantiated
+ * in one translation unit while another one sees the generated specialization.
+ * &id:oatpp::protobuf::Object; finds codecs at runtime via &l:AbstractCodec::registryGetCodec ();.
+ * @tparam T - proto object type.
+ */
+template<class T>
+class Codec;
+
+}}}
+
+#endif // oatpp_protobuf_codec_Codec_hpp
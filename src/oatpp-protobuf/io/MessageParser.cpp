@@ -0,0 +1,396 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#include "MessageParser.hpp"
+
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/stubs/common.h>
+
+#include <limits>
+
+namespace oatpp { namespace protobuf { namespace io {
+
+constexpr v_uint32 MessageParser::MAX_DEPTH;
+
+MessageParser::MessageParser(const oatpp::Type* type, const std::shared_ptr<google::protobuf::Arena>& arena)
+  : m_state(STATE_TAG)
+  , m_varintStart(0)
+  , m_tag(0)
+  , m_remaining(0)
+  , m_offset(0)
+  , m_field(nullptr)
+  , m_errorMessage(nullptr)
+{
+  if(type->classId.id != __class::AbstractObject::CLASS_ID.id) {
+    throw std::runtime_error(std::string("[oatpp::protobuf::io::MessageParser::MessageParser()]: "
+                             "Error. Unsupported type '") + type->classId.name + "'. Only oatpp::protobuf::Object<T> is supported.");
+  }
+  auto dispatcher = static_cast<const __class::AbstractObject::PolymorphicDispatcher*>(type->polymorphicDispatcher);
+  m_object = dispatcher->createObject(arena);
+  m_message = dispatcher->getMessage(m_object);
+}
+
+v_buff_size MessageParser::scanVarint(const v_char8* data, v_buff_size size, v_uint64& value) {
+  value = 0;
+  for(v_buff_size i = 0; i < size && i < 10; i ++) {
+    value |= (v_uint64) (data[i] & 0x7F) << (7 * i);
+    if((data[i] & 0x80) == 0) {
+      return i + 1;
+    }
+  }
+  return 0;
+}
+
+v_buff_size MessageParser::scanRecord(const v_char8* data, v_buff_size size) {
+
+  v_uint64 tag;
+  v_buff_size tagSize = scanVarint(data, size, tag);
+  if(tagSize == 0 || (tag >> 3) == 0) {
+    return 0;
+  }
+
+  data += tagSize;
+  size -= tagSize;
+
+  switch(tag & 7) {
+
+    case 0: { // varint
+      v_uint64 value;
+      v_buff_size valueSize = scanVarint(data, size, value);
+      return valueSize > 0 ? tagSize + valueSize : 0;
+    }
+
+    case 1: // fixed64
+      return size >= 8 ? tagSize + 8 : 0;
+
+    case 5: // fixed32
+      return size >= 4 ? tagSize + 4 : 0;
+
+    case 2: { // length-delimited
+      v_uint64 length;
+      v_buff_size lengthSize = scanVarint(data, size, length);
+      if(lengthSize == 0 || length > (v_uint64) (size - lengthSize)) {
+        return 0;
+      }
+      return tagSize + lengthSize + (v_buff_size) length;
+    }
+
+    default:
+      return 0; // groups and malformed records are handled byte by byte
+
+  }
+
+}
+
+void MessageParser::setError(const char* message) {
+  m_errorMessage = message;
+  m_state = STATE_ERROR;
+  m_record.clear();
+  m_stack.clear();
+}
+
+reflection::Message* MessageParser::getCurrentMessage() const {
+  return m_stack.empty() ? m_message : m_stack.back().message;
+}
+
+void MessageParser::merge(const v_char8* data, v_buff_size size) {
+  if(size > std::numeric_limits<int>::max()) {
+    setError("[oatpp::protobuf::io::MessageParser::merge()]: Error. Record is too large.");
+    return;
+  }
+  google::protobuf::io::CodedInputStream input(data, (int) size);
+  if(!getCurrentMessage()->MergePartialFromCodedStream(&input) || !input.ConsumedEntireMessage()) {
+    setError("[oatpp::protobuf::io::MessageParser::merge()]: Error. Can't parse proto message.");
+  }
+}
+
+void MessageParser::mergeRecord() {
+  merge((const v_char8*) m_record.data(), m_record.size());
+  m_record.clear();
+  if(m_state != STATE_ERROR) {
+    m_state = STATE_TAG;
+  }
+}
+
+void MessageParser::mergeBytes() {
+
+  if(m_field->type() == reflection::FieldDescriptor::TYPE_STRING &&
+     m_field->file()->syntax() == google::protobuf::FileDescriptor::SYNTAX_PROTO3 &&
+     !google::protobuf::internal::IsStructurallyValidUTF8(m_record.data(), (int) m_record.size()))
+  {
+    setError("[oatpp::protobuf::io::MessageParser::mergeBytes()]: Error. String field contains invalid UTF-8.");
+    return;
+  }
+
+  reflection::Message* message = getCurrentMessage();
+  const reflection::Reflection* refl = message->GetReflection();
+  if(m_field->is_repeated()) {
+    refl->AddString(message, m_field, std::move(m_record));
+  } else {
+    refl->SetString(message, m_field, std::move(m_record));
+  }
+
+  m_record.clear();
+  m_state = STATE_TAG;
+
+}
+
+void MessageParser::onLength(v_uint64 bytesLeft) {
+
+  scanVarint((const v_char8*) m_record.data() + m_varintStart, m_record.size() - m_varintStart, m_remaining);
+
+  if(m_remaining > (v_uint64) std::numeric_limits<int>::max()) {
+    setError("[oatpp::protobuf::io::MessageParser::write()]: Error. Record is too large.");
+    return;
+  }
+
+  if(m_remaining > bytesLeft) {
+    setError("[oatpp::protobuf::io::MessageParser::write()]: Error. Record exceeds the enclosing message.");
+    return;
+  }
+
+  reflection::Message* message = getCurrentMessage();
+  const reflection::FieldDescriptor* field = message->GetDescriptor()->FindFieldByNumber((int) (m_tag >> 3));
+
+  if(field != nullptr && field->type() == reflection::FieldDescriptor::TYPE_MESSAGE && !field->is_map() &&
+     m_stack.size() < MAX_DEPTH)
+  {
+    /* descend - records of the nested message are merged into it as they arrive */
+    const reflection::Reflection* refl = message->GetReflection();
+    reflection::Message* nested = field->is_repeated() ? refl->AddMessage(message, field) : refl->MutableMessage(message, field);
+    m_stack.push_back({nested, m_offset + m_remaining});
+    m_record.clear();
+    m_state = STATE_TAG;
+    return;
+  }
+
+  if(field != nullptr && m_remaining > 0 &&
+     (field->type() == reflection::FieldDescriptor::TYPE_BYTES || field->type() == reflection::FieldDescriptor::TYPE_STRING))
+  {
+    /* accumulate the value only - it's moved into the field once complete */
+    m_field = field;
+    m_record.clear();
+    m_state = STATE_BYTES;
+    return;
+  }
+
+  if(m_remaining == 0) {
+    mergeRecord();
+  } else {
+    m_state = STATE_PAYLOAD;
+  }
+
+}
+
+v_io_size MessageParser::write(const void* data, v_buff_size count, async::Action& action) {
+
+  (void) action;
+
+  auto bytes = (const v_char8*) data;
+  v_buff_size pos = 0;
+
+  while(pos < count) {
+
+    /* data available to the current message - records must not cross the end of the nested message */
+    v_buff_size available = count - pos;
+    v_uint64 frameLeft = std::numeric_limits<v_uint64>::max();
+
+    if(!m_stack.empty()) {
+      frameLeft = m_stack.back().end - m_offset;
+      if(frameLeft == 0) {
+        if(m_state != STATE_TAG || !m_record.empty()) {
+          setError("[oatpp::protobuf::io::MessageParser::write()]: Error. Record exceeds the enclosing message.");
+        } else {
+          m_stack.pop_back();
+        }
+        continue;
+      }
+      if(frameLeft < (v_uint64) available) {
+        available = (v_buff_size) frameLeft;
+      }
+    }
+
+    switch(m_state) {
+
+      case STATE_TAG: {
+
+        if(m_record.empty()) {
+          /* merge all complete records of the chunk at once - directly from the chunk memory */
+          v_buff_size size = 0;
+          v_buff_size recordSize;
+          while((recordSize = scanRecord(bytes + pos + size, available - size)) > 0) {
+            size += recordSize;
+          }
+          if(size > 0) {
+            merge(bytes + pos, size);
+            pos += size;
+            m_offset += size;
+            continue;
+          }
+        }
+
+        v_char8 b = bytes[pos ++];
+        m_offset ++;
+        m_record.push_back((char) b);
+
+        if(b & 0x80) {
+          if(m_record.size() >= 5) {
+            setError("[oatpp::protobuf::io::MessageParser::write()]: Error. Invalid field tag.");
+          }
+          break;
+        }
+
+        scanVarint((const v_char8*) m_record.data(), m_record.size(), m_tag);
+        m_varintStart = m_record.size();
+
+        if((m_tag >> 3) == 0) {
+          setError("[oatpp::protobuf::io::MessageParser::write()]: Error. Invalid field tag.");
+          break;
+        }
+
+        switch(m_tag & 7) {
+          case 0: m_state = STATE_VARINT; break;
+          case 1: m_state = STATE_PAYLOAD; m_remaining = 8; break;
+          case 2: m_state = STATE_LENGTH; break;
+          case 3:
+            /* group - record boundary is unknown. Buffer the rest of the nested message, or the rest of data */
+            if(m_stack.empty()) {
+              m_state = STATE_BUFFER;
+            } else {
+              m_state = STATE_PAYLOAD;
+              m_remaining = frameLeft - 1;
+              if(m_remaining == 0) {
+                mergeRecord();
+              }
+            }
+            break;
+          case 5: m_state = STATE_PAYLOAD; m_remaining = 4; break;
+          default:
+            setError("[oatpp::protobuf::io::MessageParser::write()]: Error. Invalid wire type.");
+        }
+
+        break;
+
+      }
+
+      case STATE_VARINT:
+      case STATE_LENGTH: {
+
+        v_char8 b = bytes[pos ++];
+        m_offset ++;
+        m_record.push_back((char) b);
+
+        if(b & 0x80) {
+          if(m_record.size() - m_varintStart >= 10) {
+            setError("[oatpp::protobuf::io::MessageParser::write()]: Error. Invalid varint.");
+          }
+          break;
+        }
+
+        if(m_state == STATE_VARINT) {
+          mergeRecord();
+        } else {
+          onLength(frameLeft - 1);
+        }
+
+        break;
+
+      }
+
+      case STATE_PAYLOAD:
+      case STATE_BYTES: {
+        v_buff_size size = available;
+        if((v_uint64) size > m_remaining) {
+          size = (v_buff_size) m_remaining;
+        }
+        m_record.append((const char*) bytes + pos, size);
+        pos += size;
+        m_offset += size;
+        m_remaining -= size;
+        if(m_remaining == 0) {
+          if(m_state == STATE_BYTES) {
+            mergeBytes();
+          } else {
+            mergeRecord();
+          }
+        }
+        break;
+      }
+
+      case STATE_BUFFER:
+        m_record.append((const char*) bytes + pos, count - pos);
+        m_offset += count - pos;
+        pos = count;
+        break;
+
+      case STATE_ERROR:
+        pos = count;
+        break;
+
+    }
+
+  }
+
+  return count;
+
+}
+
+bool MessageParser::finish() {
+
+  if(m_state == STATE_BUFFER) {
+    mergeRecord();
+  }
+
+  if(m_state == STATE_ERROR) {
+    return false;
+  }
+
+  while(m_state == STATE_TAG && m_record.empty() && !m_stack.empty() && m_stack.back().end == m_offset) {
+    m_stack.pop_back();
+  }
+
+  if(m_state != STATE_TAG || !m_record.empty() || !m_stack.empty()) {
+    setError("[oatpp::protobuf::io::MessageParser::finish()]: Error. Unexpected end of data.");
+    return false;
+  }
+
+  if(!m_message->IsInitialized()) {
+    setError("[oatpp::protobuf::io::MessageParser::finish()]: Error. Message is missing required fields.");
+    return false;
+  }
+
+  return true;
+
+}
+
+const char* MessageParser::getErrorMessage() const {
+  return m_errorMessage;
+}
+
+oatpp::Void MessageParser::getObject() const {
+  return m_object;
+}
+
+}}}
@@ -0,0 +1,139 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#ifndef oatpp_protobuf_io_MessageParser_hpp
+#define oatpp_protobuf_io_MessageParser_hpp
+
+#include "oatpp-protobuf/Object.hpp"
+
+#include "oatpp/core/data/stream/Stream.hpp"
+
+#include <vector>
+
+namespace oatpp { namespace protobuf { namespace io {
+
+/**
+ * Incremental (push) parser of protobuf wire format. <br>
+ * Data is written to the parser in chunks of any size as it arrives - ex.: via `IncomingRequest::transferBodyAsync()`. <br>
+ * The parser splits the data into field records and merges complete records into the message right away.
+ * Records which are complete within the chunk are merged directly from the chunk memory. <br>
+ * A nested message record which is split between chunks is not buffered - the parser descends into the nested message
+ * and merges its records as they arrive. A `bytes` (or `string`) record which is split between chunks is accumulated
+ * and moved into the field without a second copy. Other split records (packed repeated scalars, map entries, unknown fields)
+ * are buffered whole. So at most one leaf record is buffered at a time - never the whole body. <br>
+ * Merging the records one by one gives the same result as parsing the whole body at once (protobuf merge semantics). <br>
+ * Parsing errors don't fail the write - the rest of data is consumed and the error is reported by &l:MessageParser::finish ();.
+ */
+class MessageParser : public oatpp::data::stream::WriteCallback {
+  friend class MessageStreamParser;
+private:
+
+  enum State : v_int32 {
+    STATE_TAG,
+    STATE_VARINT,
+    STATE_LENGTH,
+    STATE_PAYLOAD,
+    STATE_BYTES,
+    STATE_BUFFER,
+    STATE_ERROR
+  };
+
+  /*
+   * Nested message being parsed. `end` - offset in the data where its records end.
+   */
+  struct Frame {
+    reflection::Message* message;
+    v_uint64 end;
+  };
+
+  /*
+   * Max depth of nested messages the parser descends into - same as the default recursion limit of libprotobuf.
+   */
+  static constexpr v_uint32 MAX_DEPTH = 100;
+
+private:
+  static v_buff_size scanVarint(const v_char8* data, v_buff_size size, v_uint64& value);
+  static v_buff_size scanRecord(const v_char8* data, v_buff_size size);
+private:
+  void setError(const char* message);
+  reflection::Message* getCurrentMessage() const;
+  void merge(const v_char8* data, v_buff_size size);
+  void mergeRecord();
+  void mergeBytes();
+  void onLength(v_uint64 bytesLeft);
+private:
+  oatpp::Void m_object;
+  reflection::Message* m_message;
+  State m_state;
+  std::string m_record;
+  v_buff_size m_varintStart;
+  v_uint64 m_tag;
+  v_uint64 m_remaining;
+  v_uint64 m_offset;
+  const reflection::FieldDescriptor* m_field;
+  std::vector<Frame> m_stack;
+  const char* m_errorMessage;
+public:
+
+  /**
+   * Constructor.
+   * @param type - type of &id:oatpp::protobuf::Object; to parse.
+   * @param arena - if not `nullptr` - the object is created on this arena.
+   * @throws - `std::runtime_error` if type is not a proto object type.
+   */
+  MessageParser(const oatpp::Type* type, const std::shared_ptr<google::protobuf::Arena>& arena = nullptr);
+
+  /**
+   * Parse next chunk of data.
+   * @param data
+   * @param count
+   * @param action - not used. Parser never blocks.
+   * @return - always `count`.
+   */
+  v_io_size write(const void* data, v_buff_size count, async::Action& action) override;
+
+  /**
+   * Finish parsing. Call it when all data is written.
+   * @return - `true` if the message was parsed successfully.
+   */
+  bool finish();
+
+  /**
+   * Get error message.
+   * @return - error message or `nullptr` if there was no error.
+   */
+  const char* getErrorMessage() const;
+
+  /**
+   * Get parsed object.
+   * @return - &id:oatpp::protobuf::Object;.
+   */
+  oatpp::Void getObject() const;
+
+};
+
+}}}
+
+#endif // oatpp_protobuf_io_MessageParser_hpp
@@ -0,0 +1,323 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#include "MessageStream.hpp"
+
+#include <google/protobuf/io/coded_stream.h>
+
+#include <cstring>
+#include <limits>
+
+namespace oatpp { namespace protobuf { namespace io {
+
+namespace {
+
+const __class::AbstractObject::PolymorphicDispatcher* getDispatcher(const oatpp::Type* type, const char* className) {
+  if(type->classId.id != __class::AbstractObject::CLASS_ID.id) {
+    throw std::runtime_error(std::string("[oatpp::protobuf::io::") + className + "::" + className + "()]: "
+                             "Error. Unsupported type '" + type->classId.name + "'. Only oatpp::protobuf::Object<T> is supported.");
+  }
+  return static_cast<const __class::AbstractObject::PolymorphicDispatcher*>(type->polymorphicDispatcher);
+}
+
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// MessageStreamParser
+
+MessageStreamParser::MessageStreamParser(const oatpp::Type* type, const std::shared_ptr<Listener>& listener)
+  : m_dispatcher(getDispatcher(type, "MessageStreamParser"))
+  , m_listener(listener)
+  , m_state(STATE_LENGTH)
+  , m_stalled(false)
+  , m_remaining(0)
+  , m_messagesCount(0)
+  , m_errorMessage(nullptr)
+{}
+
+void MessageStreamParser::setError(const char* message) {
+  m_errorMessage = message;
+  m_state = STATE_ERROR;
+  m_record.clear();
+  m_pending.clear();
+}
+
+async::Action MessageStreamParser::parseMessage(const v_char8* data, v_buff_size size) {
+
+  if(size > std::numeric_limits<int>::max()) {
+    setError("[oatpp::protobuf::io::MessageStreamParser::parseMessage()]: Error. Message is too large.");
+    return async::Action();
+  }
+
+  auto object = m_dispatcher->createObject();
+  auto message = m_dispatcher->getMessage(object);
+
+  google::protobuf::io::CodedInputStream input(data, (int) size);
+  if(!message->MergePartialFromCodedStream(&input) || !input.ConsumedEntireMessage()) {
+    setError("[oatpp::protobuf::io::MessageStreamParser::parseMessage()]: Error. Can't parse proto message.");
+    return async::Action();
+  }
+
+  if(!message->IsInitialized()) {
+    setError("[oatpp::protobuf::io::MessageStreamParser::parseMessage()]: Error. Message is missing required fields.");
+    return async::Action();
+  }
+
+  m_messagesCount ++;
+  return m_listener->onMessage(object);
+
+}
+
+void MessageStreamParser::parse(const v_char8* bytes, v_buff_size count, async::Action& action) {
+
+  v_buff_size pos = 0;
+
+  while(pos < count) {
+
+    switch(m_state) {
+
+      case STATE_LENGTH: {
+
+        if(m_record.empty()) {
+          /* message is complete within the chunk - parse it directly from the chunk memory */
+          v_uint64 length;
+          v_buff_size lengthSize = MessageParser::scanVarint(bytes + pos, count - pos, length);
+          if(lengthSize > 0 && length <= (v_uint64) (count - pos - lengthSize)) {
+            const v_char8* payload = bytes + pos + lengthSize;
+            pos += lengthSize + (v_buff_size) length;
+            action = parseMessage(payload, (v_buff_size) length);
+            break;
+          }
+        }
+
+        v_char8 b = bytes[pos ++];
+        m_record.push_back((char) b);
+
+        if(b & 0x80) {
+          if(m_record.size() >= 10) {
+            setError("[oatpp::protobuf::io::MessageStreamParser::write()]: Error. Invalid message size.");
+          }
+          break;
+        }
+
+        MessageParser::scanVarint((const v_char8*) m_record.data(), m_record.size(), m_remaining);
+        m_record.clear();
+
+        if(m_remaining > (v_uint64) std::numeric_limits<int>::max()) {
+          setError("[oatpp::protobuf::io::MessageStreamParser::write()]: Error. Message is too large.");
+        } else if(m_remaining == 0) {
+          action = parseMessage(nullptr, 0);
+        } else {
+          m_state = STATE_PAYLOAD;
+        }
+
+        break;
+
+      }
+
+      case STATE_PAYLOAD: {
+
+        v_buff_size size = count - pos;
+        if((v_uint64) size > m_remaining) {
+          size = (v_buff_size) m_remaining;
+        }
+        m_record.append((const char*) bytes + pos, size);
+        pos += size;
+        m_remaining -= size;
+
+        if(m_remaining == 0) {
+          m_state = STATE_LENGTH;
+          action = parseMessage((const v_char8*) m_record.data(), m_record.size());
+          m_record.clear();
+        }
+
+        break;
+
+      }
+
+      case STATE_ERROR:
+        pos = count;
+        break;
+
+    }
+
+    if(!action.isNone()) {
+      /* backpressure - keep the rest of the chunk until the action is done */
+      m_pending.assign((const char*) bytes + pos, count - pos);
+      m_stalled = true;
+      return;
+    }
+
+  }
+
+}
+
+void MessageStreamParser::parsePending(async::Action& action) {
+  std::string pending;
+  pending.swap(m_pending);
+  parse((const v_char8*) pending.data(), pending.size(), action);
+}
+
+v_io_size MessageStreamParser::write(const void* data, v_buff_size count, async::Action& action) {
+
+  if(m_stalled) {
+    /* the chunk was accepted along with the previous action and is written again - parse the data kept from it */
+    m_stalled = false;
+    parsePending(action);
+    return count;
+  }
+
+  parse((const v_char8*) data, count, action);
+  return count;
+
+}
+
+bool MessageStreamParser::finish() {
+
+  while(m_stalled) {
+    m_stalled = false;
+    async::Action action;
+    parsePending(action);
+  }
+
+  if(m_state == STATE_ERROR) {
+    return false;
+  }
+
+  if(m_state != STATE_LENGTH || !m_record.empty()) {
+    setError("[oatpp::protobuf::io::MessageStreamParser::finish()]: Error. Unexpected end of data.");
+    return false;
+  }
+
+  return true;
+
+}
+
+const char* MessageStreamParser::getErrorMessage() const {
+  return m_errorMessage;
+}
+
+v_int64 MessageStreamParser::getMessagesCount() const {
+  return m_messagesCount;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// MessageStreamSerializer
+
+constexpr v_buff_size MessageStreamSerializer::DEFAULT_CHUNK_SIZE;
+
+MessageStreamSerializer::MessageStreamSerializer(const oatpp::Type* type,
+                                                 const std::shared_ptr<Provider>& provider,
+                                                 v_buff_size chunkSize)
+  : m_dispatcher(getDispatcher(type, "MessageStreamSerializer"))
+  , m_provider(provider)
+  , m_chunkSize(chunkSize > 0 ? chunkSize : DEFAULT_CHUNK_SIZE)
+  , m_buffer(m_chunkSize + 256)
+  , m_position(0)
+  , m_messagesCount(0)
+  , m_finished(false)
+{}
+
+std::shared_ptr<MessageStreamSerializer> MessageStreamSerializer::createShared(const oatpp::Type* type,
+                                                                               const std::shared_ptr<Provider>& provider,
+                                                                               v_buff_size chunkSize)
+{
+  return std::make_shared<MessageStreamSerializer>(type, provider, chunkSize);
+}
+
+void MessageStreamSerializer::serializeMessage(const oatpp::Void& object) {
+
+  auto message = m_dispatcher->getMessage(object);
+  auto size = message->ByteSizeLong();
+  if(size > (size_t) std::numeric_limits<int>::max()) {
+    throw std::runtime_error("[oatpp::protobuf::io::MessageStreamSerializer::serializeMessage()]: Error. Message is too large.");
+  }
+
+  /* varint size prefix - 5 bytes max */
+  m_buffer.reserveBytesUpfront(5 + (v_buff_size) size);
+
+  auto start = m_buffer.getData() + m_buffer.getCurrentPosition();
+  auto end = google::protobuf::io::CodedOutputStream::WriteVarint32ToArray((uint32_t) size, start);
+  end = message->SerializeWithCachedSizesToArray(end);
+
+  m_buffer.setCurrentPosition(m_buffer.getCurrentPosition() + (end - start));
+  m_messagesCount ++;
+
+}
+
+v_io_size MessageStreamSerializer::read(void *buffer, v_buff_size count, async::Action& action) {
+
+  if(m_position == m_buffer.getCurrentPosition()) {
+
+    m_buffer.setCurrentPosition(0);
+    m_position = 0;
+
+    if(!m_pendingAction.isNone()) {
+      action = std::move(m_pendingAction);
+      return oatpp::IOError::RETRY_READ;
+    }
+
+    while(!m_finished && m_buffer.getCurrentPosition() < m_chunkSize) {
+
+      async::Action providerAction;
+      auto object = m_provider->getNext(providerAction);
+
+      if(!providerAction.isNone()) {
+        if(m_buffer.getCurrentPosition() == 0) {
+          action = std::move(providerAction);
+          return oatpp::IOError::RETRY_READ;
+        }
+        /* return the data first - wait for the provider on the next read */
+        m_pendingAction = std::move(providerAction);
+        break;
+      }
+
+      if(!object) {
+        m_finished = true;
+        break;
+      }
+
+      serializeMessage(object);
+
+    }
+
+  }
+
+  v_buff_size available = m_buffer.getCurrentPosition() - m_position;
+  v_buff_size size = count < available ? count : available;
+  if(size > 0) {
+    std::memcpy(buffer, m_buffer.getData() + m_position, size);
+    m_position += size;
+  }
+
+  return size;
+
+}
+
+v_int64 MessageStreamSerializer::getMessagesCount() const {
+  return m_messagesCount;
+}
+
+}}}
@@ -0,0 +1,230 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+
+#ifndef oatpp_protobuf_io_MessageStream_hpp
+#define oatpp_protobuf_io_MessageStream_hpp
+
+#include "MessageParser.hpp"
+
+#include "oatpp/core/data/stream/BufferStream.hpp"
+
+namespace oatpp { namespace protobuf { namespace io {
+
+/**
+ * Incremental (push) parser of a stream of varint length-delimited proto messages of one type. <br>
+ * Same framing as `google::protobuf::util::ParseDelimitedFromZeroCopyStream()` - each message is preceded by its size. <br>
+ * Data is written to the parser in chunks of any size as it arrives - ex.: via `IncomingRequest::transferBodyAsync()`.
+ * Each message is parsed as soon as it's complete and passed to &l:MessageStreamParser::Listener;.
+ * Messages which are complete within the chunk are parsed directly from the chunk memory -
+ * only the message which is split between chunks is buffered. <br>
+ * Parsing errors don't fail the write - the rest of data is consumed and the error is reported by &l:MessageStreamParser::finish ();.
+ */
+class MessageStreamParser : public oatpp::data::stream::WriteCallback {
+public:
+
+  /**
+   * Listener of parsed messages.
+   */
+  class Listener {
+  public:
+
+    /**
+     * Default virtual destructor.
+     */
+    virtual ~Listener() = default;
+
+    /**
+     * Called for each parsed message.
+     * @param object - &id:oatpp::protobuf::Object;.
+     * @return - action to wait for before the rest of data is parsed (backpressure in Async API).
+     * Data following the message is kept by the parser and is parsed on the next write, once the action is done. <br>
+     * Must be `none` (default-constructed `async::Action`) in Simple API - the listener is free to block instead.
+     */
+    virtual async::Action onMessage(const oatpp::Void& object) = 0;
+
+  };
+
+private:
+
+  enum State : v_int32 {
+    STATE_LENGTH,
+    STATE_PAYLOAD,
+    STATE_ERROR
+  };
+
+private:
+  void setError(const char* message);
+  async::Action parseMessage(const v_char8* data, v_buff_size size);
+  void parse(const v_char8* data, v_buff_size count, async::Action& action);
+  void parsePending(async::Action& action);
+private:
+  const __class::AbstractObject::PolymorphicDispatcher* m_dispatcher;
+  std::shared_ptr<Listener> m_listener;
+  State m_state;
+  std::string m_record;
+  /* data of the accepted chunk which follows the message the listener returned an action for */
+  std::string m_pending;
+  /* the listener returned an action - the next write repeats the accepted chunk */
+  bool m_stalled;
+  v_uint64 m_remaining;
+  v_int64 m_messagesCount;
+  const char* m_errorMessage;
+public:
+
+  /**
+   * Constructor.
+   * @param type - type of &id:oatpp::protobuf::Object; to parse.
+   * @param listener - &l:MessageStreamParser::Listener;.
+   * @throws - `std::runtime_error` if type is not a proto object type.
+   */
+  MessageStreamParser(const oatpp::Type* type, const std::shared_ptr<Listener>& listener);
+
+  /**
+   * Parse next chunk of data. <br>
+   * The chunk is always accepted as a whole. If the listener returns an action, the rest of the chunk is kept
+   * by the parser and the action is returned to the caller. Once the action is done, the caller writes
+   * the same chunk again - the way `WriteCallback::writeExactSizeDataAsyncInline()` does. The repeated data is ignored
+   * and the kept data is parsed instead.
+   * @param data
+   * @param count
+   * @param action - set to the action returned by the listener, if any.
+   * @return - `count`.
+   */
+  v_io_size write(const void* data, v_buff_size count, async::Action& action) override;
+
+  /**
+   * Finish parsing. Call it when all data is written. <br>
+   * Data kept after the last action is parsed first - actions returned by the listener at this point are not waited for.
+   * @return - `true` if the data ended on a message boundary and all messages were parsed successfully.
+   */
+  bool finish();
+
+  /**
+   * Get error message.
+   * @return - error message or `nullptr` if there was no error.
+   */
+  const char* getErrorMessage() const;
+
+  /**
+   * Get number of messages passed to the listener so far.
+   * @return
+   */
+  v_int64 getMessagesCount() const;
+
+};
+
+/**
+ * Incremental serializer of a stream of varint length-delimited proto messages in the form of `oatpp::data::stream::ReadCallback`. <br>
+ * Messages are pulled from &l:MessageStreamSerializer::Provider; as the callback is read and serialized
+ * in chunks of about `chunkSize` bytes - only one chunk is kept in memory. <br>
+ * Use it as a response body - `oatpp::web::protocol::http::outgoing::StreamingBody`, in both Simple and Async APIs.
+ */
+class MessageStreamSerializer : public oatpp::data::stream::ReadCallback {
+public:
+
+  /**
+   * Default chunk size.
+   */
+  static constexpr v_buff_size DEFAULT_CHUNK_SIZE = 4096;
+
+public:
+
+  /**
+   * Provider of messages.
+   */
+  class Provider {
+  public:
+
+    /**
+     * Default virtual destructor.
+     */
+    virtual ~Provider() = default;
+
+    /**
+     * Get next message.
+     * @param action - set it if the next message is not ready yet (backpressure in Async API) and return `nullptr`.
+     * The provider is called again once the action is done. Never set it in Simple API - the provider is free to block instead.
+     * @return - &id:oatpp::protobuf::Object;. `nullptr` (with action not set) - end of stream.
+     */
+    virtual oatpp::Void getNext(async::Action& action) = 0;
+
+  };
+
+private:
+  void serializeMessage(const oatpp::Void& object);
+private:
+  const __class::AbstractObject::PolymorphicDispatcher* m_dispatcher;
+  std::shared_ptr<Provider> m_provider;
+  v_buff_size m_chunkSize;
+  oatpp::data::stream::BufferOutputStream m_buffer;
+  v_buff_size m_position;
+  async::Action m_pendingAction;
+  v_int64 m_messagesCount;
+  bool m_finished;
+public:
+
+  /**
+   * Constructor.
+   * @param type - type of &id:oatpp::protobuf::Object; provided.
+   * @param provider - &l:MessageStreamSerializer::Provider;.
+   * @param chunkSize - approximate size of data chunk serialized at once.
+   * @throws - `std::runtime_error` if type is not a proto object type.
+   */
+  MessageStreamSerializer(const oatpp::Type* type,
+                          const std::shared_ptr<Provider>& provider,
+                          v_buff_size chunkSize = DEFAULT_CHUNK_SIZE);
+
+  /**
+   * Create shared MessageStreamSerializer.
+   * @param type - type of &id:oatpp::protobuf::Object; provided.
+   * @param provider - &l:MessageStreamSerializer::Provider;.
+   * @param chunkSize - approximate size of data chunk serialized at once.
+   * @return - `std::shared_ptr` to MessageStreamSerializer.
+   */
+  static std::shared_ptr<MessageStreamSerializer> createShared(const oatpp::Type* type,
+                                                               const std::shared_ptr<Provider>& provider,
+                                                               v_buff_size chunkSize = DEFAULT_CHUNK_SIZE);
+
+  /**
+   * Read next portion of data.
+   * @param buffer - buffer to read to.
+   * @param count - buffer size.
+   * @param action - set to the action of the provider if no data is ready yet.
+   * @return - number of bytes read. `0` - end of stream. `oatpp::IOError::RETRY_READ` - if action is set.
+   */
+  v_io_size read(void *buffer, v_buff_size count, async::Action& action) override;
+
+  /**
+   * Get number of messages serialized so far.
+   * @return
+   */
+  v_int64 getMessagesCount() const;
+
+};
+
+}}}
+
+#endif // oatpp_protobuf_io_MessageStream_hpp
@@ -0,0 +1,144 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#include "ZeroCopyStream.hpp"
+
+#include <limits>
+
+namespace oatpp { namespace protobuf { namespace io {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// BufferOutputStreamAdapter
+
+BufferOutputStreamAdapter::BufferOutputStreamAdapter(oatpp::data::stream::BufferOutputStream* stream, v_buff_size chunkSize)
+  : m_stream(stream)
+  , m_chunkSize(chunkSize > 0 ? chunkSize : DEFAULT_CHUNK_SIZE)
+  , m_byteCount(0)
+{}
+
+bool BufferOutputStreamAdapter::Next(void** data, int* size) {
+
+  m_stream->reserveBytesUpfront(m_chunkSize);
+
+  v_buff_size position = m_stream->getCurrentPosition();
+  v_buff_size available = m_stream->getCapacity() - position;
+  if(available > std::numeric_limits<int>::max()) {
+    available = std::numeric_limits<int>::max();
+  }
+
+  *data = m_stream->getData() + position;
+  *size = (int) available;
+
+  m_stream->setCurrentPosition(position + available);
+  m_byteCount += available;
+
+  return true;
+
+}
+
+void BufferOutputStreamAdapter::BackUp(int count) {
+  m_stream->setCurrentPosition(m_stream->getCurrentPosition() - count);
+  m_byteCount -= count;
+}
+
+int64_t BufferOutputStreamAdapter::ByteCount() const {
+  return m_byteCount;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// OutputStreamAdapter
+
+OutputStreamAdapter::OutputStreamAdapter(oatpp::data::stream::WriteCallback* stream)
+  : m_stream(stream)
+{}
+
+bool OutputStreamAdapter::Write(const void* buffer, int size) {
+  return m_stream->writeExactSizeDataSimple(buffer, size) == size;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// BufferInputStreamAdapter
+
+BufferInputStreamAdapter::BufferInputStreamAdapter(oatpp::data::stream::BufferInputStream* stream)
+  : m_stream(stream)
+  , m_byteCount(0)
+{}
+
+bool BufferInputStreamAdapter::Next(const void** data, int* size) {
+
+  v_buff_size position = m_stream->getCurrentPosition();
+  v_buff_size available = m_stream->getDataSize() - position;
+  if(available <= 0) {
+    return false;
+  }
+  if(available > std::numeric_limits<int>::max()) {
+    available = std::numeric_limits<int>::max();
+  }
+
+  *data = m_stream->getData() + position;
+  *size = (int) available;
+
+  m_stream->setCurrentPosition(position + available);
+  m_byteCount += available;
+
+  return true;
+
+}
+
+void BufferInputStreamAdapter::BackUp(int count) {
+  m_stream->setCurrentPosition(m_stream->getCurrentPosition() - count);
+  m_byteCount -= count;
+}
+
+bool BufferInputStreamAdapter::Skip(int count) {
+  v_buff_size position = m_stream->getCurrentPosition();
+  v_buff_size available = m_stream->getDataSize() - position;
+  if(count > available) {
+    m_stream->setCurrentPosition(m_stream->getDataSize());
+    m_byteCount += available;
+    return false;
+  }
+  m_stream->setCurrentPosition(position + count);
+  m_byteCount += count;
+  return true;
+}
+
+int64_t BufferInputStreamAdapter::ByteCount() const {
+  return m_byteCount;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// InputStreamAdapter
+
+InputStreamAdapter::InputStreamAdapter(oatpp::data::stream::ReadCallback* stream)
+  : m_stream(stream)
+{}
+
+int InputStreamAdapter::Read(void* buffer, int size) {
+  auto res = m_stream->readSimple(buffer, size);
+  return res < 0 ? -1 : (int) res;
+}
+
+}}}
@@ -0,0 +1,128 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#ifndef oatpp_protobuf_io_ZeroCopyStream_hpp
+#define oatpp_protobuf_io_ZeroCopyStream_hpp
+
+#include "oatpp/core/data/stream/BufferStream.hpp"
+
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
+
+namespace oatpp { namespace protobuf { namespace io {
+
+/**
+ * `google::protobuf::io::ZeroCopyOutputStream` over &id:oatpp::data::stream::BufferOutputStream;. <br>
+ * libprotobuf writes directly into the memory of the oatpp buffer.
+ */
+class BufferOutputStreamAdapter : public google::protobuf::io::ZeroCopyOutputStream {
+public:
+  /**
+   * Default size of memory reserved upfront by each call to Next().
+   */
+  static constexpr v_buff_size DEFAULT_CHUNK_SIZE = 4096;
+private:
+  oatpp::data::stream::BufferOutputStream* m_stream;
+  v_buff_size m_chunkSize;
+  int64_t m_byteCount;
+public:
+
+  /**
+   * Constructor.
+   * @param stream - &id:oatpp::data::stream::BufferOutputStream;.
+   * @param chunkSize - size of memory reserved upfront by each call to Next(). Set it to the size of serialized message
+   * to have the whole message written in one chunk.
+   */
+  BufferOutputStreamAdapter(oatpp::data::stream::BufferOutputStream* stream, v_buff_size chunkSize = DEFAULT_CHUNK_SIZE);
+
+  bool Next(void** data, int* size) override;
+  void BackUp(int count) override;
+  int64_t ByteCount() const override;
+
+};
+
+/**
+ * `google::protobuf::io::CopyingOutputStream` over &id:oatpp::data::stream::WriteCallback;. <br>
+ * Use with `google::protobuf::io::CopyingOutputStreamAdaptor` for streams which don't expose their memory.
+ */
+class OutputStreamAdapter : public google::protobuf::io::CopyingOutputStream {
+private:
+  oatpp::data::stream::WriteCallback* m_stream;
+public:
+
+  /**
+   * Constructor.
+   * @param stream - &id:oatpp::data::stream::WriteCallback;.
+   */
+  OutputStreamAdapter(oatpp::data::stream::WriteCallback* stream);
+
+  bool Write(const void* buffer, int size) override;
+
+};
+
+/**
+ * `google::protobuf::io::ZeroCopyInputStream` over &id:oatpp::data::stream::BufferInputStream;. <br>
+ * libprotobuf reads directly from the memory of the oatpp buffer. Position of the oatpp stream is advanced as data is consumed.
+ */
+class BufferInputStreamAdapter : public google::protobuf::io::ZeroCopyInputStream {
+private:
+  oatpp::data::stream::BufferInputStream* m_stream;
+  int64_t m_byteCount;
+public:
+
+  /**
+   * Constructor.
+   * @param stream - &id:oatpp::data::stream::BufferInputStream;.
+   */
+  BufferInputStreamAdapter(oatpp::data::stream::BufferInputStream* stream);
+
+  bool Next(const void** data, int* size) override;
+  void BackUp(int count) override;
+  bool Skip(int count) override;
+  int64_t ByteCount() const override;
+
+};
+
+/**
+ * `google::protobuf::io::CopyingInputStream` over &id:oatpp::data::stream::ReadCallback;. <br>
+ * Use with `google::protobuf::io::CopyingInputStreamAdaptor` for streams which don't expose their memory.
+ */
+class InputStreamAdapter : public google::protobuf::io::CopyingInputStream {
+private:
+  oatpp::data::stream::ReadCallback* m_stream;
+public:
+
+  /**
+   * Constructor.
+   * @param stream - &id:oatpp::data::stream::ReadCallback;.
+   */
+  InputStreamAdapter(oatpp::data::stream::ReadCallback* stream);
+
+  int Read(void* buffer, int size) override;
+
+};
+
+}}}
+
+#endif // oatpp_protobuf_io_ZeroCopyStream_hpp
@@ -0,0 +1,629 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#include "Deserializer.hpp"
+
+#include "oatpp-protobuf/reflection/WellKnownTypes.hpp"
+
+namespace oatpp { namespace protobuf { namespace json {
+
+void Deserializer::skipString(parser::Caret& caret) {
+  caret.inc();
+  while(caret.canContinue()) {
+    v_char8 c = *caret.getCurrData();
+    if(c == '\\') {
+      caret.inc(2);
+    } else if(c == '"') {
+      caret.inc();
+      return;
+    } else {
+      caret.inc();
+    }
+  }
+  caret.setError("[oatpp::protobuf::json::Deserializer::skipString()]: Error. '\"' - expected");
+}
+
+void Deserializer::skipScope(parser::Caret& caret) {
+  v_int32 depth = 0;
+  while(caret.canContinue()) {
+    v_char8 c = *caret.getCurrData();
+    if(c == '"') {
+      skipString(caret);
+      continue;
+    }
+    if(c == '{' || c == '[') {
+      depth ++;
+    } else if(c == '}' || c == ']') {
+      depth --;
+    }
+    caret.inc();
+    if(depth == 0) {
+      return;
+    }
+  }
+  caret.setError("[oatpp::protobuf::json::Deserializer::skipScope()]: Error. Unclosed scope");
+}
+
+void Deserializer::skipToken(parser::Caret& caret) {
+  while(caret.canContinue()) {
+    v_char8 c = *caret.getCurrData();
+    if(c == ',' || c == '}' || c == ']' || c == ' ' || c == '\t' || c == '\n' || c == '\r') {
+      return;
+    }
+    caret.inc();
+  }
+}
+
+void Deserializer::skipValue(parser::Caret& caret) {
+  if(caret.isAtChar('"')) {
+    skipString(caret);
+  } else if(caret.isAtChar('{') || caret.isAtChar('[')) {
+    skipScope(caret);
+  } else {
+    skipToken(caret);
+  }
+}
+
+bool Deserializer::parseEnum(parser::Caret& caret, const reflection::EnumTable* table, int& number) {
+
+  if(!caret.isAtChar('"')) {
+    number = (int) caret.parseInt();
+    if(caret.hasError()) {
+      return false;
+    }
+    /* closed enums don't accept unknown values - neither via reflection nor via generated codecs */
+    if(table->isClosed() && table->getIndex(number) < 0) {
+      caret.setError("[oatpp::protobuf::json::Deserializer::parseEnum()]: Error. Unknown enum value.");
+      return false;
+    }
+    return true;
+  }
+
+  /* enum names don't need unescaping - look them up right in the parsed text */
+  const char* begin = (const char*) caret.getCurrData() + 1;
+  const char* end = (const char*) caret.getData() + caret.getDataSize();
+  const char* curr = begin;
+  while(curr < end && *curr != '"' && *curr != '\\') {
+    curr ++;
+  }
+
+  bool found;
+  if(curr < end && *curr == '"') {
+    found = table->resolveNumber(begin, curr - begin, number);
+    caret.inc(curr - begin + 2);
+  } else {
+    auto name = oatpp::parser::json::Utils::parseStringToStdString(caret);
+    if(caret.hasError()) {
+      return false;
+    }
+    found = table->resolveNumber(name.data(), name.size(), number);
+  }
+
+  if(!found) {
+    caret.setError("[oatpp::protobuf::json::Deserializer::parseEnum()]: Error. Unknown enum value.");
+  }
+  return found;
+
+}
+
+void Deserializer::deserializeWellKnown(JsonDeserializer* deserializer, parser::Caret& caret, Message& message,
+                                        reflection::WellKnownType type, reflection::DynamicClass* clazz)
+{
+
+  switch(type) {
+
+    case reflection::WellKnownType::TIMESTAMP:
+    case reflection::WellKnownType::DURATION: {
+
+      if(!caret.isAtChar('"')) {
+        caret.setError("[oatpp::protobuf::json::Deserializer::deserializeWellKnown()]: Error. '\"' - expected");
+        return;
+      }
+
+      /* time strings don't need unescaping - parse them right in the text */
+      const char* begin = (const char*) caret.getCurrData() + 1;
+      const char* end = (const char*) caret.getData() + caret.getDataSize();
+      const char* curr = begin;
+      while(curr < end && *curr != '"' && *curr != '\\') {
+        curr ++;
+      }
+
+      v_int64 seconds;
+      v_int32 nanos;
+      bool valid = curr < end && *curr == '"' && (type == reflection::WellKnownType::TIMESTAMP
+                   ? reflection::WellKnownTypes::parseTimestamp(begin, curr - begin, seconds, nanos)
+                   : reflection::WellKnownTypes::parseDuration(begin, curr - begin, seconds, nanos));
+
+      if(!valid) {
+        caret.setError("[oatpp::protobuf::json::Deserializer::deserializeWellKnown()]: Error. Invalid timestamp or duration.");
+        return;
+      }
+
+      caret.inc(curr - begin + 2);
+      reflection::WellKnownTypes::setTime(&message, seconds, nanos);
+      break;
+
+    }
+
+    case reflection::WellKnownType::FIELD_MASK: {
+      auto mask = oatpp::parser::json::Utils::parseStringToStdString(caret);
+      if(caret.hasError()) return;
+      const Reflection* refl = message.GetReflection();
+      const FieldDescriptor* paths = message.GetDescriptor()->field(0);
+      refl->ClearField(&message, paths);
+      size_t begin = 0;
+      while(begin < mask.size()) {
+        size_t end = mask.find(',', begin);
+        if(end == std::string::npos) {
+          end = mask.size();
+        }
+        if(end > begin) {
+          refl->AddString(&message, paths, mask.substr(begin, end - begin));
+        }
+        begin = end + 1;
+      }
+      break;
+    }
+
+    case reflection::WellKnownType::VALUE: {
+      const auto& fields = clazz->getFields();
+      const reflection::FieldInfo* kind;
+      if(caret.isAtText("null", true)) {
+        message.GetReflection()->SetEnumValue(&message, fields[0].descriptor, 0);
+        break;
+      } else if(caret.isAtChar('"')) {
+        kind = &fields[2]; // string_value
+      } else if(caret.isAtChar('t') || caret.isAtChar('f')) {
+        kind = &fields[3]; // bool_value
+      } else if(caret.isAtChar('{')) {
+        kind = &fields[4]; // struct_value
+      } else if(caret.isAtChar('[')) {
+        kind = &fields[5]; // list_value
+      } else {
+        kind = &fields[1]; // number_value
+      }
+      deserializeValue(deserializer, caret, message, *kind);
+      break;
+    }
+
+    /* Struct and ListValue are read as their only field - map of Values and repeated Value */
+    case reflection::WellKnownType::STRUCT:
+    case reflection::WellKnownType::LIST_VALUE: {
+      deserializeRepeated(deserializer, caret, message, clazz->getFields()[0]);
+      break;
+    }
+
+    case reflection::WellKnownType::ANY: {
+      deserializeAny(deserializer, caret, message);
+      break;
+    }
+
+    /* wrappers are read as their `value` field */
+    default:
+      deserializeValue(deserializer, caret, message, clazz->getFields()[0]);
+
+  }
+
+}
+
+void Deserializer::deserializeAny(JsonDeserializer* deserializer, parser::Caret& caret, Message& message) {
+
+  /* "@type" is needed before the fields - look it up first and come back to the start of the object */
+  auto start = caret.getPosition();
+  std::string typeUrl;
+
+  /* the serializer writes "@type" first - then only the first field is read twice */
+  if(caret.canContinueAtChar('{', 1)) {
+    caret.skipBlankChars();
+    if(caret.isAtText("\"@type\"", true)) {
+      caret.skipBlankChars();
+      if(caret.canContinueAtChar(':', 1)) {
+        caret.skipBlankChars();
+        typeUrl = oatpp::parser::json::Utils::parseStringToStdString(caret);
+      }
+    }
+  }
+
+  if(typeUrl.empty() && !caret.hasError()) {
+    caret.setPosition(start);
+    deserializeFields(deserializer, caret, [&caret, &typeUrl](const std::string& key) -> bool {
+      if(typeUrl.empty() && key == "@type") {
+        typeUrl = oatpp::parser::json::Utils::parseStringToStdString(caret);
+      } else {
+        skipValue(caret);
+      }
+      return true;
+    });
+  }
+
+  if(caret.hasError()) {
+    return;
+  }
+
+  const Reflection* refl = message.GetReflection();
+  const google::protobuf::Descriptor* desc = message.GetDescriptor();
+
+  if(typeUrl.empty()) {
+    /* empty object is an empty Any */
+    refl->ClearField(&message, desc->field(0));
+    refl->ClearField(&message, desc->field(1));
+    return;
+  }
+
+  reflection::DynamicClass* clazz = reflection::DynamicClass::registryGetClassByTypeUrl(typeUrl);
+  if(clazz == nullptr) {
+    caret.setError("[oatpp::protobuf::json::Deserializer::deserializeAny()]: Error. Unknown type in '@type'.");
+    return;
+  }
+
+  caret.setPosition(start);
+
+  auto packed = clazz->createProto();
+  reflection::WellKnownType type = reflection::WellKnownTypes::getType(clazz->getDescriptor());
+
+  if(type != reflection::WellKnownType::NONE) {
+    /* well-known types don't have fields of their own in json - they come in "value" */
+    deserializeFields(deserializer, caret, [deserializer, &caret, &packed, type, clazz](const std::string& key) -> bool {
+      if(key == "value") {
+        if(!caret.isAtText("null", true)) {
+          deserializeWellKnown(deserializer, caret, *packed, type, clazz);
+        }
+      } else if(key == "@type") {
+        skipValue(caret);
+      } else {
+        return false;
+      }
+      return true;
+    });
+  } else {
+    reflection::Statistics::Tracker tracker(clazz->getStatistics(), reflection::Statistics::JSON_TO_PROTO);
+    deserializeFields(deserializer, caret, [deserializer, &caret, &packed, clazz](const std::string& key) -> bool {
+      if(key == "@type") {
+        skipValue(caret);
+        return true;
+      }
+      return deserializeField(deserializer, caret, *packed, clazz, key);
+    });
+  }
+
+  if(caret.hasError()) {
+    return;
+  }
+
+  refl->SetString(&message, desc->field(0), typeUrl);
+  refl->SetString(&message, desc->field(1), packed->SerializeAsString());
+
+}
+
+void Deserializer::deserializeValue(JsonDeserializer* deserializer, parser::Caret& caret,
+                                    Message& message, const reflection::FieldInfo& info, bool merge)
+{
+
+  const Reflection* refl = message.GetReflection();
+  const FieldDescriptor* field = info.descriptor;
+  bool repeated = field->is_repeated();
+
+  switch(field->cpp_type()) {
+
+    case google::protobuf::FieldDescriptor::CPPTYPE_STRING: {
+      auto value = oatpp::parser::json::Utils::parseStringToStdString(caret);
+      if(caret.hasError()) return;
+      reflection::Statistics::onBytesCopied(value.size());
+      repeated ? refl->AddString(&message, field, std::move(value)) : refl->SetString(&message, field, std::move(value));
+      break;
+    }
+
+    case google::protobuf::FieldDescriptor::CPPTYPE_INT32: {
+      auto value = (v_int32) caret.parseInt();
+      repeated ? refl->AddInt32(&message, field, value) : refl->SetInt32(&message, field, value);
+      break;
+    }
+    case google::protobuf::FieldDescriptor::CPPTYPE_UINT32: {
+      auto value = (v_uint32) caret.parseUnsignedInt();
+      repeated ? refl->AddUInt32(&message, field, value) : refl->SetUInt32(&message, field, value);
+      break;
+    }
+    case google::protobuf::FieldDescriptor::CPPTYPE_INT64: {
+      auto value = (v_int64) caret.parseInt();
+      repeated ? refl->AddInt64(&message, field, value) : refl->SetInt64(&message, field, value);
+      break;
+    }
+    case google::protobuf::FieldDescriptor::CPPTYPE_UINT64: {
+      auto value = (v_uint64) caret.parseUnsignedInt();
+      repeated ? refl->AddUInt64(&message, field, value) : refl->SetUInt64(&message, field, value);
+      break;
+    }
+    case google::protobuf::FieldDescriptor::CPPTYPE_FLOAT: {
+      auto value = caret.parseFloat32();
+      repeated ? refl->AddFloat(&message, field, value) : refl->SetFloat(&message, field, value);
+      break;
+    }
+    case google::protobuf::FieldDescriptor::CPPTYPE_DOUBLE: {
+      auto value = caret.parseFloat64();
+      repeated ? refl->AddDouble(&message, field, value) : refl->SetDouble(&message, field, value);
+      break;
+    }
+
+    case google::protobuf::FieldDescriptor::CPPTYPE_BOOL: {
+      bool value;
+      if(caret.isAtText("true", true)) {
+        value = true;
+      } else if(caret.isAtText("false", true)) {
+        value = false;
+      } else {
+        caret.setError("[oatpp::protobuf::json::Deserializer::deserializeValue()]: Error. 'true' or 'false' - expected.");
+        return;
+      }
+      repeated ? refl->AddBool(&message, field, value) : refl->SetBool(&message, field, value);
+      break;
+    }
+
+    case google::protobuf::FieldDescriptor::CPPTYPE_ENUM: {
+      int value;
+      if(!parseEnum(caret, info.enumTable, value)) return;
+      repeated ? refl->AddEnumValue(&message, field, value) : refl->SetEnumValue(&message, field, value);
+      break;
+    }
+
+    case google::protobuf::FieldDescriptor::CPPTYPE_MESSAGE: {
+      Message* nested = repeated ? refl->AddMessage(&message, field) : refl->MutableMessage(&message, field);
+      if(info.wellKnownType != reflection::WellKnownType::NONE) {
+        /* well-known values are replaced as a whole */
+        if(merge) {
+          nested->Clear();
+        }
+        deserializeWellKnown(deserializer, caret, *nested, info.wellKnownType, info.nestedClass);
+      } else {
+        deserializeMessage(deserializer, caret, *nested, info.nestedClass, merge);
+      }
+      break;
+    }
+
+    default:
+      throw std::runtime_error("[oatpp::protobuf::json::Deserializer::deserializeValue()]: "
+                               "Error. Unknown type - " + std::string(field->type_name()));
+
+  }
+
+}
+
+template<>
+v_int32 Deserializer::parseScalar<v_int32>(parser::Caret& caret) {
+  return (v_int32) caret.parseInt();
+}
+
+template<>
+v_uint32 Deserializer::parseScalar<v_uint32>(parser::Caret& caret) {
+  return (v_uint32) caret.parseUnsignedInt();
+}
+
+template<>
+v_int64 Deserializer::parseScalar<v_int64>(parser::Caret& caret) {
+  return (v_int64) caret.parseInt();
+}
+
+template<>
+v_uint64 Deserializer::parseScalar<v_uint64>(parser::Caret& caret) {
+  return (v_uint64) caret.parseUnsignedInt();
+}
+
+template<>
+v_float32 Deserializer::parseScalar<v_float32>(parser::Caret& caret) {
+  return caret.parseFloat32();
+}
+
+template<>
+v_float64 Deserializer::parseScalar<v_float64>(parser::Caret& caret) {
+  return caret.parseFloat64();
+}
+
+template<>
+bool Deserializer::parseScalar<bool>(parser::Caret& caret) {
+  if(caret.isAtText("true", true)) {
+    return true;
+  } else if(caret.isAtText("false", true)) {
+    return false;
+  }
+  caret.setError("[oatpp::protobuf::json::Deserializer::parseScalar()]: Error. 'true' or 'false' - expected.");
+  return false;
+}
+
+void Deserializer::deserializeMap(JsonDeserializer* deserializer, parser::Caret& caret,
+                                  Message& message, const reflection::FieldInfo& info)
+{
+
+  const Reflection* refl = message.GetReflection();
+
+  deserializeFields(deserializer, caret, [deserializer, &caret, &message, &info, refl](const std::string& key) -> bool {
+
+    if(info.mapValue->wellKnownType != reflection::WellKnownType::VALUE && caret.isAtText("null", true)) {
+      /* proto maps can't hold null values - except for google.protobuf.Value which stores null as a value */
+      return true;
+    }
+
+    Message* entry = refl->AddMessage(&message, info.descriptor);
+    if(!reflection::Utils::setMapKey(entry->GetReflection(), entry, info.mapKey, key.data(), key.size())) {
+      caret.setError("[oatpp::protobuf::json::Deserializer::deserializeMap()]: Error. Invalid map key.");
+      return true;
+    }
+
+    deserializeValue(deserializer, caret, *entry, *info.mapValue);
+    return true;
+
+  });
+
+}
+
+void Deserializer::deserializeRepeated(JsonDeserializer* deserializer, parser::Caret& caret,
+                                       Message& message, const reflection::FieldInfo& info)
+{
+
+  const Reflection* refl = message.GetReflection();
+  const FieldDescriptor* field = info.descriptor;
+
+  refl->ClearField(&message, field);
+
+  if(info.mapValue) {
+    deserializeMap(deserializer, caret, message, info);
+    return;
+  }
+
+  switch(field->cpp_type()) {
+
+    case google::protobuf::FieldDescriptor::CPPTYPE_INT32:
+      return deserializeScalars(caret, reflection::Utils::mutableRepeatedScalars<v_int32>(refl, &message, field));
+    case google::protobuf::FieldDescriptor::CPPTYPE_UINT32:
+      return deserializeScalars(caret, reflection::Utils::mutableRepeatedScalars<v_uint32>(refl, &message, field));
+    case google::protobuf::FieldDescriptor::CPPTYPE_INT64:
+      return deserializeScalars(caret, reflection::Utils::mutableRepeatedScalars<v_int64>(refl, &message, field));
+    case google::protobuf::FieldDescriptor::CPPTYPE_UINT64:
+      return deserializeScalars(caret, reflection::Utils::mutableRepeatedScalars<v_uint64>(refl, &message, field));
+    case google::protobuf::FieldDescriptor::CPPTYPE_FLOAT:
+      return deserializeScalars(caret, reflection::Utils::mutableRepeatedScalars<v_float32>(refl, &message, field));
+    case google::protobuf::FieldDescriptor::CPPTYPE_DOUBLE:
+      return deserializeScalars(caret, reflection::Utils::mutableRepeatedScalars<v_float64>(refl, &message, field));
+    case google::protobuf::FieldDescriptor::CPPTYPE_BOOL:
+      return deserializeScalars(caret, reflection::Utils::mutableRepeatedScalars<bool>(refl, &message, field));
+
+    default:
+      deserializeItems(caret, [deserializer, &caret, &message, &info] {
+        deserializeValue(deserializer, caret, message, info);
+      }, info.wellKnownType != reflection::WellKnownType::VALUE);
+
+  }
+
+}
+
+bool Deserializer::deserializeField(JsonDeserializer* deserializer, parser::Caret& caret, Message& message,
+                                    reflection::DynamicClass* clazz, const std::string& key, bool merge)
+{
+
+  const FieldDescriptor* field = clazz->getDescriptor()->FindFieldByName(key);
+
+  if(field == nullptr) {
+    return false;
+  }
+
+  reflection::Statistics::onFieldsVisited(1);
+
+  if(caret.isAtText("null", true)) {
+    /* null leaves the field untouched - or clears it when merging */
+    if(merge) {
+      message.GetReflection()->ClearField(&message, field);
+    }
+  } else if(field->is_repeated()) {
+    deserializeRepeated(deserializer, caret, message, clazz->getFields()[field->index()]);
+  } else {
+    deserializeValue(deserializer, caret, message, clazz->getFields()[field->index()], merge);
+  }
+
+  return true;
+
+}
+
+void Deserializer::deserializeMessage(JsonDeserializer* deserializer, parser::Caret& caret,
+                                      Message& message, reflection::DynamicClass* clazz, bool merge)
+{
+
+  reflection::Statistics::Tracker tracker(clazz->getStatistics(), reflection::Statistics::JSON_TO_PROTO);
+
+  deserializeFields(deserializer, caret, [deserializer, &caret, &message, clazz, merge](const std::string& key) -> bool {
+    return deserializeField(deserializer, caret, message, clazz, key, merge);
+  });
+
+}
+
+void Deserializer::deserializeMessage(JsonDeserializer* deserializer,
+                                      parser::Caret& caret,
+                                      Message& message,
+                                      reflection::DynamicClass* clazz)
+{
+  deserializeMessage(deserializer, caret, message, clazz, false);
+}
+
+void Deserializer::mergeMessage(JsonDeserializer* deserializer,
+                                parser::Caret& caret,
+                                Message& message,
+                                reflection::DynamicClass* clazz)
+{
+  deserializeMessage(deserializer, caret, message, clazz, true);
+}
+
+void Deserializer::merge(JsonDeserializer* deserializer,
+                         parser::Caret& caret,
+                         const oatpp::Void& polymorph)
+{
+
+  if(!polymorph) {
+    throw std::runtime_error("[oatpp::protobuf::json::Deserializer::merge()]: Error. Object is null.");
+  }
+
+  if(caret.isAtText("null", true)) {
+    return;
+  }
+
+  auto dispatcher = static_cast<const __class::AbstractObject::PolymorphicDispatcher*>(polymorph.valueType->polymorphicDispatcher);
+  deserializeMessage(deserializer, caret, *dispatcher->getMessage(polymorph), dispatcher->getDynamicClass(), true);
+
+}
+
+oatpp::Void Deserializer::deserialize(JsonDeserializer* deserializer,
+                                      parser::Caret& caret,
+                                      const oatpp::Type* const type)
+{
+
+  if(caret.isAtText("null", true)) {
+    return oatpp::Void(type);
+  }
+
+  std::shared_ptr<google::protobuf::Arena> arena;
+  auto config = dynamic_cast<Config*>(deserializer->getConfig().get());
+  if(config && config->useArena) {
+    arena = std::make_shared<google::protobuf::Arena>();
+  }
+
+  auto dispatcher = static_cast<const __class::AbstractObject::PolymorphicDispatcher*>(type->polymorphicDispatcher);
+  auto object = dispatcher->createObject(arena);
+  auto codec = dispatcher->getCodec();
+  if(codec) {
+    /* generated codecs account each message (nested ones too) to its own class */
+    codec->readJson(deserializer, caret, *dispatcher->getMessage(object));
+  } else {
+    deserializeMessage(deserializer, caret, *dispatcher->getMessage(object), dispatcher->getDynamicClass());
+  }
+
+  if(caret.hasError()) {
+    return oatpp::Void(type);
+  }
+
+  return object;
+
+}
+
+void Deserializer::enable(JsonDeserializer* deserializer) {
+  deserializer->setDeserializerMethod(__class::AbstractObject::CLASS_ID, &Deserializer::deserialize);
+}
+
+}}}
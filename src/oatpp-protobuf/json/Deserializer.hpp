@@ -0,0 +1,299 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#ifndef oatpp_protobuf_json_Deserializer_hpp
+#define oatpp_protobuf_json_Deserializer_hpp
+
+#include "oatpp-protobuf/Object.hpp"
+
+#include "oatpp/parser/json/mapping/Deserializer.hpp"
+#include "oatpp/parser/json/Utils.hpp"
+
+namespace oatpp { namespace protobuf { namespace json {
+
+/**
+ * Direct json-to-proto deserializer. <br>
+ * Reads json from the parsing caret and writes values straight into the proto object
+ * via `google::protobuf::Reflection` without building &id:oatpp::protobuf::reflection::DynamicObject; tree.
+ */
+class Deserializer {
+  template<class T>
+  friend class codec::Codec;
+public:
+  typedef oatpp::parser::json::mapping::Deserializer JsonDeserializer;
+  typedef reflection::Message Message;
+  typedef reflection::Reflection Reflection;
+  typedef reflection::FieldDescriptor FieldDescriptor;
+public:
+
+  /**
+   * Deserializer config. <br>
+   * Extends &id:oatpp::parser::json::mapping::Deserializer::Config; -
+   * pass it to the oatpp json deserializer (object mapper) in place of the default config.
+   */
+  class Config : public JsonDeserializer::Config {
+  public:
+
+    /**
+     * Create shared config.
+     * @return - `std::shared_ptr` to Config.
+     */
+    static std::shared_ptr<Config> createShared() {
+      return std::make_shared<Config>();
+    }
+
+    /**
+     * Create proto objects on `google::protobuf::Arena`. <br>
+     * Each top-level proto object gets its own arena which holds all of its nested messages and strings.
+     * The arena lives as long as the object.
+     */
+    bool useArena = false;
+
+  };
+
+private:
+  static void skipString(parser::Caret& caret);
+  static void skipScope(parser::Caret& caret);
+  static void skipToken(parser::Caret& caret);
+  static void skipValue(parser::Caret& caret);
+private:
+
+  /*
+   * Walk json object. `readField(key)` reads the value of a known field (or skips `null`) and returns `true`,
+   * or returns `false` for an unknown field without touching the caret.
+   */
+  template<class FieldReader>
+  static void deserializeFields(JsonDeserializer* deserializer, parser::Caret& caret, const FieldReader& readField) {
+
+    if(!caret.canContinueAtChar('{', 1)) {
+      caret.setError("[oatpp::protobuf::json::Deserializer::deserializeFields()]: Error. '{' - expected");
+      return;
+    }
+
+    caret.skipBlankChars();
+    while (!caret.isAtChar('}') && caret.canContinue()) {
+
+      caret.skipBlankChars();
+      auto key = oatpp::parser::json::Utils::parseStringToStdString(caret);
+      if(caret.hasError()) {
+        return;
+      }
+
+      caret.skipBlankChars();
+      if(!caret.canContinueAtChar(':', 1)) {
+        caret.setError("[oatpp::protobuf::json::Deserializer::deserializeFields()]: Error. ':' - expected");
+        return;
+      }
+      caret.skipBlankChars();
+
+      if(!readField(key)) {
+        if(!deserializer->getConfig()->allowUnknownFields) {
+          caret.setError("[oatpp::protobuf::json::Deserializer::deserializeFields()]: Error. Unknown field");
+          return;
+        }
+        skipValue(caret);
+      }
+
+      if(caret.hasError()) {
+        return;
+      }
+
+      caret.skipBlankChars();
+      if(!caret.isAtChar('}')) {
+        if(!caret.canContinueAtChar(',', 1)) {
+          if(!caret.canContinue()) {
+            return;
+          }
+          caret.setError("[oatpp::protobuf::json::Deserializer::deserializeFields()]: Error. ',' - expected");
+          return;
+        }
+      }
+
+    }
+
+    if(!caret.canContinueAtChar('}', 1)) {
+      if(!caret.hasError()) {
+        caret.setError("[oatpp::protobuf::json::Deserializer::deserializeFields()]: Error. '}' - expected");
+      }
+    }
+
+  }
+
+  /*
+   * Walk json array. `readItem()` is called for each item - nulls are skipped unless `skipNulls` is `false`.
+   */
+  template<class ItemReader>
+  static void deserializeItems(parser::Caret& caret, const ItemReader& readItem, bool skipNulls = true) {
+
+    if(!caret.canContinueAtChar('[', 1)) {
+      caret.setError("[oatpp::protobuf::json::Deserializer::deserializeItems()]: Error. '[' - expected");
+      return;
+    }
+
+    caret.skipBlankChars();
+    while(!caret.isAtChar(']') && caret.canContinue()) {
+
+      caret.skipBlankChars();
+      if(!skipNulls || !caret.isAtText("null", true)) {
+        readItem();
+        if(caret.hasError()) {
+          return;
+        }
+      }
+
+      caret.skipBlankChars();
+      caret.canContinueAtChar(',', 1);
+
+    }
+
+    if(!caret.canContinueAtChar(']', 1)) {
+      if(!caret.hasError()) {
+        caret.setError("[oatpp::protobuf::json::Deserializer::deserializeItems()]: Error. ']' - expected");
+      }
+    }
+
+  }
+
+  static bool parseEnum(parser::Caret& caret, const reflection::EnumTable* table, int& number);
+  template<typename T>
+  static T parseScalar(parser::Caret& caret);
+  template<typename T>
+  static void deserializeScalars(parser::Caret& caret, google::protobuf::RepeatedField<T>* values) {
+    deserializeItems(caret, [&caret, values] {
+      T value = parseScalar<T>(caret);
+      if(!caret.hasError()) {
+        values->Add(value);
+      }
+    });
+  }
+
+  static void deserializeWellKnown(JsonDeserializer* deserializer, parser::Caret& caret, Message& message,
+                                   reflection::WellKnownType type, reflection::DynamicClass* clazz);
+  static void deserializeAny(JsonDeserializer* deserializer, parser::Caret& caret, Message& message);
+  static bool deserializeField(JsonDeserializer* deserializer, parser::Caret& caret, Message& message,
+                               reflection::DynamicClass* clazz, const std::string& key, bool merge = false);
+  static void deserializeValue(JsonDeserializer* deserializer, parser::Caret& caret,
+                               Message& message, const reflection::FieldInfo& info, bool merge = false);
+  static void deserializeMap(JsonDeserializer* deserializer, parser::Caret& caret,
+                             Message& message, const reflection::FieldInfo& info);
+  static void deserializeRepeated(JsonDeserializer* deserializer, parser::Caret& caret,
+                                  Message& message, const reflection::FieldInfo& info);
+  static void deserializeMessage(JsonDeserializer* deserializer, parser::Caret& caret,
+                                 Message& message, reflection::DynamicClass* clazz, bool merge);
+public:
+
+  /**
+   * Deserialize json object into the proto message. <br>
+   * Fields present in json are set in the message, other fields are left untouched. <br>
+   * Errors are reported via the caret.
+   * @param deserializer - oatpp json deserializer. Its config is respected.
+   * @param caret - parsing caret.
+   * @param message - proto message.
+   * @param clazz - &id:oatpp::protobuf::reflection::DynamicClass; of the message.
+   */
+  static void deserializeMessage(JsonDeserializer* deserializer,
+                                 parser::Caret& caret,
+                                 Message& message,
+                                 reflection::DynamicClass* clazz);
+
+  /**
+   * Merge json object into the existing proto message - proto field-level merge: <br>
+   * <ul>
+   *   <li>Fields absent in json are left untouched.</li>
+   *   <li>Nested messages present in json are merged in place - recursively.</li>
+   *   <li>Repeated and map fields, and well-known type values (including `google.protobuf.Struct`) present in json
+   *   replace the existing values as a whole - map entries are not merged key by key.</li>
+   *   <li>`null` clears the field.</li>
+   * </ul>
+   * Note: unlike JSON merge patch (RFC 7386), json objects of map and `Struct` values are not merged per key.
+   * Generated codecs are not used - the message is updated via reflection. <br>
+   * Errors are reported via the caret. On error the message may be updated partially - merge into a copy
+   * if the update must be atomic.
+   * @param deserializer - oatpp json deserializer. Its config is respected.
+   * @param caret - parsing caret.
+   * @param message - proto message.
+   * @param clazz - &id:oatpp::protobuf::reflection::DynamicClass; of the message.
+   */
+  static void mergeMessage(JsonDeserializer* deserializer,
+                           parser::Caret& caret,
+                           Message& message,
+                           reflection::DynamicClass* clazz);
+
+  /**
+   * Merge json object into the existing &id:oatpp::protobuf::Object;. See &l:Deserializer::mergeMessage ();. <br>
+   * `null` json leaves the object untouched.
+   * @param deserializer - oatpp json deserializer.
+   * @param caret - parsing caret.
+   * @param polymorph - &id:oatpp::protobuf::Object;. Must not be `nullptr`.
+   */
+  static void merge(JsonDeserializer* deserializer,
+                    parser::Caret& caret,
+                    const oatpp::Void& polymorph);
+
+  /**
+   * Deserializer method for &id:oatpp::protobuf::Object;. <br>
+   * Matches &id:oatpp::parser::json::mapping::Deserializer::DeserializerMethod;.
+   * @param deserializer
+   * @param caret
+   * @param type
+   * @return
+   */
+  static oatpp::Void deserialize(JsonDeserializer* deserializer,
+                                 parser::Caret& caret,
+                                 const oatpp::Type* const type);
+
+  /**
+   * Register deserializer method for &id:oatpp::protobuf::Object; in the oatpp json deserializer. <br>
+   * Once registered, proto objects are deserialized directly and the `"protobuf"` interpretation is not used.
+   * @param deserializer
+   */
+  static void enable(JsonDeserializer* deserializer);
+
+};
+
+template<>
+v_int32 Deserializer::parseScalar<v_int32>(parser::Caret& caret);
+
+template<>
+v_uint32 Deserializer::parseScalar<v_uint32>(parser::Caret& caret);
+
+template<>
+v_int64 Deserializer::parseScalar<v_int64>(parser::Caret& caret);
+
+template<>
+v_uint64 Deserializer::parseScalar<v_uint64>(parser::Caret& caret);
+
+template<>
+v_float32 Deserializer::parseScalar<v_float32>(parser::Caret& caret);
+
+template<>
+v_float64 Deserializer::parseScalar<v_float64>(parser::Caret& caret);
+
+template<>
+bool Deserializer::parseScalar<bool>(parser::Caret& caret);
+
+}}}
+
+#endif // oatpp_protobuf_json_Deserializer_hpp
@@ -0,0 +1,540 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#include "Serializer.hpp"
+
+#include "oatpp-protobuf/reflection/WellKnownTypes.hpp"
+
+#include "oatpp/parser/json/Utils.hpp"
+
+namespace oatpp { namespace protobuf { namespace json {
+
+Serializer::Options Serializer::getOptions(JsonSerializer* serializer) {
+  Options options;
+  options.includeNullFields = serializer->getConfig()->includeNullFields;
+  auto config = dynamic_cast<Config*>(serializer->getConfig().get());
+  options.enumsAsInt = config && config->enumsAsInt;
+  DefaultValues defaultValues = config ? config->defaultValues : DefaultValues::AS_NULL;
+  options.omitDefaults = defaultValues == DefaultValues::OMIT;
+  options.emitDefaults = defaultValues == DefaultValues::EMIT;
+  options.nullDefaults = defaultValues == DefaultValues::AS_NULL && options.includeNullFields;
+  return options;
+}
+
+void Serializer::serializeString(ConsistentOutputStream* stream, const char* data, v_buff_size size) {
+
+  for(v_buff_size i = 0; i < size; i ++) {
+    v_char8 c = data[i];
+    if(c < 32 || c > 126 || c == '"' || c == '\\' || c == '/') {
+      /* fall back to the oatpp escaping so that the output is exactly the same */
+      reflection::Statistics::onStringAllocated();
+      auto escaped = oatpp::parser::json::Utils::escapeString(data, size);
+      stream->writeCharSimple('"');
+      stream->writeSimple(escaped->getData(), escaped->getSize());
+      stream->writeCharSimple('"');
+      return;
+    }
+  }
+
+  stream->writeCharSimple('"');
+  stream->writeSimple(data, size);
+  stream->writeCharSimple('"');
+
+}
+
+void Serializer::serializeEnum(const Options& options, ConsistentOutputStream* stream,
+                               const reflection::EnumTable* table, int number)
+{
+
+  if(options.enumsAsInt) {
+    stream->writeAsString(number);
+    return;
+  }
+
+  v_int32 index = table->getIndex(number);
+  if(index < 0) {
+    /* unknown value of an open enum */
+    stream->writeCharSimple('"');
+    stream->writeAsString(number);
+    stream->writeCharSimple('"');
+    return;
+  }
+
+  const auto& name = table->getName(index);
+  stream->writeCharSimple('"');
+  stream->writeSimple(name.data(), name.size());
+  stream->writeCharSimple('"');
+
+}
+
+void Serializer::serializeWellKnown(const Options& options, ConsistentOutputStream* stream, const Message& message,
+                                    reflection::WellKnownType type, reflection::DynamicClass* clazz)
+{
+
+  switch(type) {
+
+    case reflection::WellKnownType::TIMESTAMP:
+    case reflection::WellKnownType::DURATION: {
+      v_int64 seconds;
+      v_int32 nanos;
+      reflection::WellKnownTypes::getTime(message, seconds, nanos);
+      char buffer[reflection::WellKnownTypes::TIME_BUFFER_SIZE];
+      v_buff_size size = type == reflection::WellKnownType::TIMESTAMP
+                         ? reflection::WellKnownTypes::formatTimestamp(seconds, nanos, buffer)
+                         : reflection::WellKnownTypes::formatDuration(seconds, nanos, buffer);
+      if(size < 0) {
+        throw std::runtime_error("[oatpp::protobuf::json::Serializer::serializeWellKnown()]: "
+                                 "Error. Value of '" + message.GetDescriptor()->full_name() + "' is out of range.");
+      }
+      stream->writeCharSimple('"');
+      stream->writeSimple(buffer, size);
+      stream->writeCharSimple('"');
+      break;
+    }
+
+    case reflection::WellKnownType::FIELD_MASK: {
+      const Reflection* refl = message.GetReflection();
+      const FieldDescriptor* paths = message.GetDescriptor()->field(0);
+      std::string mask;
+      int size = refl->FieldSize(message, paths);
+      for(int i = 0; i < size; i ++) {
+        if(i > 0) {
+          mask.push_back(',');
+        }
+        std::string scratch;
+        mask.append(refl->GetRepeatedStringReference(message, paths, i, &scratch));
+      }
+      serializeString(stream, mask.data(), mask.size());
+      break;
+    }
+
+    case reflection::WellKnownType::VALUE: {
+      const Reflection* refl = message.GetReflection();
+      const FieldDescriptor* kind = refl->GetOneofFieldDescriptor(message, message.GetDescriptor()->oneof_decl(0));
+      if(kind == nullptr || kind->cpp_type() == google::protobuf::FieldDescriptor::CPPTYPE_ENUM) {
+        stream->writeSimple("null", 4);
+      } else {
+        serializeValue(options, stream, message, clazz->getFields()[kind->index()]);
+      }
+      break;
+    }
+
+    /* Struct and ListValue are written as their only field - map of Values and repeated Value */
+    case reflection::WellKnownType::STRUCT:
+    case reflection::WellKnownType::LIST_VALUE: {
+      serializeRepeated(options, stream, message, clazz->getFields()[0]);
+      break;
+    }
+
+    case reflection::WellKnownType::ANY: {
+      serializeAny(options, stream, message);
+      break;
+    }
+
+    /* wrappers are written as their `value` field */
+    default:
+      serializeValue(options, stream, message, clazz->getFields()[0]);
+
+  }
+
+}
+
+void Serializer::serializeAny(const Options& options, ConsistentOutputStream* stream, const Message& message) {
+
+  const Reflection* refl = message.GetReflection();
+  const google::protobuf::Descriptor* desc = message.GetDescriptor();
+
+  std::string urlScratch;
+  const auto& typeUrl = refl->GetStringReference(message, desc->field(0), &urlScratch);
+  if(typeUrl.empty()) {
+    stream->writeSimple("{}", 2);
+    return;
+  }
+
+  reflection::DynamicClass* clazz = reflection::DynamicClass::registryGetClassByTypeUrl(typeUrl);
+  if(clazz == nullptr) {
+    throw std::runtime_error("[oatpp::protobuf::json::Serializer::serializeAny()]: "
+                             "Error. Unknown type '" + typeUrl + "'.");
+  }
+
+  std::string valueScratch;
+  const auto& value = refl->GetStringReference(message, desc->field(1), &valueScratch);
+  auto packed = clazz->createProto();
+  if(!packed->ParseFromString(value)) {
+    throw std::runtime_error("[oatpp::protobuf::json::Serializer::serializeAny()]: "
+                             "Error. Can't unpack '" + typeUrl + "'.");
+  }
+
+  stream->writeSimple("{\"@type\":", 9);
+  serializeString(stream, typeUrl.data(), typeUrl.size());
+
+  /* well-known types don't have fields of their own in json - they go to "value" */
+  reflection::WellKnownType type = reflection::WellKnownTypes::getType(clazz->getDescriptor());
+  if(type != reflection::WellKnownType::NONE) {
+    stream->writeSimple(",\"value\":", 9);
+    serializeWellKnown(options, stream, *packed, type, clazz);
+  } else {
+    reflection::Statistics::Tracker tracker(clazz->getStatistics(), reflection::Statistics::PROTO_TO_JSON);
+    serializeFields(options, stream, *packed, clazz, false);
+  }
+
+  stream->writeCharSimple('}');
+
+}
+
+void Serializer::serializeValue(const Options& options, ConsistentOutputStream* stream,
+                                const Message& message, const reflection::FieldInfo& info,
+                                const reflection::FieldMask* mask)
+{
+
+  const Reflection* refl = message.GetReflection();
+  const FieldDescriptor* field = info.descriptor;
+
+  switch(field->cpp_type()) {
+
+    case google::protobuf::FieldDescriptor::CPPTYPE_STRING: {
+      std::string scratch;
+      const auto& str = refl->GetStringReference(message, field, &scratch);
+      serializeString(stream, str.data(), str.size());
+      break;
+    }
+
+    case google::protobuf::FieldDescriptor::CPPTYPE_INT32: stream->writeAsString(refl->GetInt32(message, field)); break;
+    case google::protobuf::FieldDescriptor::CPPTYPE_UINT32: stream->writeAsString(refl->GetUInt32(message, field)); break;
+    case google::protobuf::FieldDescriptor::CPPTYPE_INT64: stream->writeAsString(refl->GetInt64(message, field)); break;
+    case google::protobuf::FieldDescriptor::CPPTYPE_UINT64: stream->writeAsString(refl->GetUInt64(message, field)); break;
+    case google::protobuf::FieldDescriptor::CPPTYPE_FLOAT: stream->writeAsString(refl->GetFloat(message, field)); break;
+    case google::protobuf::FieldDescriptor::CPPTYPE_DOUBLE: stream->writeAsString(refl->GetDouble(message, field)); break;
+    case google::protobuf::FieldDescriptor::CPPTYPE_BOOL: stream->writeAsString(refl->GetBool(message, field)); break;
+
+    case google::protobuf::FieldDescriptor::CPPTYPE_ENUM: serializeEnum(options, stream, info.enumTable, refl->GetEnumValue(message, field)); break;
+
+    case google::protobuf::FieldDescriptor::CPPTYPE_MESSAGE: {
+      const Message& nested = refl->GetMessage(message, field);
+      if(info.wellKnownType != reflection::WellKnownType::NONE) {
+        serializeWellKnown(options, stream, nested, info.wellKnownType, info.nestedClass);
+      } else {
+        serializeMessage(options, stream, nested, info.nestedClass, mask);
+      }
+      break;
+    }
+
+    default:
+      throw std::runtime_error("[oatpp::protobuf::json::Serializer::serializeValue()]: "
+                               "Error. Unknown type - " + std::string(field->type_name()));
+
+  }
+
+}
+
+void Serializer::serializeRepeatedValue(const Options& options, ConsistentOutputStream* stream,
+                                        const Message& message, const reflection::FieldInfo& info, int index,
+                                        const reflection::FieldMask* mask)
+{
+
+  const Reflection* refl = message.GetReflection();
+  const FieldDescriptor* field = info.descriptor;
+
+  switch(field->cpp_type()) {
+
+    case google::protobuf::FieldDescriptor::CPPTYPE_STRING: {
+      std::string scratch;
+      const auto& str = refl->GetRepeatedStringReference(message, field, index, &scratch);
+      serializeString(stream, str.data(), str.size());
+      break;
+    }
+
+    case google::protobuf::FieldDescriptor::CPPTYPE_INT32: stream->writeAsString(refl->GetRepeatedInt32(message, field, index)); break;
+    case google::protobuf::FieldDescriptor::CPPTYPE_UINT32: stream->writeAsString(refl->GetRepeatedUInt32(message, field, index)); break;
+    case google::protobuf::FieldDescriptor::CPPTYPE_INT64: stream->writeAsString(refl->GetRepeatedInt64(message, field, index)); break;
+    case google::protobuf::FieldDescriptor::CPPTYPE_UINT64: stream->writeAsString(refl->GetRepeatedUInt64(message, field, index)); break;
+    case google::protobuf::FieldDescriptor::CPPTYPE_FLOAT: stream->writeAsString(refl->GetRepeatedFloat(message, field, index)); break;
+    case google::protobuf::FieldDescriptor::CPPTYPE_DOUBLE: stream->writeAsString(refl->GetRepeatedDouble(message, field, index)); break;
+    case google::protobuf::FieldDescriptor::CPPTYPE_BOOL: stream->writeAsString(refl->GetRepeatedBool(message, field, index)); break;
+
+    case google::protobuf::FieldDescriptor::CPPTYPE_ENUM: serializeEnum(options, stream, info.enumTable, refl->GetRepeatedEnumValue(message, field, index)); break;
+
+    case google::protobuf::FieldDescriptor::CPPTYPE_MESSAGE: {
+      const Message& nested = refl->GetRepeatedMessage(message, field, index);
+      if(info.wellKnownType != reflection::WellKnownType::NONE) {
+        serializeWellKnown(options, stream, nested, info.wellKnownType, info.nestedClass);
+      } else {
+        serializeMessage(options, stream, nested, info.nestedClass, mask);
+      }
+      break;
+    }
+
+    default:
+      throw std::runtime_error("[oatpp::protobuf::json::Serializer::serializeRepeatedValue()]: "
+                               "Error. Unknown type - " + std::string(field->type_name()));
+
+  }
+
+}
+
+void Serializer::serializeMapKey(ConsistentOutputStream* stream, const Message& entry, const FieldDescriptor* keyField) {
+
+  const Reflection* refl = entry.GetReflection();
+
+  if(keyField->cpp_type() == google::protobuf::FieldDescriptor::CPPTYPE_STRING) {
+    std::string scratch;
+    const auto& str = refl->GetStringReference(entry, keyField, &scratch);
+    serializeString(stream, str.data(), str.size());
+    return;
+  }
+
+  stream->writeCharSimple('"');
+  switch(keyField->cpp_type()) {
+    case google::protobuf::FieldDescriptor::CPPTYPE_INT32: stream->writeAsString(refl->GetInt32(entry, keyField)); break;
+    case google::protobuf::FieldDescriptor::CPPTYPE_UINT32: stream->writeAsString(refl->GetUInt32(entry, keyField)); break;
+    case google::protobuf::FieldDescriptor::CPPTYPE_INT64: stream->writeAsString(refl->GetInt64(entry, keyField)); break;
+    case google::protobuf::FieldDescriptor::CPPTYPE_UINT64: stream->writeAsString(refl->GetUInt64(entry, keyField)); break;
+    case google::protobuf::FieldDescriptor::CPPTYPE_BOOL: stream->writeAsString(refl->GetBool(entry, keyField)); break;
+    default:
+      throw std::runtime_error("[oatpp::protobuf::json::Serializer::serializeMapKey()]: "
+                               "Error. Invalid map key type - " + std::string(keyField->type_name()));
+  }
+  stream->writeCharSimple('"');
+
+}
+
+void Serializer::serializeMap(const Options& options, ConsistentOutputStream* stream,
+                              const Message& message, const reflection::FieldInfo& info,
+                              const reflection::FieldMask* mask)
+{
+
+  const Reflection* refl = message.GetReflection();
+  int size = refl->FieldSize(message, info.descriptor);
+
+  stream->writeCharSimple('{');
+  for(int i = 0; i < size; i ++) {
+    if(i > 0) {
+      stream->writeCharSimple(',');
+    }
+    const Message& entry = refl->GetRepeatedMessage(message, info.descriptor, i);
+    serializeMapKey(stream, entry, info.mapKey);
+    stream->writeCharSimple(':');
+    serializeValue(options, stream, entry, *info.mapValue, mask);
+  }
+  stream->writeCharSimple('}');
+
+}
+
+void Serializer::serializeRepeated(const Options& options, ConsistentOutputStream* stream,
+                                   const Message& message, const reflection::FieldInfo& info,
+                                   const reflection::FieldMask* mask)
+{
+
+  if(info.mapValue) {
+    serializeMap(options, stream, message, info, mask);
+    return;
+  }
+
+  const Reflection* refl = message.GetReflection();
+  const FieldDescriptor* field = info.descriptor;
+
+  switch(field->cpp_type()) {
+    case google::protobuf::FieldDescriptor::CPPTYPE_INT32:
+      return serializeScalars(stream, reflection::Utils::getRepeatedScalars<v_int32>(refl, message, field));
+    case google::protobuf::FieldDescriptor::CPPTYPE_UINT32:
+      return serializeScalars(stream, reflection::Utils::getRepeatedScalars<v_uint32>(refl, message, field));
+    case google::protobuf::FieldDescriptor::CPPTYPE_INT64:
+      return serializeScalars(stream, reflection::Utils::getRepeatedScalars<v_int64>(refl, message, field));
+    case google::protobuf::FieldDescriptor::CPPTYPE_UINT64:
+      return serializeScalars(stream, reflection::Utils::getRepeatedScalars<v_uint64>(refl, message, field));
+    case google::protobuf::FieldDescriptor::CPPTYPE_FLOAT:
+      return serializeScalars(stream, reflection::Utils::getRepeatedScalars<v_float32>(refl, message, field));
+    case google::protobuf::FieldDescriptor::CPPTYPE_DOUBLE:
+      return serializeScalars(stream, reflection::Utils::getRepeatedScalars<v_float64>(refl, message, field));
+    case google::protobuf::FieldDescriptor::CPPTYPE_BOOL:
+      return serializeScalars(stream, reflection::Utils::getRepeatedScalars<bool>(refl, message, field));
+    default: break;
+  }
+
+  int size = refl->FieldSize(message, field);
+  stream->writeCharSimple('[');
+  for(int i = 0; i < size; i ++) {
+    if(i > 0) {
+      stream->writeCharSimple(',');
+    }
+    serializeRepeatedValue(options, stream, message, info, i, mask);
+  }
+  stream->writeCharSimple(']');
+
+}
+
+bool Serializer::serializeFieldKey(const Options& options, ConsistentOutputStream* stream,
+                                   const Message& message, const reflection::FieldInfo& info,
+                                   bool& first, bool& isNull)
+{
+
+  const Reflection* refl = message.GetReflection();
+  const FieldDescriptor* field = info.descriptor;
+  isNull = false;
+
+  if(field->is_repeated()) {
+    if(options.omitDefaults && refl->FieldSize(message, field) == 0) {
+      return false;
+    }
+  } else if(!refl->HasField(message, field)) {
+    if(info.hasPresence) {
+      isNull = true;
+      if(!options.includeNullFields) {
+        return false;
+      }
+    } else if(options.nullDefaults) {
+      isNull = true;
+    } else if(!options.emitDefaults) {
+      return false;
+    }
+  }
+
+  (first) ? first = false : stream->writeCharSimple(',');
+  const auto& name = field->name();
+  serializeString(stream, name.data(), name.size());
+  stream->writeCharSimple(':');
+
+  return true;
+
+}
+
+void Serializer::serializeField(const Options& options, ConsistentOutputStream* stream,
+                                const Message& message, const reflection::FieldInfo& info,
+                                const reflection::FieldMask* mask, bool& first)
+{
+
+  bool isNull;
+  if(!serializeFieldKey(options, stream, message, info, first, isNull)) {
+    return;
+  }
+
+  if(isNull) {
+    stream->writeSimple("null", 4);
+  } else if(info.descriptor->is_repeated()) {
+    serializeRepeated(options, stream, message, info, mask);
+  } else {
+    serializeValue(options, stream, message, info, mask);
+  }
+
+}
+
+void Serializer::serializeFields(const Options& options, ConsistentOutputStream* stream,
+                                 const Message& message, reflection::DynamicClass* clazz, bool first,
+                                 const reflection::FieldMask* mask)
+{
+
+  const auto& fields = clazz->getFields();
+
+  if(mask != nullptr && !mask->isAll()) {
+    const auto& selection = mask->select(clazz->getDescriptor());
+    reflection::Statistics::onFieldsVisited(selection.size());
+    for(const auto& selected : selection) {
+      serializeField(options, stream, message, fields[selected.index], selected.mask, first);
+    }
+    return;
+  }
+
+  reflection::Statistics::onFieldsVisited(fields.size());
+  for(const auto& info : fields) {
+    serializeField(options, stream, message, info, nullptr, first);
+  }
+
+}
+
+void Serializer::serializeMessage(const Options& options, ConsistentOutputStream* stream,
+                                  const Message& message, reflection::DynamicClass* clazz,
+                                  const reflection::FieldMask* mask)
+{
+  reflection::Statistics::Tracker tracker(clazz->getStatistics(), reflection::Statistics::PROTO_TO_JSON);
+  stream->writeCharSimple('{');
+  serializeFields(options, stream, message, clazz, true, mask);
+  stream->writeCharSimple('}');
+}
+
+void Serializer::serializeMessage(JsonSerializer* serializer,
+                                  ConsistentOutputStream* stream,
+                                  const Message& message,
+                                  reflection::DynamicClass* clazz)
+{
+  serializeMessage(getOptions(serializer), stream, message, clazz);
+}
+
+void Serializer::serializeObject(JsonSerializer* serializer,
+                                 ConsistentOutputStream* stream,
+                                 const oatpp::Void& polymorph,
+                                 const reflection::FieldMask* mask)
+{
+
+  if(!polymorph) {
+    stream->writeSimple("null", 4);
+    return;
+  }
+
+  auto dispatcher = static_cast<const __class::AbstractObject::PolymorphicDispatcher*>(polymorph.valueType->polymorphicDispatcher);
+  if(mask != nullptr && !mask->isAll()) {
+    serializeMessage(getOptions(serializer), stream, *dispatcher->getMessage(polymorph), dispatcher->getDynamicClass(), mask);
+    return;
+  }
+
+  auto codec = dispatcher->getCodec();
+  if(codec) {
+    /* generated codecs account each message (nested ones too) to its own class */
+    codec->writeJson(serializer, stream, *dispatcher->getMessage(polymorph));
+    return;
+  }
+  serializeMessage(getOptions(serializer), stream, *dispatcher->getMessage(polymorph), dispatcher->getDynamicClass());
+
+}
+
+void Serializer::serialize(JsonSerializer* serializer,
+                           ConsistentOutputStream* stream,
+                           const oatpp::Void& polymorph)
+{
+  auto config = dynamic_cast<Config*>(serializer->getConfig().get());
+  serializeObject(serializer, stream, polymorph, config ? config->fieldMask.get() : nullptr);
+}
+
+void Serializer::serializeMessage(JsonSerializer* serializer,
+                                  ConsistentOutputStream* stream,
+                                  const Message& message,
+                                  reflection::DynamicClass* clazz,
+                                  const reflection::FieldMask* mask)
+{
+  serializeMessage(getOptions(serializer), stream, message, clazz, mask);
+}
+
+void Serializer::serialize(JsonSerializer* serializer,
+                           ConsistentOutputStream* stream,
+                           const oatpp::Void& polymorph,
+                           const reflection::FieldMask& mask)
+{
+  serializeObject(serializer, stream, polymorph, &mask);
+}
+
+void Serializer::enable(JsonSerializer* serializer) {
+  serializer->setSerializerMethod(__class::AbstractObject::CLASS_ID, &Serializer::serialize);
+}
+
+}}}
@@ -0,0 +1,259 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#ifndef oatpp_protobuf_json_Serializer_hpp
+#define oatpp_protobuf_json_Serializer_hpp
+
+#include "oatpp-protobuf/Object.hpp"
+
+#include "oatpp/parser/json/mapping/Serializer.hpp"
+
+namespace oatpp { namespace protobuf { namespace json {
+
+class StreamingSerializer; // FWD
+
+/**
+ * Direct proto-to-json serializer. <br>
+ * Walks `google::protobuf::Reflection` of the proto object and writes json straight to the stream
+ * without building &id:oatpp::protobuf::reflection::DynamicObject; tree. <br>
+ * Output is the same as of the `"protobuf"` interpretation.
+ */
+class Serializer {
+  template<class T>
+  friend class codec::Codec;
+  friend class StreamingSerializer;
+public:
+  typedef oatpp::parser::json::mapping::Serializer JsonSerializer;
+  typedef oatpp::data::stream::ConsistentOutputStream ConsistentOutputStream;
+  typedef reflection::Message Message;
+  typedef reflection::Reflection Reflection;
+  typedef reflection::FieldDescriptor FieldDescriptor;
+public:
+
+  /**
+   * How to write fields which don't track presence and hold the default value. <br>
+   * Fields with presence (`optional`, message and oneof fields) are written as `null` when not set
+   * if `includeNullFields` is `true` - in any mode.
+   */
+  enum class DefaultValues : v_int32 {
+
+    /**
+     * Same as fields with presence - `null`, or omitted if `includeNullFields` is `false`.
+     * Output is the same as of the `"protobuf"` interpretation.
+     */
+    AS_NULL = 0,
+
+    /**
+     * Omit. Empty repeated and map fields are omitted as well - same as in proto3 json.
+     */
+    OMIT = 1,
+
+    /**
+     * Write the default value - `0`, `false`, `""`, or the enum value with number `0`.
+     */
+    EMIT = 2
+
+  };
+
+public:
+
+  /**
+   * Serializer config. <br>
+   * Extends &id:oatpp::parser::json::mapping::Serializer::Config; -
+   * pass it to the oatpp json serializer (object mapper) in place of the default config.
+   */
+  class Config : public JsonSerializer::Config {
+  public:
+
+    /**
+     * Create shared config.
+     * @return - `std::shared_ptr` to Config.
+     */
+    static std::shared_ptr<Config> createShared() {
+      return std::make_shared<Config>();
+    }
+
+    /**
+     * Write enum values as numbers instead of names.
+     */
+    bool enumsAsInt = false;
+
+    /**
+     * How to write fields which don't track presence (proto3 non-`optional` scalar, string and enum fields)
+     * and hold the default value. See &l:Serializer::DefaultValues;. <br>
+     * Applies to the direct serializer only (see &l:Serializer::enable ();). Objects written via the `"protobuf"`
+     * interpretation are converted to &id:oatpp::protobuf::reflection::DynamicObject; first and always
+     * behave as &l:Serializer::DefaultValues::AS_NULL;.
+     */
+    DefaultValues defaultValues = DefaultValues::AS_NULL;
+
+    /**
+     * Fields to write - &id:oatpp::protobuf::reflection::FieldMask;. `nullptr` - all fields. <br>
+     * Applies to every proto object written by the direct serializer (see &l:Serializer::enable ();) -
+     * generated codecs are bypassed. The `"protobuf"` interpretation has no access to the serializer config -
+     * wrap projected objects with the type of &id:oatpp::protobuf::reflection::DynamicObject::getObjectType; instead.
+     */
+    std::shared_ptr<const reflection::FieldMask> fieldMask;
+
+  };
+
+private:
+
+  /*
+   * Config values resolved once per serialize call.
+   * Fields with presence which are not set are written as `null` if `includeNullFields`.
+   */
+  struct Options {
+    bool includeNullFields;
+    bool enumsAsInt;
+
+    /* fields without presence holding the default value, and empty repeated fields, are omitted */
+    bool omitDefaults;
+
+    /* fields without presence holding the default value are written as values */
+    bool emitDefaults;
+
+    /* fields without presence holding the default value are written as `null` */
+    bool nullDefaults;
+  };
+
+private:
+  static Options getOptions(JsonSerializer* serializer);
+  static void serializeString(ConsistentOutputStream* stream, const char* data, v_buff_size size);
+  static void serializeEnum(const Options& options, ConsistentOutputStream* stream,
+                            const reflection::EnumTable* table, int number);
+  static void serializeWellKnown(const Options& options, ConsistentOutputStream* stream, const Message& message,
+                                 reflection::WellKnownType type, reflection::DynamicClass* clazz);
+  static void serializeAny(const Options& options, ConsistentOutputStream* stream, const Message& message);
+  static void serializeValue(const Options& options, ConsistentOutputStream* stream,
+                             const Message& message, const reflection::FieldInfo& info,
+                             const reflection::FieldMask* mask = nullptr);
+  static void serializeRepeatedValue(const Options& options, ConsistentOutputStream* stream,
+                                     const Message& message, const reflection::FieldInfo& info, int index,
+                                     const reflection::FieldMask* mask = nullptr);
+  static void serializeMapKey(ConsistentOutputStream* stream, const Message& entry, const FieldDescriptor* keyField);
+  static void serializeMap(const Options& options, ConsistentOutputStream* stream,
+                           const Message& message, const reflection::FieldInfo& info,
+                           const reflection::FieldMask* mask = nullptr);
+  template<typename T>
+  static void serializeScalars(ConsistentOutputStream* stream, const google::protobuf::RepeatedField<T>& values) {
+    const T* data = values.data();
+    int size = values.size();
+    stream->writeCharSimple('[');
+    for(int i = 0; i < size; i ++) {
+      if(i > 0) {
+        stream->writeCharSimple(',');
+      }
+      stream->writeAsString(data[i]);
+    }
+    stream->writeCharSimple(']');
+  }
+
+  static void serializeRepeated(const Options& options, ConsistentOutputStream* stream,
+                                const Message& message, const reflection::FieldInfo& info,
+                                const reflection::FieldMask* mask = nullptr);
+  static bool serializeFieldKey(const Options& options, ConsistentOutputStream* stream,
+                                const Message& message, const reflection::FieldInfo& info,
+                                bool& first, bool& isNull);
+  static void serializeField(const Options& options, ConsistentOutputStream* stream,
+                             const Message& message, const reflection::FieldInfo& info,
+                             const reflection::FieldMask* mask, bool& first);
+  static void serializeFields(const Options& options, ConsistentOutputStream* stream,
+                              const Message& message, reflection::DynamicClass* clazz, bool first,
+                              const reflection::FieldMask* mask = nullptr);
+  static void serializeMessage(const Options& options, ConsistentOutputStream* stream,
+                               const Message& message, reflection::DynamicClass* clazz,
+                               const reflection::FieldMask* mask = nullptr);
+  static void serializeObject(JsonSerializer* serializer,
+                              ConsistentOutputStream* stream,
+                              const oatpp::Void& polymorph,
+                              const reflection::FieldMask* mask);
+public:
+
+  /**
+   * Serialize proto message.
+   * @param serializer - oatpp json serializer. Its config is respected, including &l:Serializer::Config;.
+   * @param stream - output stream.
+   * @param message - proto message.
+   * @param clazz - &id:oatpp::protobuf::reflection::DynamicClass; of the message.
+   */
+  static void serializeMessage(JsonSerializer* serializer,
+                               ConsistentOutputStream* stream,
+                               const Message& message,
+                               reflection::DynamicClass* clazz);
+
+  /**
+   * Serialize only the fields of proto message selected by the mask. <br>
+   * Nested messages (singular, repeated and map values) are projected by the sub-masks of their fields.
+   * Generated codecs are not used - the message is serialized via reflection.
+   * @param serializer - oatpp json serializer. Its config is respected, including &l:Serializer::Config;.
+   * @param stream - output stream.
+   * @param message - proto message.
+   * @param clazz - &id:oatpp::protobuf::reflection::DynamicClass; of the message.
+   * @param mask - &id:oatpp::protobuf::reflection::FieldMask;. `nullptr` - all fields.
+   */
+  static void serializeMessage(JsonSerializer* serializer,
+                               ConsistentOutputStream* stream,
+                               const Message& message,
+                               reflection::DynamicClass* clazz,
+                               const reflection::FieldMask* mask);
+
+  /**
+   * Serializer method for &id:oatpp::protobuf::Object;. <br>
+   * Matches &id:oatpp::parser::json::mapping::Serializer::SerializerMethod;. <br>
+   * The object is projected by &l:Serializer::Config::fieldMask; if set.
+   * @param serializer
+   * @param stream
+   * @param polymorph
+   */
+  static void serialize(JsonSerializer* serializer,
+                        ConsistentOutputStream* stream,
+                        const oatpp::Void& polymorph);
+
+  /**
+   * Serialize &id:oatpp::protobuf::Object; projected by the mask. See &l:Serializer::serializeMessage ();. <br>
+   * The mask takes the place of &l:Serializer::Config::fieldMask;.
+   * @param serializer
+   * @param stream
+   * @param polymorph - &id:oatpp::protobuf::Object;.
+   * @param mask - &id:oatpp::protobuf::reflection::FieldMask;.
+   */
+  static void serialize(JsonSerializer* serializer,
+                        ConsistentOutputStream* stream,
+                        const oatpp::Void& polymorph,
+                        const reflection::FieldMask& mask);
+
+  /**
+   * Register serializer method for &id:oatpp::protobuf::Object; in the oatpp json serializer. <br>
+   * Once registered, proto objects are serialized directly and the `"protobuf"` interpretation is not used.
+   * @param serializer
+   */
+  static void enable(JsonSerializer* serializer);
+
+};
+
+}}}
+
+#endif // oatpp_protobuf_json_Serializer_hpp
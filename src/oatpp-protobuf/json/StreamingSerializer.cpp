@@ -0,0 +1,185 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#include "StreamingSerializer.hpp"
+
+#include <cstring>
+
+namespace oatpp { namespace protobuf { namespace json {
+
+constexpr v_buff_size StreamingSerializer::DEFAULT_CHUNK_SIZE;
+
+StreamingSerializer::StreamingSerializer(JsonSerializer* serializer,
+                                         const oatpp::Void& polymorph,
+                                         const std::shared_ptr<const reflection::FieldMask>& mask,
+                                         v_buff_size chunkSize)
+  : m_options(Serializer::getOptions(serializer))
+  , m_object(polymorph)
+  , m_mask(mask)
+  , m_chunkSize(chunkSize > 0 ? chunkSize : DEFAULT_CHUNK_SIZE)
+  , m_buffer(m_chunkSize + 256)
+  , m_position(0)
+{
+
+  if(!polymorph) {
+    m_buffer.writeSimple("null", 4);
+    return;
+  }
+
+  auto dispatcher = static_cast<const __class::AbstractObject::PolymorphicDispatcher*>(polymorph.valueType->polymorphicDispatcher);
+  const reflection::FieldMask* rootMask = (m_mask && !m_mask->isAll()) ? m_mask.get() : nullptr;
+  pushMessage(*dispatcher->getMessage(polymorph), dispatcher->getDynamicClass(), rootMask);
+
+}
+
+std::shared_ptr<StreamingSerializer> StreamingSerializer::createShared(JsonSerializer* serializer,
+                                                                       const oatpp::Void& polymorph,
+                                                                       const std::shared_ptr<const reflection::FieldMask>& mask,
+                                                                       v_buff_size chunkSize)
+{
+  return std::make_shared<StreamingSerializer>(serializer, polymorph, mask, chunkSize);
+}
+
+void StreamingSerializer::pushMessage(const Message& message, reflection::DynamicClass* clazz, const reflection::FieldMask* mask) {
+  Frame frame;
+  frame.message = &message;
+  frame.clazz = clazz;
+  frame.selection = (mask && !mask->isAll()) ? &mask->select(clazz->getDescriptor()) : nullptr;
+  frame.field = 0;
+  frame.first = true;
+  frame.items = nullptr;
+  frame.itemsMask = nullptr;
+  frame.item = 0;
+  frame.itemsCount = 0;
+  m_stack.push_back(frame);
+  m_buffer.writeCharSimple('{');
+}
+
+void StreamingSerializer::step() {
+
+  Frame& frame = m_stack.back();
+  const reflection::Reflection* refl = frame.message->GetReflection();
+
+  /* each step is accounted to the class of the message being written - the conversion is counted once, at its first step */
+  bool firstStep = frame.field == 0 && frame.items == nullptr;
+  reflection::Statistics::Tracker tracker(frame.clazz->getStatistics(), reflection::Statistics::PROTO_TO_JSON, firstStep);
+  if(firstStep) {
+    reflection::Statistics::onFieldsVisited(frame.selection ? frame.selection->size() : frame.clazz->getFields().size());
+  }
+
+  /* repeated message field - one item per step */
+  if(frame.items != nullptr) {
+    if(frame.item < frame.itemsCount) {
+      if(frame.item > 0) {
+        m_buffer.writeCharSimple(',');
+      }
+      const Message& item = refl->GetRepeatedMessage(*frame.message, frame.items->descriptor, frame.item ++);
+      pushMessage(item, frame.items->nestedClass, frame.itemsMask);
+    } else {
+      m_buffer.writeCharSimple(']');
+      frame.items = nullptr;
+    }
+    return;
+  }
+
+  const auto& fields = frame.clazz->getFields();
+  const reflection::FieldInfo* info;
+  const reflection::FieldMask* mask;
+
+  if(frame.selection) {
+    if(frame.field >= frame.selection->size()) {
+      m_buffer.writeCharSimple('}');
+      m_stack.pop_back();
+      return;
+    }
+    const auto& selected = (*frame.selection)[frame.field];
+    info = &fields[selected.index];
+    mask = selected.mask;
+  } else {
+    if(frame.field >= fields.size()) {
+      m_buffer.writeCharSimple('}');
+      m_stack.pop_back();
+      return;
+    }
+    info = &fields[frame.field];
+    mask = nullptr;
+  }
+
+  frame.field ++;
+
+  bool isNull;
+  if(!Serializer::serializeFieldKey(m_options, &m_buffer, *frame.message, *info, frame.first, isNull)) {
+    return;
+  }
+
+  if(isNull) {
+    m_buffer.writeSimple("null", 4);
+    return;
+  }
+
+  /* plain nested messages are written incrementally - everything else is written at once */
+  bool isMessage = info->nestedClass != nullptr && info->mapValue == nullptr &&
+                   info->wellKnownType == reflection::WellKnownType::NONE;
+
+  if(isMessage && info->descriptor->is_repeated()) {
+    m_buffer.writeCharSimple('[');
+    frame.items = info;
+    frame.itemsMask = mask;
+    frame.item = 0;
+    frame.itemsCount = refl->FieldSize(*frame.message, info->descriptor);
+  } else if(isMessage) {
+    pushMessage(refl->GetMessage(*frame.message, info->descriptor), info->nestedClass, mask);
+  } else if(info->descriptor->is_repeated()) {
+    Serializer::serializeRepeated(m_options, &m_buffer, *frame.message, *info, mask);
+  } else {
+    Serializer::serializeValue(m_options, &m_buffer, *frame.message, *info, mask);
+  }
+
+}
+
+v_io_size StreamingSerializer::read(void *buffer, v_buff_size count, async::Action& action) {
+
+  (void) action;
+
+  if(m_position == m_buffer.getCurrentPosition()) {
+    m_buffer.setCurrentPosition(0);
+    m_position = 0;
+    while(!m_stack.empty() && m_buffer.getCurrentPosition() < m_chunkSize) {
+      step();
+    }
+  }
+
+  v_buff_size available = m_buffer.getCurrentPosition() - m_position;
+  v_buff_size size = count < available ? count : available;
+  if(size > 0) {
+    std::memcpy(buffer, m_buffer.getData() + m_position, size);
+    m_position += size;
+  }
+
+  return size;
+
+}
+
+}}}
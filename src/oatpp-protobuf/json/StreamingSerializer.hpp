@@ -0,0 +1,124 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#ifndef oatpp_protobuf_json_StreamingSerializer_hpp
+#define oatpp_protobuf_json_StreamingSerializer_hpp
+
+#include "Serializer.hpp"
+
+#include "oatpp/core/data/stream/BufferStream.hpp"
+
+namespace oatpp { namespace protobuf { namespace json {
+
+/**
+ * Incremental proto-to-json serializer in the form of `oatpp::data::stream::ReadCallback`. <br>
+ * The message is serialized on demand as the callback is read - field by field, and item by item for repeated
+ * message fields, nested messages included. Json is produced in chunks of about `chunkSize` bytes, so memory usage
+ * doesn't depend on the number of items, and the first chunk is ready before the rest of the message is visited. <br>
+ * Use it as a response body - `oatpp::web::protocol::http::outgoing::StreamingBody`, in both simple and async APIs -
+ * `read` never blocks. <br>
+ * Output is the same as of &id:oatpp::protobuf::json::Serializer; without the beautifier. Generated codecs are not used.
+ * The message must not be modified until the callback is read to the end.
+ */
+class StreamingSerializer : public oatpp::data::stream::ReadCallback {
+public:
+  typedef Serializer::JsonSerializer JsonSerializer;
+  typedef Serializer::Message Message;
+public:
+
+  /**
+   * Default chunk size.
+   */
+  static constexpr v_buff_size DEFAULT_CHUNK_SIZE = 4096;
+
+private:
+
+  /*
+   * Message being written. Fields are written one by one - repeated message fields item by item.
+   */
+  struct Frame {
+    const Message* message;
+    reflection::DynamicClass* clazz;
+    const std::vector<reflection::FieldMask::Selection>* selection;
+    v_uint32 field;
+    bool first;
+    const reflection::FieldInfo* items;
+    const reflection::FieldMask* itemsMask;
+    int item;
+    int itemsCount;
+  };
+
+private:
+  Serializer::Options m_options;
+  oatpp::Void m_object;
+  std::shared_ptr<const reflection::FieldMask> m_mask;
+  v_buff_size m_chunkSize;
+  oatpp::data::stream::BufferOutputStream m_buffer;
+  v_buff_size m_position;
+  std::vector<Frame> m_stack;
+private:
+  void pushMessage(const Message& message, reflection::DynamicClass* clazz, const reflection::FieldMask* mask);
+  void step();
+public:
+
+  /**
+   * Constructor.
+   * @param serializer - oatpp json serializer. Its config is read once - see &id:oatpp::protobuf::json::Serializer::Config;.
+   * @param polymorph - &id:oatpp::protobuf::Object;. Kept alive by the callback.
+   * @param mask - &id:oatpp::protobuf::reflection::FieldMask;. `nullptr` - all fields.
+   * @param chunkSize - approximate size of the json chunk produced at once.
+   */
+  StreamingSerializer(JsonSerializer* serializer,
+                      const oatpp::Void& polymorph,
+                      const std::shared_ptr<const reflection::FieldMask>& mask = nullptr,
+                      v_buff_size chunkSize = DEFAULT_CHUNK_SIZE);
+
+  /**
+   * Create shared StreamingSerializer.
+   * @param serializer - oatpp json serializer.
+   * @param polymorph - &id:oatpp::protobuf::Object;.
+   * @param mask - &id:oatpp::protobuf::reflection::FieldMask;. `nullptr` - all fields.
+   * @param chunkSize - approximate size of the json chunk produced at once.
+   * @return - `std::shared_ptr` to StreamingSerializer.
+   */
+  static std::shared_ptr<StreamingSerializer> createShared(JsonSerializer* serializer,
+                                                           const oatpp::Void& polymorph,
+                                                           const std::shared_ptr<const reflection::FieldMask>& mask = nullptr,
+                                                           v_buff_size chunkSize = DEFAULT_CHUNK_SIZE);
+
+  /**
+   * Read next portion of json.
+   * @param buffer - buffer to read to.
+   * @param count - buffer size.
+   * @param action - not used - the callback never blocks.
+   * @return - number of bytes read. `0` - end of json.
+   */
+  v_io_size read(void *buffer, v_buff_size count, async::Action& action) override;
+
+};
+
+}}}
+
+#endif // oatpp_protobuf_json_StreamingSerializer_hpp
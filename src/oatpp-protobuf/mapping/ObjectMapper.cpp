@@ -0,0 +1,152 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#include "ObjectMapper.hpp"
+
+#include "oatpp-protobuf/io/ZeroCopyStream.hpp"
+
+#include <google/protobuf/io/coded_stream.h>
+
+#include <limits>
+
+namespace oatpp { namespace protobuf { namespace mapping {
+
+ObjectMapper::ObjectMapper(const std::shared_ptr<Config>& config)
+  : oatpp::data::mapping::ObjectMapper(Info("application/x-protobuf"))
+  , m_config(config)
+{}
+
+std::shared_ptr<ObjectMapper> ObjectMapper::createShared(const std::shared_ptr<Config>& config) {
+  return std::make_shared<ObjectMapper>(config);
+}
+
+const std::shared_ptr<ObjectMapper::Config>& ObjectMapper::getConfig() const {
+  return m_config;
+}
+
+std::shared_ptr<google::protobuf::Arena> ObjectMapper::createArena() const {
+  if(m_config->useArena) {
+    return std::make_shared<google::protobuf::Arena>();
+  }
+  return nullptr;
+}
+
+const __class::AbstractObject::PolymorphicDispatcher* ObjectMapper::getDispatcher(const oatpp::Type* type, const char* method) {
+  if(type->classId.id != __class::AbstractObject::CLASS_ID.id) {
+    throw std::runtime_error(std::string("[oatpp::protobuf::mapping::ObjectMapper::") + method + "()]: "
+                             "Error. Unsupported type '" + type->classId.name + "'. Only oatpp::protobuf::Object<T> is supported.");
+  }
+  return static_cast<const __class::AbstractObject::PolymorphicDispatcher*>(type->polymorphicDispatcher);
+}
+
+void ObjectMapper::write(data::stream::ConsistentOutputStream* stream, const oatpp::Void& variant) const {
+
+  auto dispatcher = getDispatcher(variant.valueType, "write");
+  if(!variant) {
+    return; // empty message
+  }
+
+  auto message = dispatcher->getMessage(variant);
+  auto size = message->ByteSizeLong();
+
+  bool error;
+
+  auto buffer = dynamic_cast<data::stream::BufferOutputStream*>(stream);
+  if(buffer) {
+    io::BufferOutputStreamAdapter adapter(buffer, (v_buff_size) size);
+    google::protobuf::io::CodedOutputStream output(&adapter);
+    message->SerializeWithCachedSizes(&output);
+    error = output.HadError();
+  } else {
+    io::OutputStreamAdapter adapter(stream);
+    google::protobuf::io::CopyingOutputStreamAdaptor copyingAdapter(&adapter);
+    {
+      google::protobuf::io::CodedOutputStream output(&copyingAdapter);
+      message->SerializeWithCachedSizes(&output);
+      error = output.HadError();
+    }
+    error = !copyingAdapter.Flush() || error;
+  }
+
+  if(error) {
+    throw std::runtime_error("[oatpp::protobuf::mapping::ObjectMapper::write()]: Error. Can't write proto message to stream.");
+  }
+
+}
+
+oatpp::Void ObjectMapper::read(oatpp::parser::Caret& caret, const oatpp::Type* const type) const {
+
+  auto dispatcher = getDispatcher(type, "read");
+
+  /* protobuf parses at most 2 GiB from a single array */
+  v_buff_size size = caret.getDataSize() - caret.getPosition();
+  if(size > std::numeric_limits<int>::max()) {
+    caret.setError("[oatpp::protobuf::mapping::ObjectMapper::read()]: Error. Proto message is too large.");
+    return oatpp::Void(type);
+  }
+
+  auto object = dispatcher->createObject(createArena());
+  auto message = dispatcher->getMessage(object);
+
+  google::protobuf::io::ArrayInputStream input(caret.getCurrData(), (int) size);
+
+  if(!message->ParseFromZeroCopyStream(&input)) {
+    caret.setError("[oatpp::protobuf::mapping::ObjectMapper::read()]: Error. Can't parse proto message.");
+    return oatpp::Void(type);
+  }
+
+  caret.setPosition(caret.getDataSize());
+  return object;
+
+}
+
+oatpp::Void ObjectMapper::readFromStream(data::stream::ReadCallback* stream, const oatpp::Type* const type) const {
+
+  auto dispatcher = getDispatcher(type, "readFromStream");
+
+  auto object = dispatcher->createObject(createArena());
+  auto message = dispatcher->getMessage(object);
+
+  bool parsed;
+
+  auto buffer = dynamic_cast<data::stream::BufferInputStream*>(stream);
+  if(buffer) {
+    io::BufferInputStreamAdapter adapter(buffer);
+    parsed = message->ParseFromZeroCopyStream(&adapter);
+  } else {
+    io::InputStreamAdapter adapter(stream);
+    google::protobuf::io::CopyingInputStreamAdaptor copyingAdapter(&adapter);
+    parsed = message->ParseFromZeroCopyStream(&copyingAdapter);
+  }
+
+  if(!parsed) {
+    throw std::runtime_error("[oatpp::protobuf::mapping::ObjectMapper::readFromStream()]: Error. Can't parse proto message.");
+  }
+
+  return object;
+
+}
+
+}}}
@@ -0,0 +1,138 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#ifndef oatpp_protobuf_mapping_ObjectMapper_hpp
+#define oatpp_protobuf_mapping_ObjectMapper_hpp
+
+#include "oatpp-protobuf/Object.hpp"
+
+#include "oatpp/core/data/mapping/ObjectMapper.hpp"
+
+namespace oatpp { namespace protobuf { namespace mapping {
+
+/**
+ * Binary protobuf ObjectMapper (`application/x-protobuf`). <br>
+ * Maps &id:oatpp::protobuf::Object; to/from protobuf wire format. <br>
+ * Messages are written straight into the memory of oatpp buffers and parsed straight from the parsing caret -
+ * see &id:oatpp::protobuf::io::BufferOutputStreamAdapter;.
+ */
+class ObjectMapper : public oatpp::data::mapping::ObjectMapper {
+public:
+
+  /**
+   * Object mapper config.
+   */
+  class Config : public oatpp::base::Countable {
+  public:
+
+    /**
+     * Create shared config.
+     * @return - `std::shared_ptr` to Config.
+     */
+    static std::shared_ptr<Config> createShared() {
+      return std::make_shared<Config>();
+    }
+
+    /**
+     * Create parsed proto objects on `google::protobuf::Arena` - one arena per read call.
+     * The arena lives as long as the object.
+     */
+    bool useArena = false;
+
+  };
+
+private:
+  static const __class::AbstractObject::PolymorphicDispatcher* getDispatcher(const oatpp::Type* type, const char* method);
+private:
+  std::shared_ptr<google::protobuf::Arena> createArena() const;
+private:
+  std::shared_ptr<Config> m_config;
+public:
+
+  /**
+   * Constructor.
+   * @param config - &l:ObjectMapper::Config;.
+   */
+  ObjectMapper(const std::shared_ptr<Config>& config = std::make_shared<Config>());
+public:
+
+  /**
+   * Create shared ObjectMapper.
+   * @param config - &l:ObjectMapper::Config;.
+   * @return - `std::shared_ptr` to ObjectMapper.
+   */
+  static std::shared_ptr<ObjectMapper> createShared(const std::shared_ptr<Config>& config = std::make_shared<Config>());
+
+  /**
+   * Get config.
+   * @return - &l:ObjectMapper::Config;.
+   */
+  const std::shared_ptr<Config>& getConfig() const;
+
+  /**
+   * Serialize proto object to the stream. <br>
+   * If the stream is &id:oatpp::data::stream::BufferOutputStream; - the message is serialized directly into its memory.
+   * @param stream - &id:oatpp::data::stream::ConsistentOutputStream;.
+   * @param variant - &id:oatpp::protobuf::Object;.
+   * @throws - `std::runtime_error` if variant is not a proto object.
+   */
+  void write(data::stream::ConsistentOutputStream* stream, const oatpp::Void& variant) const override;
+
+  /**
+   * Parse proto object from the remaining data of the caret. <br>
+   * On success the caret is moved to the end of data. On failure the caret error is set.
+   * @param caret - &id:oatpp::parser::Caret;.
+   * @param type - type of &id:oatpp::protobuf::Object;.
+   * @return - &id:oatpp::protobuf::Object;.
+   * @throws - `std::runtime_error` if type is not a proto object type.
+   */
+  oatpp::Void read(oatpp::parser::Caret& caret, const oatpp::Type* const type) const override;
+
+  /**
+   * Parse proto object from the stream. Reads stream until its end. <br>
+   * If the stream is &id:oatpp::data::stream::BufferInputStream; - the message is parsed directly from its memory.
+   * @param stream - &id:oatpp::data::stream::ReadCallback;.
+   * @param type - type of &id:oatpp::protobuf::Object;.
+   * @return - &id:oatpp::protobuf::Object;.
+   * @throws - `std::runtime_error` on parsing error.
+   */
+  oatpp::Void readFromStream(data::stream::ReadCallback* stream, const oatpp::Type* const type) const;
+
+  /**
+   * Parse proto object from the stream. Reads stream until its end.
+   * @tparam Wrapper - &id:oatpp::protobuf::Object;.
+   * @param stream - &id:oatpp::data::stream::ReadCallback;.
+   * @return - &id:oatpp::protobuf::Object;.
+   */
+  template<class Wrapper>
+  Wrapper readFromStream(data::stream::ReadCallback* stream) const {
+    return readFromStream(stream, Wrapper::Class::getType()).template staticCast<Wrapper>();
+  }
+
+};
+
+}}}
+
+#endif // oatpp_protobuf_mapping_ObjectMapper_hpp
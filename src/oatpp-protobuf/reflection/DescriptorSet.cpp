@@ -0,0 +1,226 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#include "DescriptorSet.hpp"
+
+#include <google/protobuf/io/coded_stream.h>
+
+#include <fstream>
+#include <iterator>
+#include <limits>
+
+#if !defined(WIN32) && !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace oatpp { namespace protobuf { namespace reflection {
+
+std::mutex DescriptorSet::REGISTRY_MUTEX;
+std::vector<DescriptorSet*> DescriptorSet::REGISTRY;
+
+DescriptorSet::DescriptorSet()
+  : m_data(nullptr)
+  , m_size(0)
+  , m_mapped(false)
+  , m_generatedDatabase(*google::protobuf::DescriptorPool::generated_pool())
+  , m_mergedDatabase(&m_database, &m_generatedDatabase)
+  , m_pool(&m_mergedDatabase)
+  , m_factory(&m_pool)
+{}
+
+void DescriptorSet::index() {
+
+  if(m_size > std::numeric_limits<int>::max()) {
+    throw std::runtime_error("[oatpp::protobuf::reflection::DescriptorSet::index()]: Error. Descriptor set is too large.");
+  }
+
+  /* FileDescriptorSet is 'repeated FileDescriptorProto file = 1' - split it without parsing the files */
+  google::protobuf::io::CodedInputStream stream((const google::protobuf::uint8*) m_data, (int) m_size);
+
+  while(google::protobuf::uint32 tag = stream.ReadTag()) {
+
+    google::protobuf::uint32 size;
+    if(tag != ((1 << 3) | 2) || !stream.ReadVarint32(&size) || size > (google::protobuf::uint32) (m_size - stream.CurrentPosition())) {
+      throw std::runtime_error("[oatpp::protobuf::reflection::DescriptorSet::index()]: Error. Invalid descriptor set.");
+    }
+
+    const char* file = m_data + stream.CurrentPosition();
+    if(!m_database.Add(file, (int) size)) {
+      throw std::runtime_error("[oatpp::protobuf::reflection::DescriptorSet::index()]: Error. Invalid file descriptor.");
+    }
+
+    stream.Skip((int) size);
+
+  }
+
+  if(!stream.ConsumedEntireMessage()) {
+    throw std::runtime_error("[oatpp::protobuf::reflection::DescriptorSet::index()]: Error. Invalid descriptor set.");
+  }
+
+}
+
+DescriptorSet* DescriptorSet::registryAdd(DescriptorSet* set) {
+  std::lock_guard<std::mutex> lock(REGISTRY_MUTEX);
+  REGISTRY.push_back(set);
+  return set;
+}
+
+DescriptorSet* DescriptorSet::loadFile(const std::string& path) {
+
+  std::unique_ptr<DescriptorSet> set(new DescriptorSet());
+
+#if !defined(WIN32) && !defined(_WIN32)
+
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if(fd < 0) {
+    throw std::runtime_error("[oatpp::protobuf::reflection::DescriptorSet::loadFile()]: Error. Can't open file " + path);
+  }
+
+  struct stat info;
+  if(::fstat(fd, &info) != 0) {
+    ::close(fd);
+    throw std::runtime_error("[oatpp::protobuf::reflection::DescriptorSet::loadFile()]: Error. Can't stat file " + path);
+  }
+
+  if(info.st_size > 0) {
+    void* data = ::mmap(nullptr, (size_t) info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if(data == MAP_FAILED) {
+      ::close(fd);
+      throw std::runtime_error("[oatpp::protobuf::reflection::DescriptorSet::loadFile()]: Error. Can't map file " + path);
+    }
+    set->m_data = (const char*) data;
+    set->m_size = (v_buff_size) info.st_size;
+    set->m_mapped = true;
+  }
+
+  /* the mapping stays valid after the descriptor is closed */
+  ::close(fd);
+
+#else
+
+  std::ifstream file(path, std::ios::in | std::ios::binary);
+  if(!file.is_open()) {
+    throw std::runtime_error("[oatpp::protobuf::reflection::DescriptorSet::loadFile()]: Error. Can't open file " + path);
+  }
+  set->m_buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+  set->m_data = set->m_buffer.data();
+  set->m_size = (v_buff_size) set->m_buffer.size();
+
+#endif
+
+  try {
+    set->index();
+  } catch (...) {
+#if !defined(WIN32) && !defined(_WIN32)
+    if(set->m_mapped) {
+      ::munmap((void*) set->m_data, (size_t) set->m_size);
+    }
+#endif
+    throw;
+  }
+
+  return registryAdd(set.release());
+
+}
+
+DescriptorSet* DescriptorSet::loadData(const std::string& data) {
+  std::unique_ptr<DescriptorSet> set(new DescriptorSet());
+  set->m_buffer = data;
+  set->m_data = set->m_buffer.data();
+  set->m_size = (v_buff_size) set->m_buffer.size();
+  set->index();
+  return registryAdd(set.release());
+}
+
+google::protobuf::MessageFactory* DescriptorSet::registryGetFactory(const google::protobuf::DescriptorPool* pool) {
+
+  if(pool == google::protobuf::DescriptorPool::generated_pool()) {
+    return google::protobuf::MessageFactory::generated_factory();
+  }
+
+  std::lock_guard<std::mutex> lock(REGISTRY_MUTEX);
+  for(auto set : REGISTRY) {
+    if(&set->m_pool == pool) {
+      return &set->m_factory;
+    }
+  }
+
+  return nullptr;
+
+}
+
+const google::protobuf::Descriptor* DescriptorSet::registryFindMessageType(const std::string& name) {
+  std::lock_guard<std::mutex> lock(REGISTRY_MUTEX);
+  for(auto set : REGISTRY) {
+    auto desc = set->m_pool.FindMessageTypeByName(name);
+    if(desc != nullptr) {
+      return desc;
+    }
+  }
+  return nullptr;
+}
+
+const google::protobuf::DescriptorPool* DescriptorSet::getPool() const {
+  return &m_pool;
+}
+
+google::protobuf::MessageFactory* DescriptorSet::getFactory() {
+  return &m_factory;
+}
+
+DynamicClass* DescriptorSet::getClass(const std::string& name) {
+
+  const google::protobuf::Descriptor* desc = m_pool.FindMessageTypeByName(name);
+
+  if(desc == nullptr) {
+    throw std::runtime_error("[oatpp::protobuf::reflection::DescriptorSet::getClass()]: "
+                             "Error. Can't find protobuf::Descriptor for name " + name);
+  }
+
+  return DynamicClass::registryGetClass(desc);
+
+}
+
+void DescriptorSet::registerAll(v_int32 threadsCount) {
+
+  std::vector<std::string> fileNames;
+  m_database.FindAllFileNames(&fileNames);
+
+  std::vector<const google::protobuf::Descriptor*> descriptors;
+  for(auto& fileName : fileNames) {
+    auto file = m_pool.FindFileByName(fileName);
+    for(int i = 0; file != nullptr && i < file->message_type_count(); i++) {
+      descriptors.push_back(file->message_type(i));
+    }
+  }
+
+  DynamicClass::registerAll(descriptors, threadsCount);
+
+}
+
+}}}
@@ -0,0 +1,134 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#ifndef oatpp_protobuf_reflection_DescriptorSet_hpp
+#define oatpp_protobuf_reflection_DescriptorSet_hpp
+
+#include "DynamicObject.hpp"
+
+#include <google/protobuf/descriptor_database.h>
+#include <google/protobuf/dynamic_message.h>
+
+namespace oatpp { namespace protobuf { namespace reflection {
+
+/**
+ * Proto types loaded at runtime from a serialized `google.protobuf.FileDescriptorSet`
+ * (`protoc --include_imports --descriptor_set_out=...`). <br>
+ * Types don't need to be linked as generated code - proto objects are instances of `google::protobuf::DynamicMessage`
+ * and are used through &id:oatpp::protobuf::reflection::DynamicClass; same as generated ones. <br>
+ * Files of the set are indexed on load, descriptors are built lazily - only for types which are actually used
+ * (and their dependencies). Files missing in the set (such as imported well-known types) are taken from the files
+ * of the generated pool. <br>
+ * Loaded sets are never unloaded - same as classes of the &id:oatpp::protobuf::reflection::DynamicClass; registry.
+ */
+class DescriptorSet {
+private:
+  static std::mutex REGISTRY_MUTEX;
+  static std::vector<DescriptorSet*> REGISTRY;
+private:
+  static DescriptorSet* registryAdd(DescriptorSet* set);
+private:
+  std::string m_buffer;
+  const char* m_data;
+  v_buff_size m_size;
+  bool m_mapped;
+  google::protobuf::EncodedDescriptorDatabase m_database;
+  google::protobuf::DescriptorPoolDatabase m_generatedDatabase;
+  google::protobuf::MergedDescriptorDatabase m_mergedDatabase;
+  google::protobuf::DescriptorPool m_pool;
+  google::protobuf::DynamicMessageFactory m_factory;
+private:
+  DescriptorSet();
+  void index();
+public:
+
+  /**
+   * Non-copyable.
+   */
+  DescriptorSet(const DescriptorSet&) = delete;
+  DescriptorSet& operator=(const DescriptorSet&) = delete;
+
+  /**
+   * Load descriptor set from file. <br>
+   * The file is memory-mapped (read into memory on platforms without `mmap`) and stays mapped for the lifetime
+   * of the process - encoded file descriptors are not copied.
+   * @param path - path to the serialized `google.protobuf.FileDescriptorSet`.
+   * @return - loaded set. Throws `std::runtime_error` if the file can't be read or is not a descriptor set.
+   */
+  static DescriptorSet* loadFile(const std::string& path);
+
+  /**
+   * Load descriptor set from memory. Data is copied.
+   * @param data - serialized `google.protobuf.FileDescriptorSet`.
+   * @return - loaded set. Throws `std::runtime_error` if data is not a descriptor set.
+   */
+  static DescriptorSet* loadData(const std::string& data);
+
+  /**
+   * Get message factory for proto objects of the descriptor pool. <br>
+   * `MessageFactory::generated_factory()` for the generated pool, factory of the loaded set for its pool.
+   * @param pool - descriptor pool.
+   * @return - message factory or `nullptr` if the pool is not known.
+   */
+  static google::protobuf::MessageFactory* registryGetFactory(const google::protobuf::DescriptorPool* pool);
+
+  /**
+   * Find message type by full name in all loaded sets - in the order of loading.
+   * @param name - full name of the message type.
+   * @return - descriptor or `nullptr` if there is no such type.
+   */
+  static const google::protobuf::Descriptor* registryFindMessageType(const std::string& name);
+
+  /**
+   * Get descriptor pool of this set.
+   * @return
+   */
+  const google::protobuf::DescriptorPool* getPool() const;
+
+  /**
+   * Get factory of proto objects of this set.
+   * @return
+   */
+  google::protobuf::MessageFactory* getFactory();
+
+  /**
+   * Get class by full name of the message type of this set.
+   * @param name - full name of the message type.
+   * @return - &id:oatpp::protobuf::reflection::DynamicClass;. Throws `std::runtime_error` if there is no such type.
+   */
+  DynamicClass* getClass(const std::string& name);
+
+  /**
+   * Build classes of all message types of this set eagerly - descriptors of all files of the set are built.
+   * See &id:oatpp::protobuf::reflection::DynamicClass::registerAll;.
+   * @param threadsCount - number of threads. `0` - `std::thread::hardware_concurrency()`.
+   */
+  void registerAll(v_int32 threadsCount = 0);
+
+};
+
+}}}
+
+#endif // oatpp_protobuf_reflection_DescriptorSet_hpp
@@ -23,9 +23,59 @@
  ***************************************************************************/
 
 #include "DynamicObject.hpp"
+#include "DescriptorSet.hpp"
+#include "WellKnownTypes.hpp"
+
+#include <google/protobuf/descriptor.pb.h>
+
+#include <iterator>
+#include <thread>
 
 namespace oatpp { namespace protobuf { namespace reflection {
 
+namespace {
+
+/* set once the pools of the thread are destroyed - objects released later on thread exit are deleted */
+thread_local bool POOLS_DESTROYED = false;
+
+/*
+ * Free DynamicObjects of the thread - one list per DynamicClass, indexed by DynamicClass::m_poolIndex.
+ */
+struct ThreadPools {
+
+  std::vector<std::vector<DynamicObject*>> pools;
+
+  void clear() {
+    /* deleting an object doesn't touch the pools - pooled objects hold no field values */
+    for(auto& pool : pools) {
+      for(auto object : pool) {
+        delete object;
+      }
+      pool.clear();
+    }
+  }
+
+  ~ThreadPools() {
+    clear();
+    POOLS_DESTROYED = true;
+  }
+
+  std::vector<DynamicObject*>& get(v_uint32 index) {
+    if(pools.size() <= index) {
+      pools.resize(index + 1);
+    }
+    return pools[index];
+  }
+
+};
+
+ThreadPools& getThreadPools() {
+  thread_local ThreadPools pools;
+  return pools;
+}
+
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Dynamic Class | PolymorphicDispatcher
 
@@ -34,44 +84,64 @@ DynamicClass::PolymorphicDispatcher::PolymorphicDispatcher(DynamicClass* clazz)
 {}
 
 oatpp::Void DynamicClass::PolymorphicDispatcher::createObject() const {
-  auto proto = m_class->createProto();
-  auto ptr = std::shared_ptr<DynamicObject>(new DynamicObject(m_class));
-  ptr->initFromProto(*proto);
+  auto ptr = DynamicObject::allocate(m_class);
+  ptr->initEmpty();
   return oatpp::Void(ptr, m_class->getType());
 }
 
 const oatpp::data::mapping::type::BaseObject::Properties* DynamicClass::PolymorphicDispatcher::getProperties() const {
 
-  std::lock_guard<std::mutex> lock(m_class->m_typeMutex);
+  auto properties = m_class->m_properties.load(std::memory_order_acquire);
+  if(properties != nullptr) {
+    return properties;
+  }
+
+  /* resolve fields before locking m_typeMutex - field types of recursive messages require getType() of this class */
+  const auto& fields = m_class->getFields();
 
-  if(m_class->m_properties == nullptr) {
+  std::lock_guard<std::mutex> lock(m_class->m_typeMutex);
 
-    auto proto = m_class->createProto();
-    auto objPtr = std::shared_ptr<DynamicObject>(new DynamicObject(m_class));
-    objPtr->initFromProto(*proto);
-    m_class->m_properties = new oatpp::data::mapping::type::BaseObject::Properties();
+  properties = m_class->m_properties.load(std::memory_order_relaxed);
+  if(properties == nullptr) {
 
-    const google::protobuf::Descriptor* desc = proto->GetDescriptor();
+    properties = new oatpp::data::mapping::type::BaseObject::Properties();
 
-    int fieldCount = desc->field_count();
-    if(fieldCount != objPtr->m_fields.size()) {
-      throw std::runtime_error("[oatpp::protobuf::reflection::DynamicClass::propertiesGetter()]: Error."
-                               "Invalid state.");
+    for(v_uint32 i = 0; i < fields.size(); i++) {
+      const auto& field = fields[i];
+      auto prop = new oatpp::data::mapping::type::BaseObject::Property(i * sizeof(oatpp::Void), field.descriptor->name().c_str(), field.type);
+      properties->pushBack(prop);
     }
 
-    for(int i = 0; i < fieldCount; i++) {
-      const google::protobuf::FieldDescriptor* field = desc->field(i);
-      auto& objField = objPtr->m_fields[i];
-      auto prop = new oatpp::data::mapping::type::BaseObject::Property(i * sizeof(oatpp::Void), field->name().c_str(), objField.valueType);
-      m_class->m_properties->pushBack(prop);
-    }
+    m_class->m_properties.store(properties, std::memory_order_release);
 
   }
 
-  return m_class->m_properties;
+  return properties;
 
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Dynamic Class | ProjectedPolymorphicDispatcher
+
+DynamicClass::ProjectedPolymorphicDispatcher::ProjectedPolymorphicDispatcher(DynamicClass* clazz,
+                                                                             const std::vector<FieldMask::Selection>& selection)
+  : PolymorphicDispatcher(clazz)
+{
+  /* properties are shared with the class - property of the field is at the offset of the field in any object */
+  const auto& properties = PolymorphicDispatcher::getProperties()->getList();
+  auto it = properties.begin();
+  v_uint32 index = 0;
+  for(const auto& selected : selection) {
+    std::advance(it, selected.index - index);
+    index = selected.index;
+    m_properties.pushBack(*it);
+  }
+}
+
+const oatpp::data::mapping::type::BaseObject::Properties* DynamicClass::ProjectedPolymorphicDispatcher::getProperties() const {
+  return &m_properties;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Dynamic Class | VectorPolymorphicDispatcher
 
@@ -89,237 +159,845 @@ void DynamicClass::VectorPolymorphicDispatcher::addPolymorphicItem(const oatpp::
   vector->push_back(vectorItem);
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Dynamic Class | FieldsPolymorphicDispatcher
+
+DynamicClass::FieldsPolymorphicDispatcher::FieldsPolymorphicDispatcher(DynamicClass* clazz)
+  : m_class(clazz)
+{}
+
+oatpp::Void DynamicClass::FieldsPolymorphicDispatcher::createObject() const {
+  return oatpp::Void(std::make_shared<std::unordered_map<oatpp::String, AbstractDynamicObject>>(), m_class->getFieldsType());
+}
+
+void DynamicClass::FieldsPolymorphicDispatcher::addPolymorphicItem(const oatpp::Void& object,
+                                                                   const oatpp::Void& key,
+                                                                   const oatpp::Void& value) const
+{
+  const auto& map = object.staticCast<oatpp::UnorderedFields<AbstractDynamicObject>>();
+  AbstractDynamicObject mapValue(std::static_pointer_cast<DynamicObject>(value.getPtr()), m_class->getType());
+  (*map)[key.staticCast<oatpp::String>()] = mapValue;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Dynamic Class
 
 std::mutex DynamicClass::REGISTRY_MUTEX;
-std::unordered_map<std::string, DynamicClass*> DynamicClass::REGISTRY;
+std::unordered_map<const google::protobuf::Descriptor*, DynamicClass*> DynamicClass::REGISTRY;
+std::atomic<v_uint32> DynamicClass::CLASSES_COUNT(0);
 
-DynamicClass::DynamicClass(const std::string& name)
-  : m_name(name)
+DynamicClass::DynamicClass(const google::protobuf::Descriptor* descriptor)
+  : m_descriptor(descriptor)
+  , m_name(descriptor->full_name())
+  , m_typeUrl("type.googleapis.com/" + m_name)
   , m_type(nullptr)
   , m_properties(nullptr)
   , m_vectorType(nullptr)
+  , m_fieldsType(nullptr)
+  , m_fields(nullptr)
+  , m_prototype(nullptr)
+  , m_poolIndex(CLASSES_COUNT.fetch_add(1, std::memory_order_relaxed))
 {}
 
+FieldInfo DynamicClass::createMapFieldInfo(const FieldDescriptor* field) {
+
+  auto value = std::make_shared<FieldInfo>(createFieldInfo(field->message_type()->map_value()));
+
+  if(value->wellKnownType != WellKnownType::NONE) {
+    return WellKnownTypes::createMapFieldInfo(field, value);
+  }
+
+  switch(value->descriptor->cpp_type()) {
+    case google::protobuf::FieldDescriptor::CPPTYPE_STRING: return Utils::createMapFieldInfo<std::string>(field, value);
+    case google::protobuf::FieldDescriptor::CPPTYPE_INT32: return Utils::createMapFieldInfo<v_int32>(field, value);
+    case google::protobuf::FieldDescriptor::CPPTYPE_UINT32: return Utils::createMapFieldInfo<v_uint32>(field, value);
+    case google::protobuf::FieldDescriptor::CPPTYPE_INT64: return Utils::createMapFieldInfo<v_int64>(field, value);
+    case google::protobuf::FieldDescriptor::CPPTYPE_UINT64: return Utils::createMapFieldInfo<v_uint64>(field, value);
+    case google::protobuf::FieldDescriptor::CPPTYPE_FLOAT: return Utils::createMapFieldInfo<v_float32>(field, value);
+    case google::protobuf::FieldDescriptor::CPPTYPE_DOUBLE: return Utils::createMapFieldInfo<v_float64>(field, value);
+    case google::protobuf::FieldDescriptor::CPPTYPE_BOOL: return Utils::createMapFieldInfo<bool>(field, value);
+    case google::protobuf::FieldDescriptor::CPPTYPE_ENUM: return Utils::createMapFieldInfo<EnumDescriptor>(field, value);
+    case google::protobuf::FieldDescriptor::CPPTYPE_MESSAGE: return Utils::createMapFieldInfo<Message>(field, value);
+    default:
+      throw std::runtime_error("[oatpp::protobuf::reflection::DynamicClass::createMapFieldInfo()]: "
+                               "Error. Unknown type - " + std::string(value->descriptor->type_name()));
+  }
+
+}
+
+FieldInfo DynamicClass::createFieldInfo(const FieldDescriptor* field) {
+
+  /* maps are converted as a whole - entries don't get classes of their own */
+  if(field->is_map()) {
+    return createMapFieldInfo(field);
+  }
+
+  switch(field->type()) {
+
+    case google::protobuf::FieldDescriptor::TYPE_STRING:
+    case google::protobuf::FieldDescriptor::TYPE_BYTES: return Utils::createFieldInfo<std::string>(field);
+
+    case google::protobuf::FieldDescriptor::TYPE_INT32:
+    case google::protobuf::FieldDescriptor::TYPE_SINT32:
+    case google::protobuf::FieldDescriptor::TYPE_SFIXED32: return Utils::createFieldInfo<v_int32>(field);
+
+    case google::protobuf::FieldDescriptor::TYPE_UINT32:
+    case google::protobuf::FieldDescriptor::TYPE_FIXED32: return Utils::createFieldInfo<v_uint32>(field);
+
+    case google::protobuf::FieldDescriptor::TYPE_INT64:
+    case google::protobuf::FieldDescriptor::TYPE_SINT64:
+    case google::protobuf::FieldDescriptor::TYPE_SFIXED64: return Utils::createFieldInfo<v_int64>(field);
+
+    case google::protobuf::FieldDescriptor::TYPE_UINT64:
+    case google::protobuf::FieldDescriptor::TYPE_FIXED64: return Utils::createFieldInfo<v_uint64>(field);
+
+    case google::protobuf::FieldDescriptor::TYPE_FLOAT: return Utils::createFieldInfo<v_float32>(field);
+    case google::protobuf::FieldDescriptor::TYPE_DOUBLE: return Utils::createFieldInfo<v_float64>(field);
+
+    case google::protobuf::FieldDescriptor::TYPE_BOOL: return Utils::createFieldInfo<bool>(field);
+
+    case google::protobuf::FieldDescriptor::TYPE_ENUM: {
+      FieldInfo info = Utils::createFieldInfo<EnumDescriptor>(field);
+      info.enumTable = EnumTable::get(field->enum_type());
+      return info;
+    }
+
+    case google::protobuf::FieldDescriptor::TYPE_MESSAGE: {
+      WellKnownType wellKnownType = WellKnownTypes::getType(field->message_type());
+      if(wellKnownType != WellKnownType::NONE) {
+        return WellKnownTypes::createFieldInfo(field, wellKnownType, registryGetClass(field->message_type()));
+      }
+      FieldInfo info = Utils::createFieldInfo<Message>(field);
+      info.nestedClass = registryGetClass(field->message_type());
+      return info;
+    }
+
+    // case google::protobuf::FieldDescriptor::TYPE_GROUP: deprecated
+
+    default:
+      throw std::runtime_error("[oatpp::protobuf::reflection::DynamicClass::createFieldInfo()]: "
+                               "Error. Unknown type - " + std::string(field->type_name()));
+  }
+
+}
+
+DynamicClass* DynamicClass::registryGetClass(const google::protobuf::Descriptor* descriptor) {
+
+  /* classes are never removed from the registry, so once seen the pointer can be cached by the thread */
+  thread_local std::unordered_map<const google::protobuf::Descriptor*, DynamicClass*> cache;
+
+  auto it = cache.find(descriptor);
+  if(it != cache.end()) {
+    return it->second;
+  }
+
+  DynamicClass* clazz;
+  {
+    std::lock_guard<std::mutex> lock(REGISTRY_MUTEX);
+    auto& entry = REGISTRY[descriptor];
+    if(entry == nullptr) {
+      entry = new DynamicClass(descriptor);
+    }
+    clazz = entry;
+  }
+
+  cache[descriptor] = clazz;
+  return clazz;
+
+}
+
 DynamicClass* DynamicClass::registryGetClass(const std::string& name) {
+
+  const google::protobuf::DescriptorPool* pool = google::protobuf::DescriptorPool::generated_pool();
+  const google::protobuf::Descriptor* desc = pool->FindMessageTypeByName(name);
+
+  if(desc == nullptr) {
+    throw std::runtime_error("[oatpp::protobuf::reflection::DynamicClass::registryGetClass()]: "
+                             "Error. Can't find protobuf::Descriptor for name " + name);
+  }
+
+  return registryGetClass(desc);
+
+}
+
+DynamicClass* DynamicClass::registryGetClassByTypeUrl(const std::string& typeUrl) {
+
+  /*
+   * same as registryGetClass(descriptor) - resolved names never change.
+   * Keyed by the type name, not the URL - the URL comes from the client and the cache must stay bounded by the number of known types.
+   */
+  thread_local std::unordered_map<std::string, DynamicClass*> cache;
+
+  /* the type name is everything after the last '/' - the prefix is not checked, same as in protobuf */
+  auto pos = typeUrl.rfind('/');
+  std::string name = pos == std::string::npos ? typeUrl : typeUrl.substr(pos + 1);
+
+  auto it = cache.find(name);
+  if(it != cache.end()) {
+    return it->second;
+  }
+
+  const google::protobuf::DescriptorPool* pool = google::protobuf::DescriptorPool::generated_pool();
+  const google::protobuf::Descriptor* desc = pool->FindMessageTypeByName(name);
+  if(desc == nullptr) {
+    desc = DescriptorSet::registryFindMessageType(name);
+  }
+
+  if(desc == nullptr) {
+    return nullptr;
+  }
+
+  DynamicClass* clazz = registryGetClass(desc);
+  cache[name] = clazz;
+  return clazz;
+
+}
+
+std::vector<Statistics::Snapshot> DynamicClass::registryGetStatistics() {
+
+  std::vector<Statistics::Snapshot> result;
+
   std::lock_guard<std::mutex> lock(REGISTRY_MUTEX);
-  auto it = REGISTRY.find(name);
-  if(it == REGISTRY.end()) {
-    auto clazz = new DynamicClass(name);
-    REGISTRY[name] = clazz;
-    return clazz;
+  for(auto& entry : REGISTRY) {
+    auto snapshot = entry.second->m_statistics.getSnapshot(entry.second->m_name);
+    for(v_int32 i = 0; i < Statistics::DIRECTIONS_COUNT; i ++) {
+      if(snapshot.conversions[i] > 0) {
+        result.push_back(snapshot);
+        break;
+      }
+    }
+  }
+
+  return result;
+
+}
+
+void DynamicClass::registryResetStatistics() {
+  std::lock_guard<std::mutex> lock(REGISTRY_MUTEX);
+  for(auto& entry : REGISTRY) {
+    entry.second->m_statistics.reset();
+  }
+}
+
+void DynamicClass::collectDescriptors(const google::protobuf::Descriptor* descriptor,
+                                      std::unordered_set<const google::protobuf::Descriptor*>& visited,
+                                      std::vector<const google::protobuf::Descriptor*>& result)
+{
+
+  if(!visited.insert(descriptor).second) {
+    return;
+  }
+
+  /* map entries are not converted as objects - only their value types are */
+  if(!descriptor->options().map_entry()) {
+    result.push_back(descriptor);
   }
-  return it->second;
+
+  for(int i = 0; i < descriptor->nested_type_count(); i++) {
+    collectDescriptors(descriptor->nested_type(i), visited, result);
+  }
+
+  for(int i = 0; i < descriptor->field_count(); i++) {
+    auto messageType = descriptor->field(i)->message_type();
+    if(messageType != nullptr) {
+      collectDescriptors(messageType, visited, result);
+    }
+  }
+
+}
+
+void DynamicClass::warmUp() {
+  getFields();
+  static_cast<const PolymorphicDispatcher*>(getType()->polymorphicDispatcher)->getProperties();
+  getVectorType();
+  getFieldsType();
+  getPrototype();
+}
+
+void DynamicClass::registerAll(const std::vector<const google::protobuf::Descriptor*>& descriptors, v_int32 threadsCount) {
+
+  std::unordered_set<const google::protobuf::Descriptor*> visited;
+  std::vector<const google::protobuf::Descriptor*> all;
+  for(auto descriptor : descriptors) {
+    collectDescriptors(descriptor, visited, all);
+  }
+
+  if(threadsCount <= 0) {
+    threadsCount = (v_int32) std::thread::hardware_concurrency();
+  }
+  if(threadsCount > (v_int32) all.size()) {
+    threadsCount = (v_int32) all.size();
+  }
+
+  std::atomic<v_buff_size> next(0);
+  std::mutex errorMutex;
+  std::exception_ptr error;
+
+  auto worker = [&all, &next, &errorMutex, &error]() {
+    try {
+      for(v_buff_size i = next++; i < (v_buff_size) all.size(); i = next++) {
+        registryGetClass(all[i])->warmUp();
+      }
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(errorMutex);
+      if(!error) {
+        error = std::current_exception();
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for(v_int32 i = 1; i < threadsCount; i++) {
+    threads.emplace_back(worker);
+  }
+  worker();
+
+  for(auto& thread : threads) {
+    thread.join();
+  }
+
+  if(error) {
+    std::rethrow_exception(error);
+  }
+
+}
+
+void DynamicClass::registerAll(const google::protobuf::FileDescriptor* file, v_int32 threadsCount) {
+  std::vector<const google::protobuf::Descriptor*> descriptors;
+  for(int i = 0; i < file->message_type_count(); i++) {
+    descriptors.push_back(file->message_type(i));
+  }
+  registerAll(descriptors, threadsCount);
+}
+
+void DynamicClass::registerAll(const std::string& package, v_int32 threadsCount) {
+
+  const google::protobuf::DescriptorPool* pool = google::protobuf::DescriptorPool::generated_pool();
+  google::protobuf::DescriptorDatabase* database = google::protobuf::DescriptorPool::internal_generated_database();
+
+  std::vector<std::string> fileNames;
+  database->FindAllFileNames(&fileNames);
+
+  std::vector<const google::protobuf::Descriptor*> descriptors;
+
+  for(auto& fileName : fileNames) {
+
+    /* check the package of the encoded file first - don't build descriptors of unrelated files */
+    google::protobuf::FileDescriptorProto fileProto;
+    if(!database->FindFileByName(fileName, &fileProto)) {
+      continue;
+    }
+
+    const std::string& filePackage = fileProto.package();
+    if(!package.empty() && filePackage != package &&
+       filePackage.compare(0, package.size() + 1, package + ".") != 0) {
+      continue;
+    }
+
+    auto file = pool->FindFileByName(fileName);
+    for(int i = 0; file != nullptr && i < file->message_type_count(); i++) {
+      descriptors.push_back(file->message_type(i));
+    }
+
+  }
+
+  registerAll(descriptors, threadsCount);
+
 }
 
 const std::string DynamicClass::getName() const {
   return m_name;
 }
 
-std::shared_ptr<Message> DynamicClass::createProto() const {
+const google::protobuf::Descriptor* DynamicClass::getDescriptor() const {
+  return m_descriptor;
+}
 
-  const google::protobuf::DescriptorPool* pool = google::protobuf::DescriptorPool::generated_pool();
-  const google::protobuf::Descriptor* desc = pool->FindMessageTypeByName(m_name);
+const std::string& DynamicClass::getTypeUrl() const {
+  return m_typeUrl;
+}
 
-  if(desc == nullptr) {
-    throw std::runtime_error("[oatpp::protobuf::reflection::DynamicClass::createProto()]: "
-                             "Error. Can't find protobuf::Descriptor for name " + m_name);
+const Message* DynamicClass::getPrototype() const {
+
+  /* factory lookup is a hash lookup by descriptor - resolve once, the prototype lives as long as its factory */
+  const Message* prototype = m_prototype.load(std::memory_order_acquire);
+  if(prototype == nullptr) {
+    auto factory = DescriptorSet::registryGetFactory(m_descriptor->file()->pool());
+    if(factory == nullptr) {
+      throw std::runtime_error("[oatpp::protobuf::reflection::DynamicClass::getPrototype()]: "
+                               "Error. No message factory for the descriptor pool of " + m_name);
+    }
+    prototype = factory->GetPrototype(m_descriptor);
+    m_prototype.store(prototype, std::memory_order_release);
   }
 
-  return std::shared_ptr<google::protobuf::Message>(
-    google::protobuf::MessageFactory::generated_factory()->GetPrototype(desc)->New()
-  );
+  return prototype;
 
 }
 
+std::shared_ptr<Message> DynamicClass::createProto(const std::shared_ptr<google::protobuf::Arena>& arena) const {
+  const Message* prototype = getPrototype();
+  if(arena) {
+    return std::shared_ptr<google::protobuf::Message>(arena, prototype->New(arena.get()));
+  }
+  return std::shared_ptr<google::protobuf::Message>(prototype->New());
+}
+
 const oatpp::Type* DynamicClass::getType() {
+
+  oatpp::Type* type = m_type.load(std::memory_order_acquire);
+  if(type != nullptr) {
+    return type;
+  }
+
   std::lock_guard<std::mutex> lock(m_typeMutex);
-  if(m_type == nullptr) {
-    m_type = new oatpp::Type(
+
+  type = m_type.load(std::memory_order_relaxed);
+  if(type == nullptr) {
+    type = new oatpp::Type(
       oatpp::data::mapping::type::__class::AbstractObject::CLASS_ID,
       m_name.c_str(),
       new PolymorphicDispatcher(this),
       {}
     );
+    m_type.store(type, std::memory_order_release);
+  }
+
+  return type;
+
+}
+
+const oatpp::Type* DynamicClass::getProjectedType(const FieldMask* mask) {
+
+  if(mask == nullptr || mask->isAll()) {
+    return getType();
+  }
+
+  FieldMask::Resolved* resolved = mask->resolve(m_descriptor);
+  oatpp::Type* type = resolved->type.load(std::memory_order_acquire);
+  if(type != nullptr) {
+    return type;
+  }
+
+  type = new oatpp::Type(
+    oatpp::data::mapping::type::__class::AbstractObject::CLASS_ID,
+    m_name.c_str(),
+    new ProjectedPolymorphicDispatcher(this, resolved->fields),
+    {}
+  );
+
+  oatpp::Type* expected = nullptr;
+  if(!resolved->type.compare_exchange_strong(expected, type, std::memory_order_acq_rel, std::memory_order_acquire)) {
+    destroyProjectedType(type);
+    return expected;
+  }
+
+  return type;
+
+}
+
+void DynamicClass::destroyProjectedType(oatpp::Type* type) {
+  if(type != nullptr) {
+    delete static_cast<const ProjectedPolymorphicDispatcher*>(type->polymorphicDispatcher);
+    delete type;
   }
-  return m_type;
 }
 
 const oatpp::Type* DynamicClass::getVectorType() {
+
+  oatpp::Type* type = m_vectorType.load(std::memory_order_acquire);
+  if(type != nullptr) {
+    return type;
+  }
+
   std::lock_guard<std::mutex> lock(m_typeVectorMutex);
-  if(m_vectorType == nullptr) {
-    m_vectorType = new oatpp::Type(
+
+  type = m_vectorType.load(std::memory_order_relaxed);
+  if(type == nullptr) {
+    type = new oatpp::Type(
       oatpp::data::mapping::type::__class::AbstractVector::CLASS_ID,
       nullptr,
       new VectorPolymorphicDispatcher(this)
     );
-    m_vectorType->params.push_back(getType());
+    type->params.push_back(getType());
+    m_vectorType.store(type, std::memory_order_release);
   }
-  return m_vectorType;
-}
 
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-// Dynamic Object
+  return type;
 
-oatpp::Void DynamicObject::protoValueToOatppValue(const Reflection* refl, const FieldDescriptor* field, const Message& proto) {
+}
 
-  switch(field->type()) {
+const oatpp::Type* DynamicClass::getFieldsType() {
 
-    case google::protobuf::FieldDescriptor::TYPE_STRING:
-    case google::protobuf::FieldDescriptor::TYPE_BYTES: return Utils::getProtoField<std::string>(refl, field, proto);
+  oatpp::Type* type = m_fieldsType.load(std::memory_order_acquire);
+  if(type != nullptr) {
+    return type;
+  }
 
-    case google::protobuf::FieldDescriptor::TYPE_INT32:
-    case google::protobuf::FieldDescriptor::TYPE_SINT32:
-    case google::protobuf::FieldDescriptor::TYPE_SFIXED32: return Utils::getProtoField<v_int32>(refl, field, proto);
+  std::lock_guard<std::mutex> lock(m_typeFieldsMutex);
 
-    case google::protobuf::FieldDescriptor::TYPE_UINT32:
-    case google::protobuf::FieldDescriptor::TYPE_FIXED32: return Utils::getProtoField<v_uint32>(refl, field, proto);
+  type = m_fieldsType.load(std::memory_order_relaxed);
+  if(type == nullptr) {
+    type = new oatpp::Type(
+      oatpp::data::mapping::type::__class::AbstractUnorderedMap::CLASS_ID,
+      nullptr,
+      new FieldsPolymorphicDispatcher(this)
+    );
+    type->params.push_back(oatpp::String::Class::getType());
+    type->params.push_back(getType());
+    m_fieldsType.store(type, std::memory_order_release);
+  }
 
-    case google::protobuf::FieldDescriptor::TYPE_INT64:
-    case google::protobuf::FieldDescriptor::TYPE_SINT64:
-    case google::protobuf::FieldDescriptor::TYPE_SFIXED64: return Utils::getProtoField<v_int64>(refl, field, proto);
+  return type;
 
-    case google::protobuf::FieldDescriptor::TYPE_UINT64:
-    case google::protobuf::FieldDescriptor::TYPE_FIXED64: return Utils::getProtoField<v_uint64>(refl, field, proto);
+}
+
+const std::vector<FieldInfo>& DynamicClass::getFields() {
 
-    case google::protobuf::FieldDescriptor::TYPE_FLOAT: return Utils::getProtoField<v_float32>(refl, field, proto);
-    case google::protobuf::FieldDescriptor::TYPE_DOUBLE: return Utils::getProtoField<v_float64>(refl, field, proto);
+  std::vector<FieldInfo>* fields = m_fields.load(std::memory_order_acquire);
+  if(fields != nullptr) {
+    return *fields;
+  }
 
-    case google::protobuf::FieldDescriptor::TYPE_BOOL: return Utils::getProtoField<bool>(refl, field, proto);
+  std::lock_guard<std::mutex> lock(m_fieldsMutex);
 
-    case google::protobuf::FieldDescriptor::TYPE_ENUM: return Utils::getProtoField<EnumDescriptor>(refl, field, proto);
+  fields = m_fields.load(std::memory_order_relaxed);
+  if(fields == nullptr) {
 
-    case google::protobuf::FieldDescriptor::TYPE_MESSAGE: return Utils::getProtoField<Message>(refl, field, proto);
+    fields = new std::vector<FieldInfo>();
+    fields->reserve(m_descriptor->field_count());
+    for(int i = 0; i < m_descriptor->field_count(); i++) {
+      fields->push_back(createFieldInfo(m_descriptor->field(i)));
+    }
 
-    // case google::protobuf::FieldDescriptor::TYPE_GROUP: deprecated
+    m_fields.store(fields, std::memory_order_release);
 
-    default:
-      throw std::runtime_error("[oatpp::protobuf::reflection::DynamicObject::protoValueToOatppValue()]: "
-                               "Error. Unknown type - " + std::string(field->type_name()));
   }
 
+  return *fields;
+
 }
 
-void DynamicObject::OatppValueToProtoValue(const Reflection* refl, const FieldDescriptor* field, Message* proto, int index) const {
+Statistics* DynamicClass::getStatistics() {
+  return &m_statistics;
+}
 
-  const auto& value = m_fields[index];
-  if(!value) return;
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Dynamic Object
 
-  switch(field->type()) {
+std::atomic<v_int32> DynamicObject::POOL_CAPACITY(0);
 
-    case google::protobuf::FieldDescriptor::TYPE_STRING:
-    case google::protobuf::FieldDescriptor::TYPE_BYTES: {
-      Utils::setProtoField<std::string>(refl, field, proto, value);
-      break;
-    }
+DynamicObject::DynamicObject(DynamicClass* clazz)
+  : m_class(clazz)
+  , m_projectedType(nullptr)
+{}
 
-    case google::protobuf::FieldDescriptor::TYPE_INT32:
-    case google::protobuf::FieldDescriptor::TYPE_SINT32:
-    case google::protobuf::FieldDescriptor::TYPE_SFIXED32: {
-      Utils::setProtoField<v_int32>(refl, field, proto, value);
-      break;
-    }
-    case google::protobuf::FieldDescriptor::TYPE_UINT32:
-    case google::protobuf::FieldDescriptor::TYPE_FIXED32: {
-      Utils::setProtoField<v_uint32>(refl, field, proto, value);
-      break;
-    }
+std::shared_ptr<DynamicObject> DynamicObject::allocate(DynamicClass* clazz) {
 
-    case google::protobuf::FieldDescriptor::TYPE_INT64:
-    case google::protobuf::FieldDescriptor::TYPE_SINT64:
-    case google::protobuf::FieldDescriptor::TYPE_SFIXED64: {
-      Utils::setProtoField<v_int64>(refl, field, proto, value);
-      break;
-    }
-    case google::protobuf::FieldDescriptor::TYPE_UINT64:
-    case google::protobuf::FieldDescriptor::TYPE_FIXED64: {
-      Utils::setProtoField<v_uint64>(refl, field, proto, value);
-      break;
+  if(POOL_CAPACITY.load(std::memory_order_relaxed) > 0 && !POOLS_DESTROYED) {
+    auto& pool = getThreadPools().get(clazz->m_poolIndex);
+    if(!pool.empty()) {
+      DynamicObject* object = pool.back();
+      pool.pop_back();
+      return std::shared_ptr<DynamicObject>(object, &DynamicObject::recycle);
     }
+  }
 
-    case google::protobuf::FieldDescriptor::TYPE_FLOAT: {
-      Utils::setProtoField<v_float32>(refl, field, proto, value);
-      break;
-    }
-    case google::protobuf::FieldDescriptor::TYPE_DOUBLE: {
-      Utils::setProtoField<v_float64>(refl, field, proto, value);
-      break;
+  Statistics::onObjectAllocated();
+  return std::shared_ptr<DynamicObject>(new DynamicObject(clazz), &DynamicObject::recycle);
+
+}
+
+void DynamicObject::recycle(DynamicObject* object) {
+
+  v_int32 capacity = POOL_CAPACITY.load(std::memory_order_relaxed);
+  if(capacity > 0 && !POOLS_DESTROYED) {
+
+    /* release field values first - nested objects are recycled by the same thread and may grow the pools */
+    object->m_fields.clear();
+    object->m_source.reset();
+    object->m_materialized.clear();
+    object->m_mask.reset();
+    object->m_projectedType = nullptr;
+
+    auto& pool = getThreadPools().get(object->m_class->m_poolIndex);
+    if(pool.size() < (size_t) capacity) {
+      pool.push_back(object);
+      return;
     }
 
-    case google::protobuf::FieldDescriptor::TYPE_BOOL: {
-      Utils::setProtoField<bool>(refl, field, proto, value);
-      break;
+  }
+
+  delete object;
+
+}
+
+void DynamicObject::setPoolCapacity(v_int32 capacity) {
+  POOL_CAPACITY.store(capacity > 0 ? capacity : 0, std::memory_order_relaxed);
+}
+
+v_int32 DynamicObject::getPoolCapacity() {
+  return POOL_CAPACITY.load(std::memory_order_relaxed);
+}
+
+void DynamicObject::clearPool() {
+  if(!POOLS_DESTROYED) {
+    getThreadPools().clear();
+  }
+}
+
+void DynamicObject::initEmpty() {
+  const auto& fields = m_class->getFields();
+  m_fields.reserve(fields.size());
+  for(const auto& field : fields) {
+    m_fields.push_back(oatpp::Void(nullptr, field.type));
+  }
+  setBasePointer(m_fields.data());
+}
+
+void DynamicObject::initFromProto(const google::protobuf::Message& proto,
+                                  const std::shared_ptr<const google::protobuf::Message>& owner)
+{
+  const google::protobuf::Reflection* refl = proto.GetReflection();
+  const auto& fields = m_class->getFields();
+  m_fields.reserve(fields.size());
+  for(const auto& field : fields) {
+    m_fields.push_back(field.getter(refl, proto, field, owner));
+  }
+  setBasePointer(m_fields.data());
+  Statistics::onFieldsVisited(fields.size());
+}
+
+void DynamicObject::initFromProto(const google::protobuf::Message& proto,
+                                  const std::shared_ptr<const google::protobuf::Message>& owner,
+                                  const std::shared_ptr<const FieldMask>& mask)
+{
+  const google::protobuf::Reflection* refl = proto.GetReflection();
+  const auto& fields = m_class->getFields();
+  const auto& selection = mask->select(m_class->getDescriptor());
+  initEmpty();
+  m_mask = mask;
+  m_projectedType = m_class->getProjectedType(mask.get());
+  for(const auto& selected : selection) {
+    /* sub-masks are owned by the root mask */
+    std::shared_ptr<const FieldMask> subMask;
+    if(selected.mask != nullptr) {
+      subMask = std::shared_ptr<const FieldMask>(mask, selected.mask);
     }
+    m_fields[selected.index] = getProjectedField(refl, proto, fields[selected.index], owner, subMask);
+  }
+  Statistics::onFieldsVisited(selection.size());
+}
 
-    case google::protobuf::FieldDescriptor::TYPE_ENUM: {
-      Utils::setProtoField<EnumDescriptor>(refl, field, proto, value);
-      break;
+oatpp::Void DynamicObject::getProjectedField(const google::protobuf::Reflection* refl,
+                                             const google::protobuf::Message& proto,
+                                             const FieldInfo& info,
+                                             const std::shared_ptr<const google::protobuf::Message>& owner,
+                                             const std::shared_ptr<const FieldMask>& mask)
+{
+
+  /* only plain nested messages are narrowed - well-known types and other fields are converted as a whole */
+  const FieldInfo& valueInfo = info.mapValue ? *info.mapValue : info;
+  if(mask == nullptr || valueInfo.nestedClass == nullptr || valueInfo.wellKnownType != WellKnownType::NONE) {
+    return info.getter(refl, proto, info, owner);
+  }
+
+  if(info.mapValue) {
+    oatpp::UnorderedFields<AbstractDynamicObject> map(std::make_shared<std::unordered_map<oatpp::String, AbstractDynamicObject>>(), info.type);
+    int size = refl->FieldSize(proto, info.descriptor);
+    map->reserve(size);
+    for(int i = 0; i < size; i++) {
+      const google::protobuf::Message& entry = refl->GetRepeatedMessage(proto, info.descriptor, i);
+      const google::protobuf::Reflection* entryRefl = entry.GetReflection();
+      const google::protobuf::Message& value = entryRefl->GetMessage(entry, valueInfo.descriptor);
+      auto object = createShared(valueInfo.nestedClass, value, owner, mask);
+      (*map)[Utils::getMapKey(entryRefl, entry, info.mapKey, owner)] = AbstractDynamicObject(object, object->getObjectType());
     }
+    return map;
+  }
 
-    case google::protobuf::FieldDescriptor::TYPE_MESSAGE: {
-      Utils::setProtoField<Message>(refl, field, proto, value);
-      break;
+  if(info.descriptor->is_repeated()) {
+    oatpp::Vector<AbstractDynamicObject> arr(std::make_shared<std::vector<AbstractDynamicObject>>(), info.type);
+    int size = refl->FieldSize(proto, info.descriptor);
+    arr->reserve(size);
+    for(int i = 0; i < size; i++) {
+      const google::protobuf::Message& item = refl->GetRepeatedMessage(proto, info.descriptor, i);
+      auto object = createShared(info.nestedClass, item, owner, mask);
+      arr->push_back(AbstractDynamicObject(object, object->getObjectType()));
     }
+    return arr;
+  }
 
-    // case google::protobuf::FieldDescriptor::TYPE_GROUP: deprecated
+  if(refl->HasField(proto, info.descriptor)) {
+    auto object = createShared(info.nestedClass, refl->GetMessage(proto, info.descriptor), owner, mask);
+    return AbstractDynamicObject(object, object->getObjectType());
+  }
 
-    default:
-      throw std::runtime_error("[oatpp::protobuf::reflection::DynamicObject::protoValueToOatppValue()]: "
-                               "Error. Unknown type - " + std::string(field->type_name()));
+  return oatpp::Void(nullptr, info.type);
+
+}
+
+void DynamicObject::initLazy(const std::shared_ptr<const google::protobuf::Message>& proto) {
+  initEmpty();
+  m_source = proto;
+  m_materialized.resize(m_fields.size(), false);
+}
+
+v_uint32 DynamicObject::getFieldIndex(const std::string& name) const {
+  auto field = m_class->getDescriptor()->FindFieldByName(name);
+  if(field == nullptr) {
+    throw std::runtime_error("[oatpp::protobuf::reflection::DynamicObject::getFieldIndex()]: Error. "
+                             "No such field '" + name + "' in " + m_class->getName());
   }
+  return field->index();
+}
 
+std::shared_ptr<DynamicObject> DynamicObject::createShared(const google::protobuf::Message& proto) {
+  return createShared(DynamicClass::registryGetClass(proto.GetDescriptor()), proto);
 }
 
-DynamicObject::DynamicObject(DynamicClass* clazz)
-  : m_class(clazz)
-{}
+std::shared_ptr<DynamicObject> DynamicObject::createShared(DynamicClass* clazz, const google::protobuf::Message& proto) {
+  return createShared(clazz, proto, nullptr);
+}
 
-void DynamicObject::initFromProto(const google::protobuf::Message& proto) {
+std::shared_ptr<DynamicObject> DynamicObject::createShared(const std::shared_ptr<const google::protobuf::Message>& proto) {
+  return createShared(DynamicClass::registryGetClass(proto->GetDescriptor()), *proto, proto);
+}
 
-  const google::protobuf::Descriptor* desc = proto.GetDescriptor();
-  const google::protobuf::Reflection* refl = proto.GetReflection();
+std::shared_ptr<DynamicObject> DynamicObject::createShared(DynamicClass* clazz,
+                                                           const google::protobuf::Message& proto,
+                                                           const std::shared_ptr<const google::protobuf::Message>& owner)
+{
+  Statistics::Tracker tracker(clazz->getStatistics(), Statistics::PROTO_TO_OBJECT);
+  auto ptr = allocate(clazz);
+  ptr->initFromProto(proto, owner);
+  return ptr;
+}
+
+std::shared_ptr<DynamicObject> DynamicObject::createShared(DynamicClass* clazz,
+                                                           const google::protobuf::Message& proto,
+                                                           const std::shared_ptr<const google::protobuf::Message>& owner,
+                                                           const std::shared_ptr<const FieldMask>& mask)
+{
+  if(mask == nullptr || mask->isAll()) {
+    return createShared(clazz, proto, owner);
+  }
+  Statistics::Tracker tracker(clazz->getStatistics(), Statistics::PROTO_TO_OBJECT);
+  auto ptr = allocate(clazz);
+  ptr->initFromProto(proto, owner, mask);
+  return ptr;
+}
+
+std::shared_ptr<DynamicObject> DynamicObject::createLazy(const std::shared_ptr<const google::protobuf::Message>& proto) {
+  return createLazy(DynamicClass::registryGetClass(proto->GetDescriptor()), proto);
+}
+
+std::shared_ptr<DynamicObject> DynamicObject::createLazy(DynamicClass* clazz, const std::shared_ptr<const google::protobuf::Message>& proto) {
+  Statistics::Tracker tracker(clazz->getStatistics(), Statistics::PROTO_TO_OBJECT);
+  auto ptr = allocate(clazz);
+  ptr->initLazy(proto);
+  return ptr;
+}
+
+const oatpp::Void& DynamicObject::getField(v_uint32 index) {
+
+  if(m_source && !m_materialized[index]) {
 
-  int fieldCount = desc->field_count();
+    /* the object is counted as converted already - account the field only */
+    Statistics::Tracker tracker(m_class->getStatistics(), Statistics::PROTO_TO_OBJECT, false);
+    Statistics::onFieldsVisited(1);
+
+    const auto& info = m_class->getFields()[index];
+    const google::protobuf::Reflection* refl = m_source->GetReflection();
+
+    if(info.nestedClass && info.wellKnownType == WellKnownType::NONE && !info.descriptor->is_repeated()) {
+      if(refl->HasField(*m_source, info.descriptor)) {
+        /* nested message is owned by the source - share ownership of the source */
+        std::shared_ptr<const google::protobuf::Message> nested(m_source, &refl->GetMessage(*m_source, info.descriptor));
+        m_fields[index] = oatpp::Void(createLazy(info.nestedClass, nested), info.type);
+      }
+    } else {
+      m_fields[index] = info.getter(refl, *m_source, info, m_source);
+    }
+
+    m_materialized[index] = true;
 
-  for(int i = 0; i < fieldCount; i++) {
-    const google::protobuf::FieldDescriptor* field = desc->field(i);
-    m_fields.push_back(protoValueToOatppValue(refl, field, proto));
   }
 
-  setBasePointer(m_fields.data());
+  return m_fields[index];
 
 }
 
-std::shared_ptr<DynamicObject> DynamicObject::createShared(const google::protobuf::Message& proto) {
-  const google::protobuf::Descriptor* desc = proto.GetDescriptor();
-  auto clazz = DynamicClass::registryGetClass(desc->full_name());
-  auto ptr = std::shared_ptr<DynamicObject>(new DynamicObject(clazz));
-  ptr->initFromProto(proto);
-  return ptr;
+const oatpp::Void& DynamicObject::getField(const std::string& name) {
+  return getField(getFieldIndex(name));
+}
+
+void DynamicObject::setField(v_uint32 index, const oatpp::Void& value) {
+  m_fields[index] = value;
+  if(m_source) {
+    m_materialized[index] = true;
+  }
+}
+
+void DynamicObject::setField(const std::string& name, const oatpp::Void& value) {
+  setField(getFieldIndex(name), value);
+}
+
+void DynamicObject::materialize() {
+  if(m_source) {
+    const auto& fields = m_class->getFields();
+    for(v_uint32 i = 0; i < m_fields.size(); i++) {
+      const auto& value = getField(i);
+      if(value && fields[i].nestedClass && fields[i].wellKnownType == WellKnownType::NONE && !fields[i].descriptor->is_repeated()) {
+        static_cast<DynamicObject*>(value.get())->materialize();
+      }
+    }
+  }
+}
+
+const oatpp::Type* DynamicObject::getObjectType() const {
+  return m_projectedType != nullptr ? m_projectedType : m_class->getType();
+}
+
+bool DynamicObject::isLazy() const {
+  return m_source != nullptr;
 }
 
 void DynamicObject::cloneToProto(google::protobuf::Message& proto) const {
 
-  const google::protobuf::Descriptor* desc = proto.GetDescriptor();
-  const google::protobuf::Reflection* refl = proto.GetReflection();
+  Statistics::Tracker tracker(m_class->getStatistics(), Statistics::OBJECT_TO_PROTO);
 
-  int fieldCount = desc->field_count();
+  const google::protobuf::Reflection* refl = proto.GetReflection();
+  const auto& fields = m_class->getFields();
 
-  if(fieldCount != m_fields.size()) {
+  if(fields.size() != m_fields.size()) {
     throw std::runtime_error("[oatpp::protobuf::reflection::DynamicObject::toProto()]: Error."
                              "Invalid state.");
   }
 
-  for(int i = 0; i < fieldCount; i++) {
-    const google::protobuf::FieldDescriptor* field = desc->field(i);
-    OatppValueToProtoValue(refl, field, &proto, i);
+  /* lazy object - fields which were never accessed are copied from the source as is */
+  if(m_source) {
+    proto.CopyFrom(*m_source);
+  }
+
+  for(v_uint32 i = 0; i < fields.size(); i++) {
+    if(m_source) {
+      if(!m_materialized[i]) {
+        continue;
+      }
+      refl->ClearField(&proto, fields[i].descriptor);
+    }
+    Statistics::onFieldsVisited(1);
+    const auto& value = m_fields[i];
+    if(value) {
+      fields[i].setter(refl, &proto, fields[i], value);
+    }
   }
 
 }
 
-std::shared_ptr<google::protobuf::Message> DynamicObject::toProto() const {
-  auto proto = m_class->createProto();
+std::shared_ptr<google::protobuf::Message> DynamicObject::toProto(const std::shared_ptr<google::protobuf::Arena>& arena) const {
+  auto proto = m_class->createProto(arena);
   cloneToProto(*proto);
   return proto;
 }
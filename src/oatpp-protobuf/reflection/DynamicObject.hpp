@@ -25,8 +25,11 @@
 #ifndef oatpp_protobuf_reflection_DynamicObject_hpp
 #define oatpp_protobuf_reflection_DynamicObject_hpp
 
+#include "FieldMask.hpp"
 #include "Utils.hpp"
 
+#include <unordered_set>
+
 namespace oatpp { namespace protobuf { namespace reflection {
 
 class DynamicObject; // FWD
@@ -36,9 +39,11 @@ class DynamicObject; // FWD
  */
 class DynamicClass {
   friend DynamicObject;
+  friend FieldMask;
 private:
   static std::mutex REGISTRY_MUTEX;
-  static std::unordered_map<std::string, DynamicClass*> REGISTRY;
+  static std::unordered_map<const google::protobuf::Descriptor*, DynamicClass*> REGISTRY;
+  static std::atomic<v_uint32> CLASSES_COUNT;
 public:
 
   /**
@@ -55,6 +60,22 @@ public:
     const oatpp::data::mapping::type::BaseObject::Properties* getProperties() const override;
   };
 
+public:
+
+  /**
+   * Polymorphic Dispatcher of projected objects - properties are the fields selected by the mask only.
+   * See &l:DynamicClass::getProjectedType ();.
+   */
+  class ProjectedPolymorphicDispatcher : public PolymorphicDispatcher {
+  private:
+    oatpp::data::mapping::type::BaseObject::Properties m_properties;
+  public:
+
+    ProjectedPolymorphicDispatcher(DynamicClass* clazz, const std::vector<FieldMask::Selection>& selection);
+
+    const oatpp::data::mapping::type::BaseObject::Properties* getProperties() const override;
+  };
+
 public:
 
   /**
@@ -72,24 +93,118 @@ public:
 
   };
 
+public:
+
+  /**
+   * Fields Polymorphic Dispatcher - for `oatpp::UnorderedFields<This-Class>`.
+   */
+  class FieldsPolymorphicDispatcher : public oatpp::data::mapping::type::__class::AbstractUnorderedMap::PolymorphicDispatcher {
+  private:
+    DynamicClass* m_class;
+  public:
+
+    FieldsPolymorphicDispatcher(DynamicClass* clazz);
+
+    oatpp::Void createObject() const override;
+    void addPolymorphicItem(const oatpp::Void& object, const oatpp::Void& key, const oatpp::Void& value) const override;
+
+  };
+
 private:
   std::mutex m_typeMutex;
   std::mutex m_typeVectorMutex;
+  std::mutex m_typeFieldsMutex;
+  std::mutex m_fieldsMutex;
+  const google::protobuf::Descriptor* m_descriptor;
   std::string m_name;
-  oatpp::Type* m_type;
-  oatpp::data::mapping::type::BaseObject::Properties* m_properties;
-  oatpp::Type* m_vectorType;
+  std::string m_typeUrl;
+  std::atomic<oatpp::Type*> m_type;
+  std::atomic<oatpp::data::mapping::type::BaseObject::Properties*> m_properties;
+  std::atomic<oatpp::Type*> m_vectorType;
+  std::atomic<oatpp::Type*> m_fieldsType;
+  std::atomic<std::vector<FieldInfo>*> m_fields;
+  mutable std::atomic<const Message*> m_prototype;
+  Statistics m_statistics;
+  const v_uint32 m_poolIndex;
 private:
-  DynamicClass(const std::string& name);
+  DynamicClass(const google::protobuf::Descriptor* descriptor);
+  static FieldInfo createFieldInfo(const FieldDescriptor* field);
+  static FieldInfo createMapFieldInfo(const FieldDescriptor* field);
+  static void collectDescriptors(const google::protobuf::Descriptor* descriptor,
+                                 std::unordered_set<const google::protobuf::Descriptor*>& visited,
+                                 std::vector<const google::protobuf::Descriptor*>& result);
+  const Message* getPrototype() const;
+  void warmUp();
+  static void destroyProjectedType(oatpp::Type* type);
 public:
 
   /**
-   * Get class by name of the proto object type.
+   * Get class by descriptor of the proto object type. <br>
+   * Lookups are served from a per-thread cache and take the registry lock only the first time
+   * the descriptor is seen by the calling thread.
+   * @param descriptor
+   * @return
+   */
+  static DynamicClass* registryGetClass(const google::protobuf::Descriptor* descriptor);
+
+  /**
+   * Get class by name of the proto object type. <br>
+   * The name is resolved in the generated descriptor pool - prefer lookup by descriptor when possible.
+   * For types loaded at runtime use &id:oatpp::protobuf::reflection::DescriptorSet::getClass;.
    * @param name
    * @return
    */
   static DynamicClass* registryGetClass(const std::string& name);
 
+  /**
+   * Get class by type URL of `google.protobuf.Any` - `type.googleapis.com/package.Message`. <br>
+   * The URL prefix is not checked. Resolved type names are cached per thread - the descriptor pools (generated, then loaded
+   * &id:oatpp::protobuf::reflection::DescriptorSet;s) are searched only the first time the type is seen by the calling thread.
+   * Unknown types are not cached.
+   * @param typeUrl
+   * @return - class or `nullptr` if there is no such type.
+   */
+  static DynamicClass* registryGetClassByTypeUrl(const std::string& typeUrl);
+
+  /**
+   * Get snapshots of &id:oatpp::protobuf::reflection::Statistics; of all registered classes
+   * which have at least one conversion recorded. <br>
+   * Statistics are collected only when enabled via &id:oatpp::protobuf::reflection::Statistics::setEnabled;.
+   * @return - `std::vector` of &id:oatpp::protobuf::reflection::Statistics::Snapshot;.
+   */
+  static std::vector<Statistics::Snapshot> registryGetStatistics();
+
+  /**
+   * Reset &id:oatpp::protobuf::reflection::Statistics; of all registered classes.
+   */
+  static void registryResetStatistics();
+
+  /**
+   * Build classes eagerly - to be called at startup. <br>
+   * For each message type, its nested types and message types of its fields (transitively) the class is registered
+   * and its conversion plan, &id:oatpp::Type;s, property table and proto prototype are built. Once built, they are
+   * served without locks. <br>
+   * Classes are built in parallel.
+   * @param descriptors - message types.
+   * @param threadsCount - number of threads. `0` - `std::thread::hardware_concurrency()`.
+   */
+  static void registerAll(const std::vector<const google::protobuf::Descriptor*>& descriptors, v_int32 threadsCount = 0);
+
+  /**
+   * Build classes of all message types of the proto file eagerly. See &l:DynamicClass::registerAll ();.
+   * @param file - proto file.
+   * @param threadsCount - number of threads. `0` - `std::thread::hardware_concurrency()`.
+   */
+  static void registerAll(const google::protobuf::FileDescriptor* file, v_int32 threadsCount = 0);
+
+  /**
+   * Build classes of all message types of the package (and its sub-packages) of the generated pool eagerly.
+   * See &l:DynamicClass::registerAll ();.
+   * @param package - package name. Empty string - all generated proto files.
+   * @param threadsCount - number of threads. `0` - `std::thread::hardware_concurrency()`.
+   */
+  static void registerAll(const std::string& package, v_int32 threadsCount = 0);
+
   /**
    * Get class for proto object type.
    * @tparam T
@@ -97,8 +212,7 @@ public:
    */
   template<class T>
   static DynamicClass* registryGetClass() {
-    const google::protobuf::Descriptor* desc = T::GetDescriptor();
-    return registryGetClass(desc->full_name());
+    return registryGetClass(T::GetDescriptor());
   }
 
   /**
@@ -108,10 +222,25 @@ public:
   const std::string getName() const;
 
   /**
-   * Instantiate shared proto object.
+   * Get descriptor of the proto object type.
    * @return
    */
-  std::shared_ptr<Message> createProto() const;
+  const google::protobuf::Descriptor* getDescriptor() const;
+
+  /**
+   * Get type URL of this class for `google.protobuf.Any` - `type.googleapis.com/package.Message`.
+   * @return
+   */
+  const std::string& getTypeUrl() const;
+
+  /**
+   * Instantiate shared proto object. <br>
+   * Generated message for types of the generated pool, `google::protobuf::DynamicMessage` for types
+   * of a loaded &id:oatpp::protobuf::reflection::DescriptorSet;. The prototype is resolved once per class.
+   * @param arena - if not `nullptr` - proto object is created on the arena and holds shared ownership of it.
+   * @return
+   */
+  std::shared_ptr<Message> createProto(const std::shared_ptr<google::protobuf::Arena>& arena = nullptr) const;
 
   /**
    * Get &id:oatpp::Type; of this class.
@@ -119,28 +248,72 @@ public:
    */
   const oatpp::Type* getType();
 
+  /**
+   * Get &id:oatpp::Type; of objects of this class projected by the mask. <br>
+   * Its properties are the selected fields only - the generic serializer doesn't see masked-out fields at all,
+   * regardless of `includeNullFields`. The type is built once per mask and class and is owned by the mask.
+   * @param mask - &id:oatpp::protobuf::reflection::FieldMask;. `nullptr` - all fields.
+   * @return - &l:DynamicClass::getType (); if the mask selects all fields.
+   */
+  const oatpp::Type* getProjectedType(const FieldMask* mask);
+
   /**
    * Get &id:oatpp::Type; of `oatpp::Vector<This-Class>`
    * @return
    */
   const oatpp::Type* getVectorType();
 
+  /**
+   * Get &id:oatpp::Type; of `oatpp::UnorderedFields<This-Class>`. Type of map fields with values of this class.
+   * @return
+   */
+  const oatpp::Type* getFieldsType();
+
+  /**
+   * Get conversion plan of this class - &id:oatpp::protobuf::reflection::FieldInfo; for each field of the proto
+   * object in the order of declaration. <br>
+   * The plan is built once on the first call.
+   * @return
+   */
+  const std::vector<FieldInfo>& getFields();
+
+  /**
+   * Get conversion counters of this class.
+   * @return - &id:oatpp::protobuf::reflection::Statistics;.
+   */
+  Statistics* getStatistics();
+
 };
 
 /**
- * A dynamic oatpp object that will be created from the proto object.
+ * A dynamic oatpp object that will be created from the proto object. <br>
+ * A lazy object (see &l:DynamicObject::createLazy ();) keeps a reference to the source proto object and converts
+ * each field on the first access via &l:DynamicObject::getField ();.
  */
 class DynamicObject : public oatpp::BaseObject {
   friend DynamicClass;
 private:
-  static oatpp::Void protoValueToOatppValue(const Reflection* refl, const FieldDescriptor* field, const Message& proto);
-  void OatppValueToProtoValue(const Reflection* refl, const FieldDescriptor* field, Message* proto, int index) const;
+  static std::atomic<v_int32> POOL_CAPACITY;
 private:
   DynamicClass* m_class;
   std::vector<oatpp::Void> m_fields;
+  std::shared_ptr<const Message> m_source;
+  std::vector<bool> m_materialized;
+  std::shared_ptr<const FieldMask> m_mask;
+  const oatpp::Type* m_projectedType;
 private:
   DynamicObject(DynamicClass* clazz);
-  void initFromProto(const Message& proto);
+  static std::shared_ptr<DynamicObject> allocate(DynamicClass* clazz);
+  static void recycle(DynamicObject* object);
+  void initEmpty();
+  void initFromProto(const Message& proto, const std::shared_ptr<const Message>& owner);
+  void initFromProto(const Message& proto, const std::shared_ptr<const Message>& owner,
+                     const std::shared_ptr<const FieldMask>& mask);
+  static oatpp::Void getProjectedField(const Reflection* refl, const Message& proto, const FieldInfo& info,
+                                       const std::shared_ptr<const Message>& owner,
+                                       const std::shared_ptr<const FieldMask>& mask);
+  void initLazy(const std::shared_ptr<const Message>& proto);
+  v_uint32 getFieldIndex(const std::string& name) const;
 public:
 
   /**
@@ -150,8 +323,120 @@ public:
    */
   static std::shared_ptr<DynamicObject> createShared(const Message& proto);
 
+  /**
+   * Create shared when the class of the proto object is already known.
+   * @param clazz - class of the proto object.
+   * @param proto
+   * @return
+   */
+  static std::shared_ptr<DynamicObject> createShared(DynamicClass* clazz, const Message& proto);
+
+  /**
+   * Create shared. String and bytes fields share memory with the proto object instead of being copied. <br>
+   * The proto object is kept alive as long as any of these strings is alive and it must not be modified meanwhile.
+   * @param proto
+   * @return
+   */
+  static std::shared_ptr<DynamicObject> createShared(const std::shared_ptr<const Message>& proto);
+
+  /**
+   * Create shared when the class of the proto object is already known.
+   * @param clazz - class of the proto object.
+   * @param proto - proto object or nested proto object owned by `owner`.
+   * @param owner - keeps `proto` alive. If not `nullptr` - string and bytes fields share memory with `proto`,
+   * else - they are copied.
+   * @return
+   */
+  static std::shared_ptr<DynamicObject> createShared(DynamicClass* clazz,
+                                                     const Message& proto,
+                                                     const std::shared_ptr<const Message>& owner);
+
+  /**
+   * Create shared with only the fields selected by the mask converted. <br>
+   * Nested messages (singular, repeated and map values) are projected by the sub-masks of their fields. <br>
+   * Projected objects are of the projected type - see &l:DynamicObject::getObjectType ();. Masked-out fields are not
+   * properties of that type and are never written by the generic serializer. The object keeps the mask alive.
+   * @param clazz - class of the proto object.
+   * @param proto - proto object or nested proto object owned by `owner`.
+   * @param owner - keeps `proto` alive. See &l:DynamicObject::createShared ();.
+   * @param mask - &id:oatpp::protobuf::reflection::FieldMask;. `nullptr` - all fields.
+   * @return
+   */
+  static std::shared_ptr<DynamicObject> createShared(DynamicClass* clazz,
+                                                     const Message& proto,
+                                                     const std::shared_ptr<const Message>& owner,
+                                                     const std::shared_ptr<const FieldMask>& mask);
+
+  /**
+   * Create lazy object. No fields are converted upfront. <br>
+   * Fields are converted on the first access via &l:DynamicObject::getField ();.
+   * Singular nested messages are lazy objects as well. String and bytes fields share memory with the source. <br>
+   * Fields which are not accessed yet are seen as `null` by the plain property access -
+   * call &l:DynamicObject::materialize (); before passing the object to the generic serializer. <br>
+   * *Lazy object is not thread-safe.*
+   * @param proto - source proto object. Kept alive by the object.
+   * @return
+   */
+  static std::shared_ptr<DynamicObject> createLazy(const std::shared_ptr<const Message>& proto);
+
+  /**
+   * Create lazy object when the class of the proto object is already known.
+   * @param clazz - class of the proto object.
+   * @param proto - source proto object. Kept alive by the object.
+   * @return
+   */
+  static std::shared_ptr<DynamicObject> createLazy(DynamicClass* clazz, const std::shared_ptr<const Message>& proto);
+
+  /**
+   * Get field value. Converts field of the lazy object on the first access.
+   * @param index - field index in the order of declaration.
+   * @return
+   */
+  const oatpp::Void& getField(v_uint32 index);
+
+  /**
+   * Get field value. Converts field of the lazy object on the first access.
+   * @param name - field name.
+   * @return
+   * @throws - `std::runtime_error` if there is no such field.
+   */
+  const oatpp::Void& getField(const std::string& name);
+
+  /**
+   * Set field value.
+   * @param index - field index in the order of declaration.
+   * @param value
+   */
+  void setField(v_uint32 index, const oatpp::Void& value);
+
+  /**
+   * Set field value.
+   * @param name - field name.
+   * @param value
+   * @throws - `std::runtime_error` if there is no such field.
+   */
+  void setField(const std::string& name, const oatpp::Void& value);
+
+  /**
+   * Convert all fields of the lazy object which are not converted yet.
+   * Nested lazy objects are materialized as well.
+   */
+  void materialize();
+
+  /**
+   * Get &id:oatpp::Type; to wrap this object with.
+   * @return - projected type if the object was created with a mask. See &l:DynamicClass::getProjectedType ();.
+   */
+  const oatpp::Type* getObjectType() const;
+
+  /**
+   * Check if the object is lazy.
+   * @return
+   */
+  bool isLazy() const;
+
   void cloneToProto(Message& proto) const;
-  std::shared_ptr<Message> toProto() const;
+  std::shared_ptr<Message> toProto(const std::shared_ptr<google::protobuf::Arena>& arena = nullptr) const;
 
   /**
    * Get a &l:DynamicClass; of this object.
@@ -159,6 +444,29 @@ public:
    */
   DynamicClass* getClass() const;
 
+  /**
+   * Enable recycling of released objects. <br>
+   * Each thread keeps a free list of up to `capacity` objects per &l:DynamicClass;. An object released on the thread
+   * is cleared and put to the list instead of being deleted - its field vector keeps its memory, and the next object
+   * of the class created on the thread is taken from the list. <br>
+   * Pooled objects hold no field values and no reference to the source proto object. <br>
+   * Disabled by default.
+   * @param capacity - max number of free objects per class per thread. `0` - disable.
+   */
+  static void setPoolCapacity(v_int32 capacity);
+
+  /**
+   * Get max number of free objects per class per thread. See &l:DynamicObject::setPoolCapacity ();.
+   * @return
+   */
+  static v_int32 getPoolCapacity();
+
+  /**
+   * Delete free objects pooled by the calling thread. <br>
+   * Pools of a thread are deleted automatically when the thread exits.
+   */
+  static void clearPool();
+
 };
 
 typedef oatpp::data::mapping::type::ObjectWrapper<DynamicObject, oatpp::Void::Class> AbstractDynamicObject;
@@ -169,36 +477,42 @@ struct TypeHelper <Message> {
   typedef Message CT;
   typedef AbstractDynamicObject StaticType;
 
-  static void setFieldValue(const Reflection* refl, const FieldDescriptor* field, Message* proto, const StaticType& value) {
+  static void setFieldValue(const Reflection* refl, const FieldInfo& info, Message* proto, const StaticType& value) {
     DynamicObject* obj = static_cast<DynamicObject*>(value.get());
-    auto message = refl->MutableMessage(proto, field);
+    auto message = refl->MutableMessage(proto, info.descriptor);
     obj->cloneToProto(*message);
   }
 
-  static StaticType getFieldValue(const Reflection* refl, const FieldDescriptor* field, const Message& proto) {
-    auto ptr = DynamicObject::createShared(refl->GetMessage(proto, field));
-    return StaticType(ptr, ptr->getClass()->getType());
+  static StaticType getFieldValue(const Reflection* refl, const FieldInfo& info, const Message& proto,
+                                  const std::shared_ptr<const Message>& owner)
+  {
+    auto ptr = DynamicObject::createShared(info.nestedClass, refl->GetMessage(proto, info.descriptor), owner);
+    return StaticType(ptr, info.type);
   }
 
-  static void addArrayItem(const Reflection* refl, const FieldDescriptor* field, Message* proto, const StaticType& value) {
+  static void addArrayItem(const Reflection* refl, const FieldInfo& info, Message* proto, const StaticType& value) {
     DynamicObject* obj = static_cast<DynamicObject*>(value.get());
-    auto message = refl->AddMessage(proto, field);
+    auto message = refl->AddMessage(proto, info.descriptor);
     obj->cloneToProto(*message);
   }
 
-  static StaticType getArrayItem(const Reflection* refl, const FieldDescriptor* field, const Message& proto, int index) {
-    auto ptr = DynamicObject::createShared(refl->GetRepeatedMessage(proto, field, index));
-    return StaticType(ptr, ptr->getClass()->getType());
+  static StaticType getArrayItem(const Reflection* refl, const FieldInfo& info, const Message& proto, int index,
+                                 const std::shared_ptr<const Message>& owner)
+  {
+    auto ptr = DynamicObject::createShared(info.nestedClass, refl->GetRepeatedMessage(proto, info.descriptor, index), owner);
+    return StaticType(ptr, info.type->params[0]);
   }
 
   static const oatpp::Type* getDynamicType(const FieldDescriptor* field) {
-    auto className = field->message_type()->full_name();
-    return DynamicClass::registryGetClass(className)->getType();
+    return DynamicClass::registryGetClass(field->message_type())->getType();
   }
 
   static const oatpp::Type* getDynamicVectorType(const FieldDescriptor* field) {
-    auto className = field->message_type()->full_name();
-    return DynamicClass::registryGetClass(className)->getVectorType();
+    return DynamicClass::registryGetClass(field->message_type())->getVectorType();
+  }
+
+  static const oatpp::Type* getDynamicFieldsType(const FieldDescriptor* field) {
+    return DynamicClass::registryGetClass(field->message_type())->getFieldsType();
   }
 
 };
@@ -0,0 +1,200 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#include "EnumTable.hpp"
+#include "Statistics.hpp"
+
+#include "oatpp/core/utils/ConversionUtils.hpp"
+
+#include <limits>
+
+namespace oatpp { namespace protobuf { namespace reflection {
+
+std::size_t EnumTable::KeyHash::operator()(const Key& key) const {
+  /* FNV-1a */
+  std::size_t hash = 2166136261U;
+  for(v_buff_size i = 0; i < key.size; i ++) {
+    hash = (hash ^ (v_uint8) key.data[i]) * 16777619U;
+  }
+  return hash;
+}
+
+std::mutex EnumTable::REGISTRY_MUTEX;
+std::unordered_map<const google::protobuf::EnumDescriptor*, EnumTable*> EnumTable::REGISTRY;
+
+EnumTable::EnumTable(const google::protobuf::EnumDescriptor* descriptor)
+  : m_descriptor(descriptor)
+  , m_closed(descriptor->file()->syntax() != google::protobuf::FileDescriptor::SYNTAX_PROTO3)
+  , m_minNumber(0)
+{
+
+  int count = descriptor->value_count();
+
+  int minNumber = 0;
+  int maxNumber = 0;
+  for(int i = 0; i < count; i ++) {
+    int number = descriptor->value(i)->number();
+    if(i == 0 || number < minNumber) minNumber = number;
+    if(i == 0 || number > maxNumber) maxNumber = number;
+  }
+
+  /* numbers are usually sequential - index them directly unless the range is too sparse */
+  bool dense = (v_int64) maxNumber - (v_int64) minNumber < 2 * (v_int64) count + 16;
+  if(dense) {
+    m_minNumber = minNumber;
+    m_denseIndex.resize(count > 0 ? maxNumber - minNumber + 1 : 0, -1);
+  }
+
+  for(int i = 0; i < count; i ++) {
+
+    const google::protobuf::EnumValueDescriptor* value = descriptor->value(i);
+    const std::string& name = value->name();
+
+    m_numbers[Key{name.data(), (v_buff_size) name.size()}] = value->number();
+
+    if(dense) {
+      auto& index = m_denseIndex[value->number() - m_minNumber];
+      if(index < 0) index = i;
+    } else {
+      m_sparseIndex.insert({value->number(), i});
+    }
+
+  }
+
+}
+
+EnumTable* EnumTable::get(const google::protobuf::EnumDescriptor* descriptor) {
+
+  /* tables are never removed from the registry, so once seen the pointer can be cached by the thread */
+  thread_local std::unordered_map<const google::protobuf::EnumDescriptor*, EnumTable*> cache;
+
+  auto it = cache.find(descriptor);
+  if(it != cache.end()) {
+    return it->second;
+  }
+
+  EnumTable* table;
+  {
+    std::lock_guard<std::mutex> lock(REGISTRY_MUTEX);
+    auto& entry = REGISTRY[descriptor];
+    if(entry == nullptr) {
+      entry = new EnumTable(descriptor);
+    }
+    table = entry;
+  }
+
+  cache[descriptor] = table;
+  return table;
+
+}
+
+const google::protobuf::EnumDescriptor* EnumTable::getDescriptor() const {
+  return m_descriptor;
+}
+
+bool EnumTable::isClosed() const {
+  return m_closed;
+}
+
+v_int32 EnumTable::getSize() const {
+  return m_descriptor->value_count();
+}
+
+v_int32 EnumTable::getIndex(int number) const {
+  if(!m_denseIndex.empty()) {
+    v_int64 position = (v_int64) number - m_minNumber;
+    if(position >= 0 && position < (v_int64) m_denseIndex.size()) {
+      return m_denseIndex[position];
+    }
+    return -1;
+  }
+  auto it = m_sparseIndex.find(number);
+  if(it != m_sparseIndex.end()) {
+    return it->second;
+  }
+  return -1;
+}
+
+const std::string& EnumTable::getName(v_int32 index) const {
+  return m_descriptor->value(index)->name();
+}
+
+bool EnumTable::getNumber(const char* name, v_buff_size size, int& number) const {
+  auto it = m_numbers.find(Key{name, size});
+  if(it != m_numbers.end()) {
+    number = it->second;
+    return true;
+  }
+  return false;
+}
+
+bool EnumTable::resolveNumber(const char* name, v_buff_size size, int& number) const {
+
+  if(getNumber(name, size, number)) {
+    return true;
+  }
+
+  if(size == 0 || size > 11) {
+    return false;
+  }
+
+  v_int64 value = 0;
+  v_buff_size i = (name[0] == '-') ? 1 : 0;
+  if(i == size) {
+    return false;
+  }
+  for(; i < size; i ++) {
+    if(name[i] < '0' || name[i] > '9') {
+      return false;
+    }
+    value = value * 10 + (name[i] - '0');
+  }
+  if(name[0] == '-') {
+    value = -value;
+  }
+  if(value < std::numeric_limits<int>::min() || value > std::numeric_limits<int>::max()) {
+    return false;
+  }
+
+  if(m_closed && getIndex((int) value) < 0) {
+    return false;
+  }
+
+  number = (int) value;
+  return true;
+
+}
+
+oatpp::String EnumTable::createName(int number) const {
+  Statistics::onStringAllocated();
+  v_int32 index = getIndex(number);
+  if(index < 0) {
+    return oatpp::utils::conversion::int32ToStr(number);
+  }
+  const auto& name = getName(index);
+  return oatpp::String(std::make_shared<oatpp::base::StrBuffer>(name.data(), name.size(), false));
+}
+
+}}}
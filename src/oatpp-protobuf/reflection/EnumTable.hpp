@@ -0,0 +1,153 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#ifndef oatpp_protobuf_reflection_EnumTable_hpp
+#define oatpp_protobuf_reflection_EnumTable_hpp
+
+#include "oatpp/core/Types.hpp"
+#include <google/protobuf/descriptor.h>
+
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace oatpp { namespace protobuf { namespace reflection {
+
+/**
+ * Precomputed lookup tables of the proto enum. <br>
+ * Name-to-number lookup doesn't allocate. Names are the strings held by the `google::protobuf::EnumDescriptor`.
+ * Tables are built once per enum and live as long as the program.
+ */
+class EnumTable {
+private:
+
+  struct Key {
+
+    const char* data;
+    v_buff_size size;
+
+    bool operator==(const Key& other) const {
+      return size == other.size && std::memcmp(data, other.data, size) == 0;
+    }
+
+  };
+
+  struct KeyHash {
+    std::size_t operator()(const Key& key) const;
+  };
+
+private:
+  static std::mutex REGISTRY_MUTEX;
+  static std::unordered_map<const google::protobuf::EnumDescriptor*, EnumTable*> REGISTRY;
+private:
+  const google::protobuf::EnumDescriptor* m_descriptor;
+  bool m_closed;
+  int m_minNumber;
+  std::vector<v_int32> m_denseIndex;
+  std::unordered_map<int, v_int32> m_sparseIndex;
+  std::unordered_map<Key, int, KeyHash> m_numbers;
+private:
+  EnumTable(const google::protobuf::EnumDescriptor* descriptor);
+public:
+
+  /**
+   * Get enum table. <br>
+   * Lookups are served from a per-thread cache and take the registry lock only the first time
+   * the descriptor is seen by the calling thread.
+   * @param descriptor - `google::protobuf::EnumDescriptor`.
+   * @return
+   */
+  static EnumTable* get(const google::protobuf::EnumDescriptor* descriptor);
+
+  /**
+   * Get enum descriptor.
+   * @return
+   */
+  const google::protobuf::EnumDescriptor* getDescriptor() const;
+
+  /**
+   * Is the enum closed. <br>
+   * Enums declared in proto2 files are closed - they don't accept numbers which have no enum value.
+   * @return
+   */
+  bool isClosed() const;
+
+  /**
+   * Get number of enum values declared in the descriptor. <br>
+   * Aliases (`allow_alias`) are counted - each declared name is a separate value.
+   * @return
+   */
+  v_int32 getSize() const;
+
+  /**
+   * Get index of the enum value by number. <br>
+   * Index is in range `[0, getSize())`. If several names share the number the index of the first one is returned.
+   * @param number
+   * @return - index or `-1` if there is no such value.
+   */
+  v_int32 getIndex(int number) const;
+
+  /**
+   * Get name of the enum value by index.
+   * @param index - see &l:EnumTable::getIndex ();.
+   * @return
+   */
+  const std::string& getName(v_int32 index) const;
+
+  /**
+   * Get number of the enum value by name.
+   * @param name
+   * @param size - size of the name.
+   * @param number - out number.
+   * @return - `true` if found.
+   */
+  bool getNumber(const char* name, v_buff_size size, int& number) const;
+
+  /**
+   * Get number of the enum value by name. <br>
+   * Unknown names are accepted if they are decimal numbers - the way unknown values of open enums are written.
+   * Closed enums accept decimal numbers of their known values only.
+   * @param name
+   * @param size - size of the name.
+   * @param number - out number.
+   * @return - `true` if resolved.
+   */
+  bool resolveNumber(const char* name, v_buff_size size, int& number) const;
+
+  /**
+   * Create oatpp string with the name of the enum value. <br>
+   * The string doesn't copy the name - it points to the memory held by the enum descriptor.
+   * Unknown numbers are written as decimal numbers.
+   * @param number
+   * @return
+   */
+  oatpp::String createName(int number) const;
+
+};
+
+}}}
+
+#endif // oatpp_protobuf_reflection_EnumTable_hpp
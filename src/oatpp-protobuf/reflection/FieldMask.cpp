@@ -0,0 +1,184 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#include "FieldMask.hpp"
+#include "DynamicObject.hpp"
+
+#include <algorithm>
+
+namespace oatpp { namespace protobuf { namespace reflection {
+
+FieldMask::FieldMask()
+  : m_leaf(false)
+  , m_resolved(nullptr)
+{}
+
+FieldMask::~FieldMask() {
+  Resolved* resolved = m_resolved.load(std::memory_order_acquire);
+  while(resolved != nullptr) {
+    Resolved* next = resolved->next;
+    DynamicClass::destroyProjectedType(resolved->type.load(std::memory_order_relaxed));
+    delete resolved;
+    resolved = next;
+  }
+}
+
+std::shared_ptr<FieldMask> FieldMask::parse(const std::string& paths) {
+  auto mask = std::make_shared<FieldMask>();
+  v_buff_size start = 0;
+  v_buff_size size = paths.size();
+  while(start <= size) {
+    auto pos = paths.find(',', start);
+    v_buff_size end = (pos == std::string::npos) ? size : (v_buff_size) pos;
+    mask->addPath(paths.data() + start, end - start);
+    start = end + 1;
+  }
+  return mask;
+}
+
+std::shared_ptr<FieldMask> FieldMask::createShared(const std::vector<std::string>& paths) {
+  auto mask = std::make_shared<FieldMask>();
+  for(const auto& path : paths) {
+    mask->addPath(path);
+  }
+  return mask;
+}
+
+std::shared_ptr<FieldMask> FieldMask::createShared(const google::protobuf::FieldMask& mask) {
+  auto result = std::make_shared<FieldMask>();
+  for(const auto& path : mask.paths()) {
+    result->addPath(path);
+  }
+  return result;
+}
+
+void FieldMask::addPath(const char* data, v_buff_size size) {
+
+  while(size > 0 && (data[0] == ' ' || data[0] == '\t')) {
+    data ++;
+    size --;
+  }
+  while(size > 0 && (data[size - 1] == ' ' || data[size - 1] == '\t')) {
+    size --;
+  }
+
+  if(size == 0) {
+    return;
+  }
+
+  FieldMask* node = this;
+  v_buff_size start = 0;
+
+  while(true) {
+
+    /* the field is selected as a whole already - sub-paths don't narrow it */
+    if(node->m_leaf) {
+      return;
+    }
+
+    v_buff_size end = start;
+    while(end < size && data[end] != '.') {
+      end ++;
+    }
+
+    auto& child = node->m_fields[std::string(data + start, end - start)];
+    if(!child) {
+      child = std::make_shared<FieldMask>();
+    }
+    node = child.get();
+
+    if(end == size) {
+      node->m_leaf = true;
+      node->m_fields.clear();
+      return;
+    }
+
+    start = end + 1;
+
+  }
+
+}
+
+void FieldMask::addPath(const std::string& path) {
+  addPath(path.data(), path.size());
+}
+
+bool FieldMask::isAll() const {
+  return m_fields.empty();
+}
+
+const FieldMask* FieldMask::getField(const std::string& name) const {
+  auto it = m_fields.find(name);
+  if(it == m_fields.end()) {
+    return nullptr;
+  }
+  return it->second.get();
+}
+
+FieldMask::Resolved* FieldMask::resolve(const google::protobuf::Descriptor* descriptor) const {
+
+  for(Resolved* resolved = m_resolved.load(std::memory_order_acquire); resolved != nullptr; resolved = resolved->next) {
+    if(resolved->descriptor == descriptor) {
+      return resolved;
+    }
+  }
+
+  Resolved* resolved = new Resolved();
+  resolved->descriptor = descriptor;
+  resolved->type.store(nullptr, std::memory_order_relaxed);
+
+  for(const auto& entry : m_fields) {
+    auto field = descriptor->FindFieldByName(entry.first);
+    if(field == nullptr) {
+      field = descriptor->FindFieldByCamelcaseName(entry.first);
+    }
+    if(field != nullptr) {
+      resolved->fields.push_back({(v_uint32) field->index(), entry.second->isAll() ? nullptr : entry.second.get()});
+    }
+  }
+
+  std::sort(resolved->fields.begin(), resolved->fields.end(), [](const Selection& a, const Selection& b) {
+    return a.index < b.index;
+  });
+
+  /* the same field selected by both proto and json name */
+  auto last = std::unique(resolved->fields.begin(), resolved->fields.end(), [](const Selection& a, const Selection& b) {
+    return a.index == b.index;
+  });
+  resolved->fields.erase(last, resolved->fields.end());
+
+  /* concurrent resolution of the same type may push it twice - both copies are equal */
+  resolved->next = m_resolved.load(std::memory_order_relaxed);
+  while(!m_resolved.compare_exchange_weak(resolved->next, resolved, std::memory_order_release, std::memory_order_relaxed)) {}
+
+  return resolved;
+
+}
+
+const std::vector<FieldMask::Selection>& FieldMask::select(const google::protobuf::Descriptor* descriptor) const {
+  return resolve(descriptor)->fields;
+}
+
+}}}
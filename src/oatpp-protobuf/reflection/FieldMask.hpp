@@ -0,0 +1,162 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#ifndef oatpp_protobuf_reflection_FieldMask_hpp
+#define oatpp_protobuf_reflection_FieldMask_hpp
+
+#include "oatpp/core/Types.hpp"
+
+#include <google/protobuf/descriptor.h>
+#include <google/protobuf/field_mask.pb.h>
+
+#include <atomic>
+#include <unordered_map>
+
+namespace oatpp { namespace protobuf { namespace reflection {
+
+class DynamicClass; // FWD
+
+/**
+ * Projection of proto object fields - tree of field paths such as `"id,name,image.width"`
+ * (`?fields=` query parameter, `google.protobuf.FieldMask`). <br>
+ * A path selects the field as a whole, or the sub-fields of a nested message field. Paths through repeated
+ * and map message fields apply to every element. Unknown field names are ignored. <br>
+ * Field names are proto names or lowerCamelCase json names. <br>
+ * Mask is immutable once built and can be shared between threads.
+ */
+class FieldMask {
+  friend DynamicClass;
+public:
+
+  /**
+   * Selected field of the message type.
+   */
+  struct Selection {
+
+    /**
+     * Index of the field in the order of declaration.
+     */
+    v_uint32 index;
+
+    /**
+     * Mask of the field sub-fields. `nullptr` - the field is selected as a whole.
+     */
+    const FieldMask* mask;
+
+  };
+
+private:
+
+  /*
+   * Selection resolved for the message type. Resolved selections are pushed to a lock-free list and never removed -
+   * a mask is usually applied to one or a few types.
+   */
+  struct Resolved {
+    const google::protobuf::Descriptor* descriptor;
+    std::vector<Selection> fields;
+    Resolved* next;
+
+    /* type of projected objects of the message type - built on demand by the DynamicClass, owned by the mask */
+    std::atomic<oatpp::Type*> type;
+  };
+
+private:
+  std::unordered_map<std::string, std::shared_ptr<FieldMask>> m_fields;
+  bool m_leaf;
+  mutable std::atomic<Resolved*> m_resolved;
+private:
+  void addPath(const char* data, v_buff_size size);
+  Resolved* resolve(const google::protobuf::Descriptor* descriptor) const;
+public:
+
+  /**
+   * Constructor. Empty mask - selects all fields.
+   */
+  FieldMask();
+
+  /**
+   * Non-copyable.
+   */
+  FieldMask(const FieldMask&) = delete;
+  FieldMask& operator=(const FieldMask&) = delete;
+
+  /**
+   * Destructor.
+   */
+  ~FieldMask();
+
+  /**
+   * Create mask from comma-separated paths - `"id,name,image.width"`. Whitespace around paths is ignored.
+   * @param paths - comma-separated paths. Empty string - all fields.
+   * @return - `std::shared_ptr` to FieldMask.
+   */
+  static std::shared_ptr<FieldMask> parse(const std::string& paths);
+
+  /**
+   * Create mask from paths.
+   * @param paths - dot-separated paths.
+   * @return - `std::shared_ptr` to FieldMask.
+   */
+  static std::shared_ptr<FieldMask> createShared(const std::vector<std::string>& paths);
+
+  /**
+   * Create mask from `google.protobuf.FieldMask`.
+   * @param mask - proto field mask.
+   * @return - `std::shared_ptr` to FieldMask.
+   */
+  static std::shared_ptr<FieldMask> createShared(const google::protobuf::FieldMask& mask);
+
+  /**
+   * Add dot-separated path.
+   * @param path
+   */
+  void addPath(const std::string& path);
+
+  /**
+   * Check if the mask selects all fields.
+   * @return
+   */
+  bool isAll() const;
+
+  /**
+   * Get mask of the field.
+   * @param name - field name.
+   * @return - `nullptr` if the field is not selected. Mask which selects all fields if the field is selected as a whole.
+   */
+  const FieldMask* getField(const std::string& name) const;
+
+  /**
+   * Get selected fields of the message type in the order of declaration. <br>
+   * Resolved once per message type - then served without locks.
+   * @param descriptor - message type.
+   * @return - `std::vector` of &l:FieldMask::Selection;.
+   */
+  const std::vector<Selection>& select(const google::protobuf::Descriptor* descriptor) const;
+
+};
+
+}}}
+
+#endif // oatpp_protobuf_reflection_FieldMask_hpp
@@ -0,0 +1,83 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#include "Statistics.hpp"
+
+namespace oatpp { namespace protobuf { namespace reflection {
+
+std::atomic<bool> Statistics::ENABLED(false);
+thread_local Statistics::Counters Statistics::THREAD_COUNTERS = Statistics::Counters();
+
+Statistics::Statistics() {
+  reset();
+}
+
+void Statistics::setEnabled(bool enabled) {
+  ENABLED.store(enabled, std::memory_order_relaxed);
+}
+
+void Statistics::record(Direction direction, bool conversion, v_uint64 nanoseconds, const Counters& counters) {
+
+  if(conversion) {
+    m_conversions[direction].fetch_add(1, std::memory_order_relaxed);
+  }
+
+  /* time spent in nested messages is accounted to their own classes */
+  v_uint64 own = nanoseconds > counters.nestedNanoseconds ? nanoseconds - counters.nestedNanoseconds : 0;
+  m_nanoseconds[direction].fetch_add(own, std::memory_order_relaxed);
+
+  m_fieldsVisited.fetch_add(counters.fieldsVisited, std::memory_order_relaxed);
+  m_objectsAllocated.fetch_add(counters.objectsAllocated, std::memory_order_relaxed);
+  m_stringsAllocated.fetch_add(counters.stringsAllocated, std::memory_order_relaxed);
+  m_bytesCopied.fetch_add(counters.bytesCopied, std::memory_order_relaxed);
+
+}
+
+Statistics::Snapshot Statistics::getSnapshot(const std::string& className) const {
+  Snapshot snapshot;
+  snapshot.className = className;
+  for(v_int32 i = 0; i < DIRECTIONS_COUNT; i ++) {
+    snapshot.conversions[i] = m_conversions[i].load(std::memory_order_relaxed);
+    snapshot.nanoseconds[i] = m_nanoseconds[i].load(std::memory_order_relaxed);
+  }
+  snapshot.fieldsVisited = m_fieldsVisited.load(std::memory_order_relaxed);
+  snapshot.objectsAllocated = m_objectsAllocated.load(std::memory_order_relaxed);
+  snapshot.stringsAllocated = m_stringsAllocated.load(std::memory_order_relaxed);
+  snapshot.bytesCopied = m_bytesCopied.load(std::memory_order_relaxed);
+  return snapshot;
+}
+
+void Statistics::reset() {
+  for(v_int32 i = 0; i < DIRECTIONS_COUNT; i ++) {
+    m_conversions[i].store(0, std::memory_order_relaxed);
+    m_nanoseconds[i].store(0, std::memory_order_relaxed);
+  }
+  m_fieldsVisited.store(0, std::memory_order_relaxed);
+  m_objectsAllocated.store(0, std::memory_order_relaxed);
+  m_stringsAllocated.store(0, std::memory_order_relaxed);
+  m_bytesCopied.store(0, std::memory_order_relaxed);
+}
+
+}}}
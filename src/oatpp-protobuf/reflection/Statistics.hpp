@@ -0,0 +1,274 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#ifndef oatpp_protobuf_reflection_Statistics_hpp
+#define oatpp_protobuf_reflection_Statistics_hpp
+
+#include "oatpp/core/Types.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <string>
+
+namespace oatpp { namespace protobuf { namespace reflection {
+
+/**
+ * Conversion counters of a single &id:oatpp::protobuf::reflection::DynamicClass;. <br>
+ * Counters are opt-in - nothing is counted until &l:Statistics::setEnabled (); is called with `true`. <br>
+ * Nested messages are accounted to their own classes - time, fields, allocations and bytes of a nested message
+ * are not included in the counters of the enclosing message class.
+ */
+class Statistics {
+public:
+
+  /**
+   * Conversion direction.
+   */
+  enum Direction : v_int32 {
+
+    /**
+     * Proto object to json.
+     */
+    PROTO_TO_JSON = 0,
+
+    /**
+     * Json to proto object.
+     */
+    JSON_TO_PROTO = 1,
+
+    /**
+     * Proto object to &id:oatpp::protobuf::reflection::DynamicObject;.
+     */
+    PROTO_TO_OBJECT = 2,
+
+    /**
+     * &id:oatpp::protobuf::reflection::DynamicObject; to proto object.
+     */
+    OBJECT_TO_PROTO = 3,
+
+    /**
+     * Number of directions.
+     */
+    DIRECTIONS_COUNT = 4
+
+  };
+
+  /**
+   * Point-in-time copy of the counters.
+   */
+  struct Snapshot {
+
+    /**
+     * Full name of the proto type.
+     */
+    std::string className;
+
+    /**
+     * Number of conversions in each &l:Statistics::Direction;.
+     */
+    v_uint64 conversions[DIRECTIONS_COUNT];
+
+    /**
+     * Cumulative time of conversions in each &l:Statistics::Direction; in nanoseconds.
+     */
+    v_uint64 nanoseconds[DIRECTIONS_COUNT];
+
+    /**
+     * Number of fields visited by conversions.
+     */
+    v_uint64 fieldsVisited;
+
+    /**
+     * Number of &id:oatpp::protobuf::reflection::DynamicObject; allocated.
+     */
+    v_uint64 objectsAllocated;
+
+    /**
+     * Number of `oatpp::String` allocated.
+     */
+    v_uint64 stringsAllocated;
+
+    /**
+     * Number of bytes of string and bytes fields copied.
+     */
+    v_uint64 bytesCopied;
+
+  };
+
+private:
+
+  /*
+   * Counters of the conversion currently running on this thread.
+   */
+  struct Counters {
+    v_uint64 fieldsVisited;
+    v_uint64 objectsAllocated;
+    v_uint64 stringsAllocated;
+    v_uint64 bytesCopied;
+    v_uint64 nestedNanoseconds;
+  };
+
+private:
+  static std::atomic<bool> ENABLED;
+  static thread_local Counters THREAD_COUNTERS;
+private:
+  std::atomic<v_uint64> m_conversions[DIRECTIONS_COUNT];
+  std::atomic<v_uint64> m_nanoseconds[DIRECTIONS_COUNT];
+  std::atomic<v_uint64> m_fieldsVisited;
+  std::atomic<v_uint64> m_objectsAllocated;
+  std::atomic<v_uint64> m_stringsAllocated;
+  std::atomic<v_uint64> m_bytesCopied;
+private:
+  void record(Direction direction, bool conversion, v_uint64 nanoseconds, const Counters& counters);
+public:
+
+  /**
+   * Accounts a conversion to the class for the lifetime of the tracker. <br>
+   * Trackers of nested messages pause the tracker of the enclosing message.
+   * Does nothing if statistics are disabled.
+   */
+  class Tracker {
+  private:
+    Statistics* m_statistics;
+    Direction m_direction;
+    bool m_conversion;
+    Counters m_outer;
+    std::chrono::steady_clock::time_point m_start;
+  public:
+
+    /**
+     * Constructor.
+     * @param statistics - statistics of the class being converted.
+     * @param direction - &l:Statistics::Direction;.
+     * @param conversion - count this as a separate conversion. `false` - only time and counters are accounted.
+     */
+    Tracker(Statistics* statistics, Direction direction, bool conversion = true)
+      : m_statistics(isEnabled() ? statistics : nullptr)
+      , m_direction(direction)
+      , m_conversion(conversion)
+    {
+      if(m_statistics) {
+        m_outer = THREAD_COUNTERS;
+        THREAD_COUNTERS = Counters();
+        m_start = std::chrono::steady_clock::now();
+      }
+    }
+
+    /**
+     * Non-copyable.
+     */
+    Tracker(const Tracker&) = delete;
+    Tracker& operator=(const Tracker&) = delete;
+
+    /**
+     * Destructor. Records the conversion.
+     */
+    ~Tracker() {
+      if(m_statistics) {
+        auto elapsed = (v_uint64) std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_start).count();
+        m_statistics->record(m_direction, m_conversion, elapsed, THREAD_COUNTERS);
+        THREAD_COUNTERS = m_outer;
+        THREAD_COUNTERS.nestedNanoseconds += elapsed;
+      }
+    }
+
+  };
+
+public:
+
+  /**
+   * Constructor.
+   */
+  Statistics();
+
+  /**
+   * Enable or disable statistics for all classes. Disabled by default.
+   * @param enabled
+   */
+  static void setEnabled(bool enabled);
+
+  /**
+   * Check if statistics are enabled.
+   * @return
+   */
+  static bool isEnabled() {
+    return ENABLED.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * Account fields visited by the current conversion.
+   * @param count
+   */
+  static void onFieldsVisited(v_uint64 count) {
+    if(isEnabled()) {
+      THREAD_COUNTERS.fieldsVisited += count;
+    }
+  }
+
+  /**
+   * Account &id:oatpp::protobuf::reflection::DynamicObject; allocated by the current conversion.
+   */
+  static void onObjectAllocated() {
+    if(isEnabled()) {
+      THREAD_COUNTERS.objectsAllocated ++;
+    }
+  }
+
+  /**
+   * Account `oatpp::String` allocated by the current conversion.
+   */
+  static void onStringAllocated() {
+    if(isEnabled()) {
+      THREAD_COUNTERS.stringsAllocated ++;
+    }
+  }
+
+  /**
+   * Account string or bytes data copied by the current conversion.
+   * @param size - number of bytes copied.
+   */
+  static void onBytesCopied(v_uint64 size) {
+    if(isEnabled()) {
+      THREAD_COUNTERS.bytesCopied += size;
+    }
+  }
+
+  /**
+   * Get snapshot of the counters.
+   * @param className - name of the class to put into the snapshot.
+   * @return - &l:Statistics::Snapshot;.
+   */
+  Snapshot getSnapshot(const std::string& className) const;
+
+  /**
+   * Reset all counters to zero.
+   */
+  void reset();
+
+};
+
+}}}
+
+#endif // oatpp_protobuf_reflection_Statistics_hpp
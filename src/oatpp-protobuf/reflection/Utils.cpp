@@ -24,8 +24,121 @@
 
 #include "Utils.hpp"
 
+#include "oatpp/core/utils/ConversionUtils.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <cstdlib>
+#include <limits>
+
 namespace oatpp { namespace protobuf { namespace reflection {
 
+oatpp::String Utils::getMapKey(const Reflection* refl, const Message& entry, const FieldDescriptor* keyField,
+                               const std::shared_ptr<const Message>& owner)
+{
+
+  if(keyField->cpp_type() == google::protobuf::FieldDescriptor::CPPTYPE_STRING) {
+    std::string scratch;
+    const auto& str = refl->GetStringReference(entry, keyField, &scratch);
+    return createString(str, &str != &scratch ? owner : nullptr);
+  }
+
+  Statistics::onStringAllocated();
+
+  switch(keyField->cpp_type()) {
+    case google::protobuf::FieldDescriptor::CPPTYPE_INT32: return oatpp::utils::conversion::int32ToStr(refl->GetInt32(entry, keyField));
+    case google::protobuf::FieldDescriptor::CPPTYPE_UINT32: return oatpp::utils::conversion::uint32ToStr(refl->GetUInt32(entry, keyField));
+    case google::protobuf::FieldDescriptor::CPPTYPE_INT64: return oatpp::utils::conversion::int64ToStr(refl->GetInt64(entry, keyField));
+    case google::protobuf::FieldDescriptor::CPPTYPE_UINT64: return oatpp::utils::conversion::uint64ToStr(refl->GetUInt64(entry, keyField));
+    case google::protobuf::FieldDescriptor::CPPTYPE_BOOL: return refl->GetBool(entry, keyField) ? oatpp::String("true") : oatpp::String("false");
+    default:
+      throw std::runtime_error("[oatpp::protobuf::reflection::Utils::getMapKey()]: "
+                               "Error. Invalid map key type - " + std::string(keyField->type_name()));
+  }
+
+}
+
+bool Utils::setMapKey(const Reflection* refl, Message* entry, const FieldDescriptor* keyField,
+                      const char* data, v_buff_size size)
+{
+
+  switch(keyField->cpp_type()) {
+
+    case google::protobuf::FieldDescriptor::CPPTYPE_STRING:
+      refl->SetString(entry, keyField, std::string(data, size));
+      return true;
+
+    case google::protobuf::FieldDescriptor::CPPTYPE_BOOL:
+      if(size == 4 && std::memcmp(data, "true", 4) == 0) {
+        refl->SetBool(entry, keyField, true);
+        return true;
+      }
+      if(size == 5 && std::memcmp(data, "false", 5) == 0) {
+        refl->SetBool(entry, keyField, false);
+        return true;
+      }
+      return false;
+
+    default:
+      break;
+
+  }
+
+  /* integer keys - decimal only, the whole string must be consumed */
+  if(size == 0 || size > 20 || data[0] == '+' || data[0] == ' ') {
+    return false;
+  }
+
+  char buffer[24];
+  std::memcpy(buffer, data, size);
+  buffer[size] = 0;
+  char* end;
+  errno = 0;
+
+  switch(keyField->cpp_type()) {
+
+    case google::protobuf::FieldDescriptor::CPPTYPE_INT32: {
+      long long value = std::strtoll(buffer, &end, 10);
+      if(errno != 0 || *end != 0 || value < std::numeric_limits<v_int32>::min() || value > std::numeric_limits<v_int32>::max()) {
+        return false;
+      }
+      refl->SetInt32(entry, keyField, (v_int32) value);
+      return true;
+    }
+
+    case google::protobuf::FieldDescriptor::CPPTYPE_INT64: {
+      long long value = std::strtoll(buffer, &end, 10);
+      if(errno != 0 || *end != 0) {
+        return false;
+      }
+      refl->SetInt64(entry, keyField, (v_int64) value);
+      return true;
+    }
+
+    case google::protobuf::FieldDescriptor::CPPTYPE_UINT32: {
+      unsigned long long value = std::strtoull(buffer, &end, 10);
+      if(buffer[0] == '-' || errno != 0 || *end != 0 || value > std::numeric_limits<v_uint32>::max()) {
+        return false;
+      }
+      refl->SetUInt32(entry, keyField, (v_uint32) value);
+      return true;
+    }
+
+    case google::protobuf::FieldDescriptor::CPPTYPE_UINT64: {
+      unsigned long long value = std::strtoull(buffer, &end, 10);
+      if(buffer[0] == '-' || errno != 0 || *end != 0) {
+        return false;
+      }
+      refl->SetUInt64(entry, keyField, (v_uint64) value);
+      return true;
+    }
+
+    default:
+      throw std::runtime_error("[oatpp::protobuf::reflection::Utils::setMapKey()]: "
+                               "Error. Invalid map key type - " + std::string(keyField->type_name()));
+
+  }
 
+}
 
 }}}
@@ -25,6 +25,9 @@
 #ifndef oatpp_protobuf_reflection_Utils_hpp
 #define oatpp_protobuf_reflection_Utils_hpp
 
+#include "EnumTable.hpp"
+#include "Statistics.hpp"
+
 #include "oatpp/core/Types.hpp"
 #include <google/protobuf/message.h>
 
@@ -39,41 +42,401 @@ template<typename T>
 struct TypeHelper {
 };
 
+class DynamicClass; // FWD
+
+/**
+ * Well-known types of `google/protobuf` which are converted to native oatpp values instead of nested objects.
+ * See &id:oatpp::protobuf::reflection::WellKnownTypes;.
+ */
+enum class WellKnownType : v_int32 {
+  NONE = 0,
+  TIMESTAMP,
+  DURATION,
+  FIELD_MASK,
+  DOUBLE_VALUE,
+  FLOAT_VALUE,
+  INT64_VALUE,
+  UINT64_VALUE,
+  INT32_VALUE,
+  UINT32_VALUE,
+  BOOL_VALUE,
+  STRING_VALUE,
+  BYTES_VALUE,
+  STRUCT,
+  VALUE,
+  LIST_VALUE,
+  ANY
+};
+
+/**
+ * Precompiled conversion plan of a single proto field. <br>
+ * Built once per &id:oatpp::protobuf::reflection::DynamicClass; so that conversions don't dispatch on field type
+ * and don't resolve nested classes for every value.
+ */
+struct FieldInfo {
+
+  /**
+   * Read proto field to oatpp value. <br>
+   * `owner` keeps `proto` alive. If `owner` is not `nullptr` string and bytes values share memory with `proto`
+   * instead of being copied.
+   */
+  typedef oatpp::Void (*Getter)(const Reflection* refl, const Message& proto, const FieldInfo& info,
+                                const std::shared_ptr<const Message>& owner);
+
+  /**
+   * Write non-null oatpp value to proto field.
+   */
+  typedef void (*Setter)(const Reflection* refl, Message* proto, const FieldInfo& info, const oatpp::Void& value);
+
+  /**
+   * Proto field descriptor.
+   */
+  const FieldDescriptor* descriptor;
+
+  /**
+   * Getter for this field.
+   */
+  Getter getter;
+
+  /**
+   * Setter for this field.
+   */
+  Setter setter;
+
+  /**
+   * Resolved oatpp type of the field. For repeated fields it's the type of `oatpp::Vector`.
+   */
+  const oatpp::Type* type;
+
+  /**
+   * Resolved class of the nested message. `nullptr` for non-message fields.
+   */
+  DynamicClass* nestedClass;
+
+  /**
+   * Lookup tables of the enum. `nullptr` for non-enum fields.
+   */
+  const EnumTable* enumTable;
+
+  /**
+   * Field tracks presence - `optional`, message and oneof fields, and all singular proto2 fields. <br>
+   * Singular fields without presence are "not set" whenever they hold the default value.
+   */
+  bool hasPresence;
+
+  /**
+   * Key field of the map entry. `nullptr` for non-map fields.
+   */
+  const FieldDescriptor* mapKey;
+
+  /**
+   * Conversion plan of the value field of the map entry. `nullptr` for non-map fields.
+   */
+  std::shared_ptr<const FieldInfo> mapValue;
+
+  /**
+   * Well-known type of the message field. &l:WellKnownType::NONE; for all other fields including maps -
+   * for maps it's set on &l:FieldInfo::mapValue;.
+   */
+  WellKnownType wellKnownType;
+
+};
+
 class Utils {
+private:
+
+  /*
+   * Non-owning string buffer which keeps the owner of its memory alive.
+   */
+  struct SharedStrBuffer {
+
+    SharedStrBuffer(const std::string& str, const std::shared_ptr<const Message>& pOwner)
+      : buffer(str.data(), str.size(), false)
+      , owner(pOwner)
+    {}
+
+    oatpp::base::StrBuffer buffer;
+    std::shared_ptr<const Message> owner;
+
+  };
+
+  /*
+   * Repeated numeric and bool fields - read straight from the contiguous storage.
+   */
+  template<typename CT>
+  static void getRepeatedValues(const Reflection* refl, const Message& proto, const FieldInfo& info,
+                                const std::shared_ptr<const Message>& /* owner */,
+                                std::vector<typename TypeHelper<CT>::StaticType>& values,
+                                std::true_type /* contiguous */)
+  {
+    const auto& field = getRepeatedScalars<CT>(refl, proto, info.descriptor);
+    const CT* data = field.data();
+    int size = field.size();
+    values.reserve(size);
+    for (int i = 0; i < size; i++) {
+      values.emplace_back(data[i]);
+    }
+  }
+
+  template<typename CT>
+  static void getRepeatedValues(const Reflection* refl, const Message& proto, const FieldInfo& info,
+                                const std::shared_ptr<const Message>& owner,
+                                std::vector<typename TypeHelper<CT>::StaticType>& values,
+                                std::false_type /* contiguous */)
+  {
+    int size = refl->FieldSize(proto, info.descriptor);
+    values.reserve(size);
+    for (int i = 0; i < size; i++) {
+      values.push_back(TypeHelper<CT>::getArrayItem(refl, info, proto, i, owner));
+    }
+  }
+
+  /*
+   * Proto repeated fields can't hold null elements - skipping them would shift the indices of the rest.
+   */
+  template<class T>
+  static void checkArrayItem(const FieldInfo& info, const T& value) {
+    if(!value) {
+      throw std::runtime_error("[oatpp::protobuf::reflection::Utils::setRepeatedProtoField()]: Error. "
+                               "Null element of repeated field '" + info.descriptor->full_name() + "'.");
+    }
+  }
+
+  template<typename CT>
+  static void setRepeatedValues(const Reflection* refl, Message* proto, const FieldInfo& info,
+                                const std::vector<typename TypeHelper<CT>::StaticType>& values,
+                                std::true_type /* contiguous */)
+  {
+    auto field = mutableRepeatedScalars<CT>(refl, proto, info.descriptor);
+    field->Clear();
+    field->Reserve((int) values.size());
+    for(auto& val : values) {
+      checkArrayItem(info, val);
+      field->AddAlreadyReserved(*val);
+    }
+  }
+
+  template<typename CT>
+  static void setRepeatedValues(const Reflection* refl, Message* proto, const FieldInfo& info,
+                                const std::vector<typename TypeHelper<CT>::StaticType>& values,
+                                std::false_type /* contiguous */)
+  {
+    refl->ClearField(proto, info.descriptor);
+    for(auto& val : values) {
+      checkArrayItem(info, val);
+      TypeHelper<CT>::addArrayItem(refl, info, proto, val);
+    }
+  }
+
 public:
 
+  /**
+   * Create oatpp string from proto string.
+   * @param str - proto string.
+   * @param owner - owner of the proto string memory. If `nullptr` - the string is copied,
+   * else - oatpp string shares memory with the proto string and keeps the owner alive.
+   * @return
+   */
+  static oatpp::String createString(const std::string& str, const std::shared_ptr<const Message>& owner) {
+    Statistics::onStringAllocated();
+    if(owner && !str.empty()) {
+      auto holder = std::make_shared<SharedStrBuffer>(str, owner);
+      return oatpp::String(std::shared_ptr<oatpp::base::StrBuffer>(holder, &holder->buffer));
+    }
+    Statistics::onBytesCopied(str.size());
+    return oatpp::String(str.data(), str.size(), true);
+  }
+
+  /**
+   * Read key of the map entry as string. Integer and bool keys are converted to their decimal and
+   * `true`/`false` representation - same as in proto3 json.
+   * @param refl - reflection of the entry.
+   * @param entry - map entry.
+   * @param keyField - key field of the entry.
+   * @param owner - see &l:Utils::createString ();.
+   * @return
+   */
+  static oatpp::String getMapKey(const Reflection* refl, const Message& entry, const FieldDescriptor* keyField,
+                                 const std::shared_ptr<const Message>& owner);
+
+  /**
+   * Write key of the map entry parsed from string.
+   * @param refl - reflection of the entry.
+   * @param entry - map entry.
+   * @param keyField - key field of the entry.
+   * @param data - key string.
+   * @param size - key string size.
+   * @return - `false` if the string is not a valid key of this key type.
+   */
+  static bool setMapKey(const Reflection* refl, Message* entry, const FieldDescriptor* keyField,
+                        const char* data, v_buff_size size);
+
   template<typename CT>
-  static oatpp::Void getProtoField(const Reflection* refl, const FieldDescriptor* field, const Message& proto) {
-
-    if (field->is_repeated()) {
-      auto vt = TypeHelper<CT>::getDynamicVectorType(field);
-      oatpp::Vector<typename TypeHelper<CT>::StaticType> arr(std::make_shared<std::vector<typename TypeHelper<CT>::StaticType>>(), vt);
-      int size = refl->FieldSize(proto, field);
-      for (int i = 0; i < size; i++) {
-        arr->push_back(TypeHelper<CT>::getArrayItem(refl, field, proto, i));
-      }
-      return arr;
-    } else if(refl->HasField(proto, field)) {
-      return TypeHelper<CT>::getFieldValue(refl, field, proto);
+  static oatpp::Void getProtoField(const Reflection* refl, const Message& proto, const FieldInfo& info,
+                                   const std::shared_ptr<const Message>& owner)
+  {
+    if(refl->HasField(proto, info.descriptor)) {
+      return TypeHelper<CT>::getFieldValue(refl, info, proto, owner);
     }
-    return oatpp::Void(nullptr, TypeHelper<CT>::getDynamicType(field));
+    return oatpp::Void(nullptr, info.type);
+  }
+
+  /*
+   * `Reflection::GetRepeatedField()/MutableRepeatedField()` are deprecated in favor of `RepeatedFieldRef`
+   * which only gives per-element access. They are still the only way to get the contiguous storage.
+   */
+#if defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+#elif defined(_MSC_VER)
+#pragma warning(push)
+#pragma warning(disable: 4996)
+#endif
+
+  /**
+   * Get contiguous storage of repeated numeric or bool field. Not applicable to enum fields.
+   * @tparam CT - C++ type of the field value.
+   * @param refl
+   * @param proto
+   * @param field
+   * @return - `google::protobuf::RepeatedField`.
+   */
+  template<typename CT>
+  static const google::protobuf::RepeatedField<CT>& getRepeatedScalars(const Reflection* refl, const Message& proto,
+                                                                       const FieldDescriptor* field)
+  {
+    return refl->GetRepeatedField<CT>(proto, field);
+  }
+
+  /**
+   * Get mutable contiguous storage of repeated numeric or bool field. Not applicable to enum fields.
+   * @tparam CT - C++ type of the field value.
+   * @param refl
+   * @param proto
+   * @param field
+   * @return - `google::protobuf::RepeatedField`.
+   */
+  template<typename CT>
+  static google::protobuf::RepeatedField<CT>* mutableRepeatedScalars(const Reflection* refl, Message* proto,
+                                                                     const FieldDescriptor* field)
+  {
+    return refl->MutableRepeatedField<CT>(proto, field);
+  }
+
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#elif defined(_MSC_VER)
+#pragma warning(pop)
+#endif
 
+  template<typename CT>
+  static oatpp::Void getRepeatedProtoField(const Reflection* refl, const Message& proto, const FieldInfo& info,
+                                           const std::shared_ptr<const Message>& owner)
+  {
+    oatpp::Vector<typename TypeHelper<CT>::StaticType> arr(std::make_shared<std::vector<typename TypeHelper<CT>::StaticType>>(), info.type);
+    getRepeatedValues<CT>(refl, proto, info, owner, *arr, std::is_arithmetic<CT>());
+    return arr;
   }
 
   template<typename CT>
-  static void setProtoField(const Reflection* refl, const FieldDescriptor* field, Message* proto, const oatpp::Void& value) {
+  static oatpp::Void getMapProtoField(const Reflection* refl, const Message& proto, const FieldInfo& info,
+                                      const std::shared_ptr<const Message>& owner)
+  {
+    typedef typename TypeHelper<CT>::StaticType StaticType;
+    oatpp::UnorderedFields<StaticType> map(std::make_shared<std::unordered_map<oatpp::String, StaticType>>(), info.type);
+    int size = refl->FieldSize(proto, info.descriptor);
+    map->reserve(size);
+    for(int i = 0; i < size; i++) {
+      const Message& entry = refl->GetRepeatedMessage(proto, info.descriptor, i);
+      const Reflection* entryRefl = entry.GetReflection();
+      /* later entries with the same key win - same as in proto map */
+      (*map)[getMapKey(entryRefl, entry, info.mapKey, owner)] = TypeHelper<CT>::getFieldValue(entryRefl, *info.mapValue, entry, owner);
+    }
+    return map;
+  }
 
-    if(field->is_repeated()) {
-      const auto& arr = value.staticCast<oatpp::Vector<typename TypeHelper<CT>::StaticType>>();
-      refl->ClearField(proto, field);
-      for(auto& val : *arr) {
-        TypeHelper<CT>::addArrayItem(refl, field, proto, val);
+  template<typename CT>
+  static void setProtoField(const Reflection* refl, Message* proto, const FieldInfo& info, const oatpp::Void& value) {
+    const auto& val = value.staticCast<typename TypeHelper<CT>::StaticType>();
+    TypeHelper<CT>::setFieldValue(refl, info, proto, val);
+  }
+
+  template<typename CT>
+  static void setRepeatedProtoField(const Reflection* refl, Message* proto, const FieldInfo& info, const oatpp::Void& value) {
+    const auto& arr = value.staticCast<oatpp::Vector<typename TypeHelper<CT>::StaticType>>();
+    setRepeatedValues<CT>(refl, proto, info, *arr, std::is_arithmetic<CT>());
+  }
+
+  template<typename CT>
+  static void setMapProtoField(const Reflection* refl, Message* proto, const FieldInfo& info, const oatpp::Void& value) {
+    const auto& map = value.staticCast<oatpp::UnorderedFields<typename TypeHelper<CT>::StaticType>>();
+    refl->ClearField(proto, info.descriptor);
+    for(auto& pair : *map) {
+      if(!pair.first) {
+        continue;
+      }
+      Message* entry = refl->AddMessage(proto, info.descriptor);
+      const Reflection* entryRefl = entry->GetReflection();
+      if(!setMapKey(entryRefl, entry, info.mapKey, (const char*) pair.first->getData(), pair.first->getSize())) {
+        throw std::runtime_error("[oatpp::protobuf::reflection::Utils::setMapProtoField()]: Error. "
+                                 "Invalid key '" + pair.first->std_str() + "' for field '" + info.descriptor->full_name() + "'.");
       }
+      if(pair.second) {
+        TypeHelper<CT>::setFieldValue(entryRefl, *info.mapValue, entry, pair.second);
+      }
+    }
+  }
+
+  /**
+   * Create conversion plan for the field. <br>
+   * &l:FieldInfo::nestedClass; and &l:FieldInfo::enumTable; are left `nullptr` - it's up to the caller to resolve them
+   * for message and enum fields.
+   * @tparam CT - C++ type of the field value.
+   * @param field
+   * @return - &l:FieldInfo;.
+   */
+  template<typename CT>
+  static FieldInfo createFieldInfo(const FieldDescriptor* field) {
+    FieldInfo info;
+    info.descriptor = field;
+    info.nestedClass = nullptr;
+    info.enumTable = nullptr;
+    info.hasPresence = field->has_presence();
+    info.mapKey = nullptr;
+    info.wellKnownType = WellKnownType::NONE;
+    if(field->is_repeated()) {
+      info.getter = &getRepeatedProtoField<CT>;
+      info.setter = &setRepeatedProtoField<CT>;
+      info.type = TypeHelper<CT>::getDynamicVectorType(field);
     } else {
-      const auto& val = value.staticCast<typename TypeHelper<CT>::StaticType>();
-      TypeHelper<CT>::setFieldValue(refl, field, proto, val);
+      info.getter = &getProtoField<CT>;
+      info.setter = &setProtoField<CT>;
+      info.type = TypeHelper<CT>::getDynamicType(field);
     }
+    return info;
+  }
 
+  /**
+   * Create conversion plan for the map field. The field is converted to `oatpp::UnorderedFields<V>`.
+   * @tparam CT - C++ type of the map value.
+   * @param field - map field.
+   * @param value - conversion plan of the value field of the map entry.
+   * @return - &l:FieldInfo;.
+   */
+  template<typename CT>
+  static FieldInfo createMapFieldInfo(const FieldDescriptor* field, const std::shared_ptr<const FieldInfo>& value) {
+    FieldInfo info;
+    info.descriptor = field;
+    info.getter = &getMapProtoField<CT>;
+    info.setter = &setMapProtoField<CT>;
+    info.type = TypeHelper<CT>::getDynamicFieldsType(value->descriptor);
+    info.nestedClass = value->nestedClass;
+    info.enumTable = value->enumTable;
+    info.hasPresence = false;
+    info.mapKey = field->message_type()->map_key();
+    info.mapValue = value;
+    info.wellKnownType = WellKnownType::NONE;
+    return info;
   }
 
 };
@@ -84,22 +447,30 @@ struct TypeHelper <std::string> {
   typedef std::string CT;
   typedef oatpp::String StaticType;
 
-  static void setFieldValue(const Reflection* refl, const FieldDescriptor* field, Message* proto, const StaticType& value) {
-    refl->SetString(proto, field, value->std_str());
+  static void setFieldValue(const Reflection* refl, const FieldInfo& info, Message* proto, const StaticType& value) {
+    Statistics::onBytesCopied(value->getSize());
+    refl->SetString(proto, info.descriptor, value->std_str());
   }
 
-  static StaticType getFieldValue(const Reflection* refl, const FieldDescriptor* field, const Message& proto) {
-    const auto& str = refl->GetString(proto, field);
-    return StaticType(str.data(), str.size(), true);
+  static StaticType getFieldValue(const Reflection* refl, const FieldInfo& info, const Message& proto,
+                                  const std::shared_ptr<const Message>& owner)
+  {
+    std::string scratch;
+    const auto& str = refl->GetStringReference(proto, info.descriptor, &scratch);
+    return Utils::createString(str, &str != &scratch ? owner : nullptr);
   }
 
-  static void addArrayItem(const Reflection* refl, const FieldDescriptor* field, Message* proto, const StaticType& value) {
-    refl->AddString(proto, field, value->std_str());
+  static void addArrayItem(const Reflection* refl, const FieldInfo& info, Message* proto, const StaticType& value) {
+    Statistics::onBytesCopied(value->getSize());
+    refl->AddString(proto, info.descriptor, value->std_str());
   }
 
-  static StaticType getArrayItem(const Reflection* refl, const FieldDescriptor* field, const Message& proto, int index) {
-    const auto& str = refl->GetRepeatedString(proto, field, index);
-    return StaticType(str.data(), str.size(), true);
+  static StaticType getArrayItem(const Reflection* refl, const FieldInfo& info, const Message& proto, int index,
+                                 const std::shared_ptr<const Message>& owner)
+  {
+    std::string scratch;
+    const auto& str = refl->GetRepeatedStringReference(proto, info.descriptor, index, &scratch);
+    return Utils::createString(str, &str != &scratch ? owner : nullptr);
   }
 
   static const oatpp::Type* getDynamicType( const FieldDescriptor* field) {
@@ -112,6 +483,11 @@ struct TypeHelper <std::string> {
     return oatpp::Vector<StaticType>::Class::getType();
   }
 
+  static const oatpp::Type* getDynamicFieldsType(const FieldDescriptor* field) {
+    (void) field;
+    return oatpp::UnorderedFields<StaticType>::Class::getType();
+  }
+
 };
 
 template<>
@@ -120,20 +496,24 @@ struct TypeHelper <v_int32> {
   typedef v_int32 CT;
   typedef oatpp::Int32 StaticType;
 
-  static void setFieldValue(const Reflection* refl, const FieldDescriptor* field, Message* proto, const StaticType& value) {
-    refl->SetInt32(proto, field, *value);
+  static void setFieldValue(const Reflection* refl, const FieldInfo& info, Message* proto, const StaticType& value) {
+    refl->SetInt32(proto, info.descriptor, *value);
   }
 
-  static StaticType getFieldValue(const Reflection* refl, const FieldDescriptor* field, const Message& proto) {
-    return refl->GetInt32(proto, field);
+  static StaticType getFieldValue(const Reflection* refl, const FieldInfo& info, const Message& proto,
+                                  const std::shared_ptr<const Message>& /* owner */)
+  {
+    return refl->GetInt32(proto, info.descriptor);
   }
 
-  static void addArrayItem(const Reflection* refl, const FieldDescriptor* field, Message* proto, const StaticType& value) {
-    refl->AddInt32(proto, field, *value);
+  static void addArrayItem(const Reflection* refl, const FieldInfo& info, Message* proto, const StaticType& value) {
+    refl->AddInt32(proto, info.descriptor, *value);
   }
 
-  static StaticType getArrayItem(const Reflection* refl, const FieldDescriptor* field, const Message& proto, int index) {
-    return refl->GetRepeatedInt32(proto, field, index);
+  static StaticType getArrayItem(const Reflection* refl, const FieldInfo& info, const Message& proto, int index,
+                                 const std::shared_ptr<const Message>& /* owner */)
+  {
+    return refl->GetRepeatedInt32(proto, info.descriptor, index);
   }
 
   static const oatpp::Type* getDynamicType( const FieldDescriptor* field) {
@@ -146,6 +526,11 @@ struct TypeHelper <v_int32> {
     return oatpp::Vector<StaticType>::Class::getType();
   }
 
+  static const oatpp::Type* getDynamicFieldsType(const FieldDescriptor* field) {
+    (void) field;
+    return oatpp::UnorderedFields<StaticType>::Class::getType();
+  }
+
 };
 
 template<>
@@ -154,20 +539,24 @@ struct TypeHelper <v_uint32> {
   typedef v_uint32 CT;
   typedef oatpp::UInt32 StaticType;
 
-  static void setFieldValue(const Reflection* refl, const FieldDescriptor* field, Message* proto, const StaticType& value) {
-    refl->SetUInt32(proto, field, *value);
+  static void setFieldValue(const Reflection* refl, const FieldInfo& info, Message* proto, const StaticType& value) {
+    refl->SetUInt32(proto, info.descriptor, *value);
   }
 
-  static StaticType getFieldValue(const Reflection* refl, const FieldDescriptor* field, const Message& proto) {
-    return refl->GetUInt32(proto, field);
+  static StaticType getFieldValue(const Reflection* refl, const FieldInfo& info, const Message& proto,
+                                  const std::shared_ptr<const Message>& /* owner */)
+  {
+    return refl->GetUInt32(proto, info.descriptor);
   }
 
-  static void addArrayItem(const Reflection* refl, const FieldDescriptor* field, Message* proto, const StaticType& value) {
-    refl->AddUInt32(proto, field, *value);
+  static void addArrayItem(const Reflection* refl, const FieldInfo& info, Message* proto, const StaticType& value) {
+    refl->AddUInt32(proto, info.descriptor, *value);
   }
 
-  static StaticType getArrayItem(const Reflection* refl, const FieldDescriptor* field, const Message& proto, int index) {
-    return refl->GetRepeatedUInt32(proto, field, index);
+  static StaticType getArrayItem(const Reflection* refl, const FieldInfo& info, const Message& proto, int index,
+                                 const std::shared_ptr<const Message>& /* owner */)
+  {
+    return refl->GetRepeatedUInt32(proto, info.descriptor, index);
   }
 
   static const oatpp::Type* getDynamicType( const FieldDescriptor* field) {
@@ -180,6 +569,11 @@ struct TypeHelper <v_uint32> {
     return oatpp::Vector<StaticType>::Class::getType();
   }
 
+  static const oatpp::Type* getDynamicFieldsType(const FieldDescriptor* field) {
+    (void) field;
+    return oatpp::UnorderedFields<StaticType>::Class::getType();
+  }
+
 };
 
 template<>
@@ -188,20 +582,24 @@ struct TypeHelper <v_int64> {
   typedef v_int64 CT;
   typedef oatpp::Int64 StaticType;
 
-  static void setFieldValue(const Reflection* refl, const FieldDescriptor* field, Message* proto, const StaticType& value) {
-    refl->SetInt64(proto, field, *value);
+  static void setFieldValue(const Reflection* refl, const FieldInfo& info, Message* proto, const StaticType& value) {
+    refl->SetInt64(proto, info.descriptor, *value);
   }
 
-  static StaticType getFieldValue(const Reflection* refl, const FieldDescriptor* field, const Message& proto) {
-    return refl->GetInt64(proto, field);
+  static StaticType getFieldValue(const Reflection* refl, const FieldInfo& info, const Message& proto,
+                                  const std::shared_ptr<const Message>& /* owner */)
+  {
+    return refl->GetInt64(proto, info.descriptor);
   }
 
-  static void addArrayItem(const Reflection* refl, const FieldDescriptor* field, Message* proto, const StaticType& value) {
-    refl->AddInt64(proto, field, *value);
+  static void addArrayItem(const Reflection* refl, const FieldInfo& info, Message* proto, const StaticType& value) {
+    refl->AddInt64(proto, info.descriptor, *value);
   }
 
-  static StaticType getArrayItem(const Reflection* refl, const FieldDescriptor* field, const Message& proto, int index) {
-    return refl->GetRepeatedInt64(proto, field, index);
+  static StaticType getArrayItem(const Reflection* refl, const FieldInfo& info, const Message& proto, int index,
+                                 const std::shared_ptr<const Message>& /* owner */)
+  {
+    return refl->GetRepeatedInt64(proto, info.descriptor, index);
   }
 
   static const oatpp::Type* getDynamicType( const FieldDescriptor* field) {
@@ -214,6 +612,11 @@ struct TypeHelper <v_int64> {
     return oatpp::Vector<StaticType>::Class::getType();
   }
 
+  static const oatpp::Type* getDynamicFieldsType(const FieldDescriptor* field) {
+    (void) field;
+    return oatpp::UnorderedFields<StaticType>::Class::getType();
+  }
+
 };
 
 template<>
@@ -222,20 +625,24 @@ struct TypeHelper <v_uint64> {
   typedef v_uint64 CT;
   typedef oatpp::UInt64 StaticType;
 
-  static void setFieldValue(const Reflection* refl, const FieldDescriptor* field, Message* proto, const StaticType& value) {
-    refl->SetUInt64(proto, field, *value);
+  static void setFieldValue(const Reflection* refl, const FieldInfo& info, Message* proto, const StaticType& value) {
+    refl->SetUInt64(proto, info.descriptor, *value);
   }
 
-  static StaticType getFieldValue(const Reflection* refl, const FieldDescriptor* field, const Message& proto) {
-    return refl->GetUInt64(proto, field);
+  static StaticType getFieldValue(const Reflection* refl, const FieldInfo& info, const Message& proto,
+                                  const std::shared_ptr<const Message>& /* owner */)
+  {
+    return refl->GetUInt64(proto, info.descriptor);
   }
 
-  static void addArrayItem(const Reflection* refl, const FieldDescriptor* field, Message* proto, const StaticType& value) {
-    refl->AddUInt64(proto, field, *value);
+  static void addArrayItem(const Reflection* refl, const FieldInfo& info, Message* proto, const StaticType& value) {
+    refl->AddUInt64(proto, info.descriptor, *value);
   }
 
-  static StaticType getArrayItem(const Reflection* refl, const FieldDescriptor* field, const Message& proto, int index) {
-    return refl->GetRepeatedUInt64(proto, field, index);
+  static StaticType getArrayItem(const Reflection* refl, const FieldInfo& info, const Message& proto, int index,
+                                 const std::shared_ptr<const Message>& /* owner */)
+  {
+    return refl->GetRepeatedUInt64(proto, info.descriptor, index);
   }
 
   static const oatpp::Type* getDynamicType( const FieldDescriptor* field) {
@@ -248,6 +655,11 @@ struct TypeHelper <v_uint64> {
     return oatpp::Vector<StaticType>::Class::getType();
   }
 
+  static const oatpp::Type* getDynamicFieldsType(const FieldDescriptor* field) {
+    (void) field;
+    return oatpp::UnorderedFields<StaticType>::Class::getType();
+  }
+
 };
 
 template<>
@@ -256,20 +668,24 @@ struct TypeHelper <v_float32> {
   typedef v_float32 CT;
   typedef oatpp::Float32 StaticType;
 
-  static void setFieldValue(const Reflection* refl, const FieldDescriptor* field, Message* proto, const StaticType& value) {
-    refl->SetFloat(proto, field, *value);
+  static void setFieldValue(const Reflection* refl, const FieldInfo& info, Message* proto, const StaticType& value) {
+    refl->SetFloat(proto, info.descriptor, *value);
   }
 
-  static StaticType getFieldValue(const Reflection* refl, const FieldDescriptor* field, const Message& proto) {
-    return refl->GetFloat(proto, field);
+  static StaticType getFieldValue(const Reflection* refl, const FieldInfo& info, const Message& proto,
+                                  const std::shared_ptr<const Message>& /* owner */)
+  {
+    return refl->GetFloat(proto, info.descriptor);
   }
 
-  static void addArrayItem(const Reflection* refl, const FieldDescriptor* field, Message* proto, const StaticType& value) {
-    refl->AddFloat(proto, field, *value);
+  static void addArrayItem(const Reflection* refl, const FieldInfo& info, Message* proto, const StaticType& value) {
+    refl->AddFloat(proto, info.descriptor, *value);
   }
 
-  static StaticType getArrayItem(const Reflection* refl, const FieldDescriptor* field, const Message& proto, int index) {
-    return refl->GetRepeatedFloat(proto, field, index);
+  static StaticType getArrayItem(const Reflection* refl, const FieldInfo& info, const Message& proto, int index,
+                                 const std::shared_ptr<const Message>& /* owner */)
+  {
+    return refl->GetRepeatedFloat(proto, info.descriptor, index);
   }
 
   static const oatpp::Type* getDynamicType( const FieldDescriptor* field) {
@@ -282,6 +698,11 @@ struct TypeHelper <v_float32> {
     return oatpp::Vector<StaticType>::Class::getType();
   }
 
+  static const oatpp::Type* getDynamicFieldsType(const FieldDescriptor* field) {
+    (void) field;
+    return oatpp::UnorderedFields<StaticType>::Class::getType();
+  }
+
 };
 
 template<>
@@ -290,20 +711,24 @@ struct TypeHelper <v_float64> {
   typedef v_float64 CT;
   typedef oatpp::Float64 StaticType;
 
-  static void setFieldValue(const Reflection* refl, const FieldDescriptor* field, Message* proto, const StaticType& value) {
-    refl->SetDouble(proto, field, *value);
+  static void setFieldValue(const Reflection* refl, const FieldInfo& info, Message* proto, const StaticType& value) {
+    refl->SetDouble(proto, info.descriptor, *value);
   }
 
-  static StaticType getFieldValue(const Reflection* refl, const FieldDescriptor* field, const Message& proto) {
-    return refl->GetDouble(proto, field);
+  static StaticType getFieldValue(const Reflection* refl, const FieldInfo& info, const Message& proto,
+                                  const std::shared_ptr<const Message>& /* owner */)
+  {
+    return refl->GetDouble(proto, info.descriptor);
   }
 
-  static void addArrayItem(const Reflection* refl, const FieldDescriptor* field, Message* proto, const StaticType& value) {
-    refl->AddDouble(proto, field, *value);
+  static void addArrayItem(const Reflection* refl, const FieldInfo& info, Message* proto, const StaticType& value) {
+    refl->AddDouble(proto, info.descriptor, *value);
   }
 
-  static StaticType getArrayItem(const Reflection* refl, const FieldDescriptor* field, const Message& proto, int index) {
-    return refl->GetRepeatedDouble(proto, field, index);
+  static StaticType getArrayItem(const Reflection* refl, const FieldInfo& info, const Message& proto, int index,
+                                 const std::shared_ptr<const Message>& /* owner */)
+  {
+    return refl->GetRepeatedDouble(proto, info.descriptor, index);
   }
 
   static const oatpp::Type* getDynamicType( const FieldDescriptor* field) {
@@ -316,6 +741,11 @@ struct TypeHelper <v_float64> {
     return oatpp::Vector<StaticType>::Class::getType();
   }
 
+  static const oatpp::Type* getDynamicFieldsType(const FieldDescriptor* field) {
+    (void) field;
+    return oatpp::UnorderedFields<StaticType>::Class::getType();
+  }
+
 };
 
 template<>
@@ -324,20 +754,24 @@ struct TypeHelper <bool> {
   typedef bool CT;
   typedef oatpp::Boolean StaticType;
 
-  static void setFieldValue(const Reflection* refl, const FieldDescriptor* field, Message* proto, const StaticType& value) {
-    refl->SetBool(proto, field, *value);
+  static void setFieldValue(const Reflection* refl, const FieldInfo& info, Message* proto, const StaticType& value) {
+    refl->SetBool(proto, info.descriptor, *value);
   }
 
-  static StaticType getFieldValue(const Reflection* refl, const FieldDescriptor* field, const Message& proto) {
-    return refl->GetBool(proto, field);
+  static StaticType getFieldValue(const Reflection* refl, const FieldInfo& info, const Message& proto,
+                                  const std::shared_ptr<const Message>& /* owner */)
+  {
+    return refl->GetBool(proto, info.descriptor);
   }
 
-  static void addArrayItem(const Reflection* refl, const FieldDescriptor* field, Message* proto, const StaticType& value) {
-    refl->AddBool(proto, field, *value);
+  static void addArrayItem(const Reflection* refl, const FieldInfo& info, Message* proto, const StaticType& value) {
+    refl->AddBool(proto, info.descriptor, *value);
   }
 
-  static StaticType getArrayItem(const Reflection* refl, const FieldDescriptor* field, const Message& proto, int index) {
-    return refl->GetRepeatedBool(proto, field, index);
+  static StaticType getArrayItem(const Reflection* refl, const FieldInfo& info, const Message& proto, int index,
+                                 const std::shared_ptr<const Message>& /* owner */)
+  {
+    return refl->GetRepeatedBool(proto, info.descriptor, index);
   }
 
   static const oatpp::Type* getDynamicType( const FieldDescriptor* field) {
@@ -350,6 +784,11 @@ struct TypeHelper <bool> {
     return oatpp::Vector<StaticType>::Class::getType();
   }
 
+  static const oatpp::Type* getDynamicFieldsType(const FieldDescriptor* field) {
+    (void) field;
+    return oatpp::UnorderedFields<StaticType>::Class::getType();
+  }
+
 };
 
 template<>
@@ -358,28 +797,33 @@ struct TypeHelper <EnumDescriptor> {
   typedef EnumDescriptor CT;
   typedef oatpp::String StaticType;
 
-  static void setFieldValue(const Reflection* refl, const FieldDescriptor* field, Message* proto, const StaticType& value) {
-    const auto& val = value.staticCast<oatpp::String>();
-    const google::protobuf::EnumDescriptor* ed = field->enum_type();
-    refl->SetEnum(proto, field, ed->FindValueByName(val->std_str()));
+  static int getNumber(const FieldInfo& info, const StaticType& value) {
+    int number;
+    if(!info.enumTable->resolveNumber((const char*) value->getData(), value->getSize(), number)) {
+      throw std::runtime_error("[oatpp::protobuf::reflection::TypeHelper<EnumDescriptor>::getNumber()]: Error. "
+                               "Unknown enum value '" + value->std_str() + "' for field '" + info.descriptor->full_name() + "'.");
+    }
+    return number;
+  }
+
+  static void setFieldValue(const Reflection* refl, const FieldInfo& info, Message* proto, const StaticType& value) {
+    refl->SetEnumValue(proto, info.descriptor, getNumber(info, value));
   }
 
-  static StaticType getFieldValue(const Reflection* refl, const FieldDescriptor* field, const Message& proto) {
-    const google::protobuf::EnumValueDescriptor* evd = refl->GetEnum(proto, field);
-    const auto& name = evd->name();
-    return oatpp::String(name.data(), name.size(), true);
+  static StaticType getFieldValue(const Reflection* refl, const FieldInfo& info, const Message& proto,
+                                  const std::shared_ptr<const Message>& /* owner */)
+  {
+    return info.enumTable->createName(refl->GetEnumValue(proto, info.descriptor));
   }
 
-  static void addArrayItem(const Reflection* refl, const FieldDescriptor* field, Message* proto, const StaticType& value) {
-    const auto& val = value.staticCast<oatpp::String>();
-    const google::protobuf::EnumDescriptor* ed = field->enum_type();
-    refl->AddEnum(proto, field, ed->FindValueByName(val->std_str()));
+  static void addArrayItem(const Reflection* refl, const FieldInfo& info, Message* proto, const StaticType& value) {
+    refl->AddEnumValue(proto, info.descriptor, getNumber(info, value));
   }
 
-  static StaticType getArrayItem(const Reflection* refl, const FieldDescriptor* field, const Message& proto, int index) {
-    const google::protobuf::EnumValueDescriptor* evd = refl->GetRepeatedEnum(proto, field, index);
-    const auto& name = evd->name();
-    return oatpp::String(name.data(), name.size(), true);
+  static StaticType getArrayItem(const Reflection* refl, const FieldInfo& info, const Message& proto, int index,
+                                 const std::shared_ptr<const Message>& /* owner */)
+  {
+    return info.enumTable->createName(refl->GetRepeatedEnumValue(proto, info.descriptor, index));
   }
 
   static const oatpp::Type* getDynamicType( const FieldDescriptor* field) {
@@ -392,8 +836,40 @@ struct TypeHelper <EnumDescriptor> {
     return oatpp::Vector<StaticType>::Class::getType();
   }
 
+  static const oatpp::Type* getDynamicFieldsType(const FieldDescriptor* field) {
+    (void) field;
+    return oatpp::UnorderedFields<StaticType>::Class::getType();
+  }
+
 };
 
+/*
+ * Repeated enum fields - elements with the same value share one name string.
+ */
+template<>
+inline void Utils::getRepeatedValues<EnumDescriptor>(const Reflection* refl, const Message& proto, const FieldInfo& info,
+                                                     const std::shared_ptr<const Message>& /* owner */,
+                                                     std::vector<oatpp::String>& values,
+                                                     std::false_type /* contiguous */)
+{
+  std::vector<oatpp::String> names(info.enumTable->getSize());
+  int size = refl->FieldSize(proto, info.descriptor);
+  values.reserve(size);
+  for (int i = 0; i < size; i++) {
+    int number = refl->GetRepeatedEnumValue(proto, info.descriptor, i);
+    v_int32 index = info.enumTable->getIndex(number);
+    if(index < 0) {
+      values.push_back(info.enumTable->createName(number));
+      continue;
+    }
+    auto& name = names[index];
+    if(!name) {
+      name = info.enumTable->createName(number);
+    }
+    values.push_back(name);
+  }
+}
+
 }}}
 
 #endif // oatpp_protobuf_reflection_Utils_hpp
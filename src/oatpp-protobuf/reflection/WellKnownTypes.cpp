@@ -0,0 +1,866 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#include "WellKnownTypes.hpp"
+
+#include "DynamicObject.hpp"
+
+namespace oatpp { namespace protobuf { namespace reflection {
+
+namespace {
+
+namespace types = oatpp::data::mapping::type;
+
+const v_int64 TIMESTAMP_MIN_SECONDS = -62135596800LL; // 0001-01-01T00:00:00Z
+const v_int64 TIMESTAMP_MAX_SECONDS = 253402300799LL; // 9999-12-31T23:59:59Z
+const v_int64 DURATION_MAX_SECONDS = 315576000000LL; // 10000 years
+const v_int32 NANOS_PER_SECOND = 1000000000;
+
+/*
+ * Days since unix epoch <-> proleptic Gregorian date.
+ * http://howardhinnant.github.io/date_algorithms.html
+ */
+
+v_int64 daysFromCivil(v_int64 y, v_int64 m, v_int64 d) {
+  y -= m <= 2;
+  v_int64 era = (y >= 0 ? y : y - 399) / 400;
+  v_int64 yoe = y - era * 400;
+  v_int64 doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+  v_int64 doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  return era * 146097 + doe - 719468;
+}
+
+void civilFromDays(v_int64 days, v_int64& y, v_int64& m, v_int64& d) {
+  days += 719468;
+  v_int64 era = (days >= 0 ? days : days - 146096) / 146097;
+  v_int64 doe = days - era * 146097;
+  v_int64 yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+  v_int64 doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+  v_int64 mp = (5 * doy + 2) / 153;
+  d = doy - (153 * mp + 2) / 5 + 1;
+  m = mp < 10 ? mp + 3 : mp - 9;
+  y = yoe + era * 400 + (m <= 2);
+}
+
+v_int64 daysInMonth(v_int64 y, v_int64 m) {
+  static const v_int64 DAYS[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+  if(m == 2 && ((y % 4 == 0 && y % 100 != 0) || y % 400 == 0)) {
+    return 29;
+  }
+  return DAYS[m - 1];
+}
+
+char* writeDigits(char* p, v_uint64 value, v_int32 width) {
+  for(v_int32 i = width - 1; i >= 0; i --) {
+    p[i] = (char) ('0' + value % 10);
+    value /= 10;
+  }
+  return p + width;
+}
+
+char* writeFraction(char* p, v_int32 nanos) {
+  if(nanos == 0) {
+    return p;
+  }
+  *p++ = '.';
+  if(nanos % 1000000 == 0) {
+    return writeDigits(p, nanos / 1000000, 3);
+  }
+  if(nanos % 1000 == 0) {
+    return writeDigits(p, nanos / 1000, 6);
+  }
+  return writeDigits(p, nanos, 9);
+}
+
+bool readDigits(const char*& p, const char* end, v_int32 count, v_int64& value) {
+  if(end - p < count) {
+    return false;
+  }
+  value = 0;
+  for(v_int32 i = 0; i < count; i ++) {
+    if(p[i] < '0' || p[i] > '9') {
+      return false;
+    }
+    value = value * 10 + (p[i] - '0');
+  }
+  p += count;
+  return true;
+}
+
+bool readFraction(const char*& p, const char* end, v_int32& nanos) {
+  nanos = 0;
+  if(p == end || *p != '.') {
+    return true;
+  }
+  p ++;
+  v_int32 digits = 0;
+  while(p < end && *p >= '0' && *p <= '9') {
+    if(digits == 9) {
+      return false;
+    }
+    nanos = nanos * 10 + (*p - '0');
+    digits ++;
+    p ++;
+  }
+  if(digits == 0) {
+    return false;
+  }
+  for(; digits < 9; digits ++) {
+    nanos *= 10;
+  }
+  return true;
+}
+
+bool readChar(const char*& p, const char* end, char c) {
+  if(p < end && *p == c) {
+    p ++;
+    return true;
+  }
+  return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Struct / Value / ListValue <-> oatpp::Any
+
+/* field numbers of the google.protobuf.Value kinds */
+const int VALUE_NUMBER = 2;
+const int VALUE_STRING = 3;
+const int VALUE_BOOL = 4;
+const int VALUE_STRUCT = 5;
+const int VALUE_LIST = 6;
+
+oatpp::Any valueToAny(const Message& value, const std::shared_ptr<const Message>& owner);
+
+oatpp::UnorderedFields<oatpp::Any> structToFields(const Message& message, const std::shared_ptr<const Message>& owner) {
+  const Reflection* refl = message.GetReflection();
+  const FieldDescriptor* field = message.GetDescriptor()->field(0);
+  auto result = oatpp::UnorderedFields<oatpp::Any>::createShared();
+  int size = refl->FieldSize(message, field);
+  result->reserve(size);
+  for(int i = 0; i < size; i++) {
+    const Message& entry = refl->GetRepeatedMessage(message, field, i);
+    const Reflection* entryRefl = entry.GetReflection();
+    const google::protobuf::Descriptor* entryDesc = entry.GetDescriptor();
+    (*result)[Utils::getMapKey(entryRefl, entry, entryDesc->field(0), owner)] =
+      valueToAny(entryRefl->GetMessage(entry, entryDesc->field(1)), owner);
+  }
+  return result;
+}
+
+oatpp::Vector<oatpp::Any> listToVector(const Message& message, const std::shared_ptr<const Message>& owner) {
+  const Reflection* refl = message.GetReflection();
+  const FieldDescriptor* field = message.GetDescriptor()->field(0);
+  auto result = oatpp::Vector<oatpp::Any>::createShared();
+  int size = refl->FieldSize(message, field);
+  result->reserve(size);
+  for(int i = 0; i < size; i++) {
+    result->push_back(valueToAny(refl->GetRepeatedMessage(message, field, i), owner));
+  }
+  return result;
+}
+
+oatpp::Any valueToAny(const Message& value, const std::shared_ptr<const Message>& owner) {
+
+  const Reflection* refl = value.GetReflection();
+  const FieldDescriptor* kind = refl->GetOneofFieldDescriptor(value, value.GetDescriptor()->oneof_decl(0));
+
+  if(kind == nullptr) {
+    return nullptr;
+  }
+
+  switch(kind->number()) {
+    case VALUE_NUMBER: return oatpp::Float64(refl->GetDouble(value, kind));
+    case VALUE_STRING: {
+      std::string scratch;
+      const auto& str = refl->GetStringReference(value, kind, &scratch);
+      return Utils::createString(str, &str != &scratch ? owner : nullptr);
+    }
+    case VALUE_BOOL: return oatpp::Boolean(refl->GetBool(value, kind));
+    case VALUE_STRUCT: return structToFields(refl->GetMessage(value, kind), owner);
+    case VALUE_LIST: return listToVector(refl->GetMessage(value, kind), owner);
+    default: return nullptr; // null_value
+  }
+
+}
+
+template<class T>
+bool readNumber(const oatpp::Void& polymorph, v_float64& number) {
+  if(polymorph.valueType->classId.id != T::Class::CLASS_ID.id) {
+    return false;
+  }
+  number = (v_float64) *polymorph.staticCast<T>();
+  return true;
+}
+
+void voidToValue(const oatpp::Void& polymorph, Message* value);
+
+void fieldsToStruct(const oatpp::Void& polymorph, Message* message) {
+
+  const Reflection* refl = message->GetReflection();
+  const FieldDescriptor* field = message->GetDescriptor()->field(0);
+  refl->ClearField(message, field);
+
+  auto addEntry = [refl, field, message](const oatpp::String& key, const oatpp::Void& item) {
+    if(!key) {
+      return;
+    }
+    Message* entry = refl->AddMessage(message, field);
+    const Reflection* entryRefl = entry->GetReflection();
+    const google::protobuf::Descriptor* entryDesc = entry->GetDescriptor();
+    entryRefl->SetString(entry, entryDesc->field(0), key->std_str());
+    voidToValue(item, entryRefl->MutableMessage(entry, entryDesc->field(1)));
+  };
+
+  if(polymorph.valueType->classId.id == types::__class::AbstractUnorderedMap::CLASS_ID.id) {
+    for(auto& pair : *polymorph.staticCast<oatpp::UnorderedFields<oatpp::Void>>()) {
+      addEntry(pair.first, pair.second);
+    }
+  } else {
+    for(auto& pair : *polymorph.staticCast<oatpp::Fields<oatpp::Void>>()) {
+      addEntry(pair.first, pair.second);
+    }
+  }
+
+}
+
+void itemsToList(const oatpp::Void& polymorph, Message* message) {
+
+  const Reflection* refl = message->GetReflection();
+  const FieldDescriptor* field = message->GetDescriptor()->field(0);
+  refl->ClearField(message, field);
+
+  if(polymorph.valueType->classId.id == types::__class::AbstractVector::CLASS_ID.id) {
+    for(auto& item : *polymorph.staticCast<oatpp::Vector<oatpp::Void>>()) {
+      voidToValue(item, refl->AddMessage(message, field));
+    }
+  } else {
+    for(auto& item : *polymorph.staticCast<oatpp::List<oatpp::Void>>()) {
+      voidToValue(item, refl->AddMessage(message, field));
+    }
+  }
+
+}
+
+void voidToValue(const oatpp::Void& polymorph, Message* value) {
+
+  const Reflection* refl = value->GetReflection();
+  const google::protobuf::Descriptor* desc = value->GetDescriptor();
+
+  if(!polymorph) {
+    refl->SetEnumValue(value, desc->oneof_decl(0)->field(0), 0); // null_value
+    return;
+  }
+
+  auto id = polymorph.valueType->classId.id;
+  v_float64 number;
+
+  if(id == types::__class::Any::CLASS_ID.id) {
+    auto handle = static_cast<types::AnyHandle*>(polymorph.get());
+    voidToValue(oatpp::Void(handle->ptr, handle->type), value);
+  } else if(id == types::__class::String::CLASS_ID.id) {
+    refl->SetString(value, desc->FindFieldByNumber(VALUE_STRING), polymorph.staticCast<oatpp::String>()->std_str());
+  } else if(id == types::__class::Boolean::CLASS_ID.id) {
+    refl->SetBool(value, desc->FindFieldByNumber(VALUE_BOOL), *polymorph.staticCast<oatpp::Boolean>());
+  } else if(readNumber<oatpp::Float64>(polymorph, number) || readNumber<oatpp::Float32>(polymorph, number) ||
+            readNumber<oatpp::Int64>(polymorph, number) || readNumber<oatpp::UInt64>(polymorph, number) ||
+            readNumber<oatpp::Int32>(polymorph, number) || readNumber<oatpp::UInt32>(polymorph, number) ||
+            readNumber<oatpp::Int16>(polymorph, number) || readNumber<oatpp::UInt16>(polymorph, number) ||
+            readNumber<oatpp::Int8>(polymorph, number) || readNumber<oatpp::UInt8>(polymorph, number))
+  {
+    refl->SetDouble(value, desc->FindFieldByNumber(VALUE_NUMBER), number);
+  } else if(id == types::__class::AbstractUnorderedMap::CLASS_ID.id || id == types::__class::AbstractPairList::CLASS_ID.id) {
+    fieldsToStruct(polymorph, refl->MutableMessage(value, desc->FindFieldByNumber(VALUE_STRUCT)));
+  } else if(id == types::__class::AbstractVector::CLASS_ID.id || id == types::__class::AbstractList::CLASS_ID.id) {
+    itemsToList(polymorph, refl->MutableMessage(value, desc->FindFieldByNumber(VALUE_LIST)));
+  } else {
+    throw std::runtime_error("[oatpp::protobuf::reflection::WellKnownTypes::voidToValue()]: Error. "
+                             "Type '" + std::string(polymorph.valueType->classId.name) + "' can't be stored in google.protobuf.Value.");
+  }
+
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Converters - `get()` reads the well-known message, `set()` writes non-null value to it
+
+struct TimestampConverter {
+
+  typedef oatpp::String StaticType;
+
+  static StaticType get(const Message& message, const FieldInfo& info, const std::shared_ptr<const Message>& /* owner */) {
+    v_int64 seconds;
+    v_int32 nanos;
+    WellKnownTypes::getTime(message, seconds, nanos);
+    char buffer[WellKnownTypes::TIME_BUFFER_SIZE];
+    v_buff_size size = WellKnownTypes::formatTimestamp(seconds, nanos, buffer);
+    if(size < 0) {
+      throw std::runtime_error("[oatpp::protobuf::reflection::WellKnownTypes::TimestampConverter::get()]: Error. "
+                               "Value of '" + info.descriptor->full_name() + "' is out of range.");
+    }
+    Statistics::onStringAllocated();
+    return StaticType(buffer, size, true);
+  }
+
+  static void set(Message* message, const FieldInfo& info, const StaticType& value) {
+    v_int64 seconds;
+    v_int32 nanos;
+    if(!WellKnownTypes::parseTimestamp((const char*) value->getData(), value->getSize(), seconds, nanos)) {
+      throw std::runtime_error("[oatpp::protobuf::reflection::WellKnownTypes::TimestampConverter::set()]: Error. "
+                               "Invalid timestamp '" + value->std_str() + "' for field '" + info.descriptor->full_name() + "'.");
+    }
+    WellKnownTypes::setTime(message, seconds, nanos);
+  }
+
+};
+
+struct DurationConverter {
+
+  typedef oatpp::String StaticType;
+
+  static StaticType get(const Message& message, const FieldInfo& info, const std::shared_ptr<const Message>& /* owner */) {
+    v_int64 seconds;
+    v_int32 nanos;
+    WellKnownTypes::getTime(message, seconds, nanos);
+    char buffer[WellKnownTypes::TIME_BUFFER_SIZE];
+    v_buff_size size = WellKnownTypes::formatDuration(seconds, nanos, buffer);
+    if(size < 0) {
+      throw std::runtime_error("[oatpp::protobuf::reflection::WellKnownTypes::DurationConverter::get()]: Error. "
+                               "Value of '" + info.descriptor->full_name() + "' is out of range.");
+    }
+    Statistics::onStringAllocated();
+    return StaticType(buffer, size, true);
+  }
+
+  static void set(Message* message, const FieldInfo& info, const StaticType& value) {
+    v_int64 seconds;
+    v_int32 nanos;
+    if(!WellKnownTypes::parseDuration((const char*) value->getData(), value->getSize(), seconds, nanos)) {
+      throw std::runtime_error("[oatpp::protobuf::reflection::WellKnownTypes::DurationConverter::set()]: Error. "
+                               "Invalid duration '" + value->std_str() + "' for field '" + info.descriptor->full_name() + "'.");
+    }
+    WellKnownTypes::setTime(message, seconds, nanos);
+  }
+
+};
+
+struct FieldMaskConverter {
+
+  typedef oatpp::String StaticType;
+
+  static StaticType get(const Message& message, const FieldInfo& /* info */, const std::shared_ptr<const Message>& /* owner */) {
+    const Reflection* refl = message.GetReflection();
+    const FieldDescriptor* paths = message.GetDescriptor()->field(0);
+    std::string result;
+    int size = refl->FieldSize(message, paths);
+    for(int i = 0; i < size; i++) {
+      if(i > 0) {
+        result.push_back(',');
+      }
+      std::string scratch;
+      result.append(refl->GetRepeatedStringReference(message, paths, i, &scratch));
+    }
+    Statistics::onStringAllocated();
+    return StaticType(result.data(), result.size(), true);
+  }
+
+  static void set(Message* message, const FieldInfo& /* info */, const StaticType& value) {
+    const Reflection* refl = message->GetReflection();
+    const FieldDescriptor* paths = message->GetDescriptor()->field(0);
+    refl->ClearField(message, paths);
+    const char* data = (const char*) value->getData();
+    v_buff_size size = value->getSize();
+    v_buff_size begin = 0;
+    for(v_buff_size i = 0; i <= size; i++) {
+      if(i == size || data[i] == ',') {
+        if(i > begin) {
+          refl->AddString(message, paths, std::string(data + begin, i - begin));
+        }
+        begin = i + 1;
+      }
+    }
+  }
+
+};
+
+/*
+ * Wrappers - value is converted by the plan of the wrapper's single `value` field.
+ */
+template<typename CT>
+struct WrapperConverter {
+
+  typedef typename TypeHelper<CT>::StaticType StaticType;
+
+  static StaticType get(const Message& message, const FieldInfo& info, const std::shared_ptr<const Message>& owner) {
+    return TypeHelper<CT>::getFieldValue(message.GetReflection(), info.nestedClass->getFields()[0], message, owner);
+  }
+
+  static void set(Message* message, const FieldInfo& info, const StaticType& value) {
+    TypeHelper<CT>::setFieldValue(message->GetReflection(), info.nestedClass->getFields()[0], message, value);
+  }
+
+};
+
+struct StructConverter {
+
+  typedef oatpp::UnorderedFields<oatpp::Any> StaticType;
+
+  static StaticType get(const Message& message, const FieldInfo& /* info */, const std::shared_ptr<const Message>& owner) {
+    return structToFields(message, owner);
+  }
+
+  static void set(Message* message, const FieldInfo& /* info */, const StaticType& value) {
+    fieldsToStruct(value, message);
+  }
+
+};
+
+struct ValueConverter {
+
+  typedef oatpp::Any StaticType;
+
+  static StaticType get(const Message& message, const FieldInfo& /* info */, const std::shared_ptr<const Message>& owner) {
+    return valueToAny(message, owner);
+  }
+
+  static void set(Message* message, const FieldInfo& /* info */, const StaticType& value) {
+    voidToValue(value, message);
+  }
+
+};
+
+struct ListValueConverter {
+
+  typedef oatpp::Vector<oatpp::Any> StaticType;
+
+  static StaticType get(const Message& message, const FieldInfo& /* info */, const std::shared_ptr<const Message>& owner) {
+    return listToVector(message, owner);
+  }
+
+  static void set(Message* message, const FieldInfo& /* info */, const StaticType& value) {
+    itemsToList(value, message);
+  }
+
+};
+
+/*
+ * Any - unpacked to the object of the packed type and packed back from it.
+ */
+struct AnyConverter {
+
+  typedef oatpp::Any StaticType;
+
+  static StaticType get(const Message& message, const FieldInfo& info, const std::shared_ptr<const Message>& /* owner */) {
+
+    const Reflection* refl = message.GetReflection();
+    const google::protobuf::Descriptor* desc = message.GetDescriptor();
+
+    std::string urlScratch;
+    const auto& typeUrl = refl->GetStringReference(message, desc->field(0), &urlScratch);
+    if(typeUrl.empty()) {
+      return nullptr;
+    }
+
+    DynamicClass* clazz = DynamicClass::registryGetClassByTypeUrl(typeUrl);
+    if(clazz == nullptr) {
+      throw std::runtime_error("[oatpp::protobuf::reflection::WellKnownTypes::AnyConverter::get()]: Error. "
+                               "Unknown type '" + typeUrl + "' in field '" + info.descriptor->full_name() + "'.");
+    }
+
+    std::string valueScratch;
+    const auto& value = refl->GetStringReference(message, desc->field(1), &valueScratch);
+    auto proto = clazz->createProto();
+    if(!proto->ParseFromString(value)) {
+      throw std::runtime_error("[oatpp::protobuf::reflection::WellKnownTypes::AnyConverter::get()]: Error. "
+                               "Can't unpack '" + typeUrl + "' in field '" + info.descriptor->full_name() + "'.");
+    }
+
+    /* the object owns the unpacked proto - its strings are not copied once more */
+    auto object = DynamicObject::createShared(clazz, *proto, proto);
+    return AbstractDynamicObject(object, clazz->getType());
+
+  }
+
+  static void set(Message* message, const FieldInfo& info, const StaticType& value) {
+
+    auto handle = value.get();
+    if(handle == nullptr || !handle->ptr) {
+      return;
+    }
+
+    const oatpp::Type* type = handle->type;
+    if(type->classId.id != types::__class::AbstractObject::CLASS_ID.id ||
+       dynamic_cast<const DynamicClass::PolymorphicDispatcher*>(
+         static_cast<const types::__class::AbstractObject::PolymorphicDispatcher*>(type->polymorphicDispatcher)) == nullptr)
+    {
+      throw std::runtime_error("[oatpp::protobuf::reflection::WellKnownTypes::AnyConverter::set()]: Error. "
+                               "Field '" + info.descriptor->full_name() + "' accepts only proto objects.");
+    }
+
+    auto object = static_cast<DynamicObject*>(handle->ptr.get());
+    auto proto = object->toProto();
+
+    const Reflection* refl = message->GetReflection();
+    const google::protobuf::Descriptor* desc = message->GetDescriptor();
+    refl->SetString(message, desc->field(0), object->getClass()->getTypeUrl());
+    refl->SetString(message, desc->field(1), proto->SerializeAsString());
+
+  }
+
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Getters / Setters
+
+template<class C>
+oatpp::Void getField(const Reflection* refl, const Message& proto, const FieldInfo& info,
+                     const std::shared_ptr<const Message>& owner)
+{
+  if(refl->HasField(proto, info.descriptor)) {
+    return C::get(refl->GetMessage(proto, info.descriptor), info, owner);
+  }
+  return oatpp::Void(nullptr, info.type);
+}
+
+template<class C>
+void setField(const Reflection* refl, Message* proto, const FieldInfo& info, const oatpp::Void& value) {
+  C::set(refl->MutableMessage(proto, info.descriptor), info, value.staticCast<typename C::StaticType>());
+}
+
+template<class C>
+oatpp::Void getRepeatedField(const Reflection* refl, const Message& proto, const FieldInfo& info,
+                             const std::shared_ptr<const Message>& owner)
+{
+  typedef typename C::StaticType StaticType;
+  oatpp::Vector<StaticType> arr(std::make_shared<std::vector<StaticType>>(), info.type);
+  int size = refl->FieldSize(proto, info.descriptor);
+  arr->reserve(size);
+  for(int i = 0; i < size; i++) {
+    arr->push_back(C::get(refl->GetRepeatedMessage(proto, info.descriptor, i), info, owner));
+  }
+  return arr;
+}
+
+template<class C>
+void setRepeatedField(const Reflection* refl, Message* proto, const FieldInfo& info, const oatpp::Void& value) {
+  const auto& arr = value.staticCast<oatpp::Vector<typename C::StaticType>>();
+  refl->ClearField(proto, info.descriptor);
+  for(auto& item : *arr) {
+    /* null is a valid google.protobuf.Value - same as for other repeated fields, null elements of other types are an error */
+    if(!item && info.wellKnownType != WellKnownType::VALUE) {
+      throw std::runtime_error("[oatpp::protobuf::reflection::WellKnownTypes::setRepeatedField()]: Error. "
+                               "Null element of repeated field '" + info.descriptor->full_name() + "'.");
+    }
+    C::set(refl->AddMessage(proto, info.descriptor), info, item);
+  }
+}
+
+template<class C>
+oatpp::Void getMapField(const Reflection* refl, const Message& proto, const FieldInfo& info,
+                        const std::shared_ptr<const Message>& owner)
+{
+  typedef typename C::StaticType StaticType;
+  oatpp::UnorderedFields<StaticType> map(std::make_shared<std::unordered_map<oatpp::String, StaticType>>(), info.type);
+  int size = refl->FieldSize(proto, info.descriptor);
+  map->reserve(size);
+  for(int i = 0; i < size; i++) {
+    const Message& entry = refl->GetRepeatedMessage(proto, info.descriptor, i);
+    const Reflection* entryRefl = entry.GetReflection();
+    (*map)[Utils::getMapKey(entryRefl, entry, info.mapKey, owner)] =
+      C::get(entryRefl->GetMessage(entry, info.mapValue->descriptor), *info.mapValue, owner);
+  }
+  return map;
+}
+
+template<class C>
+void setMapField(const Reflection* refl, Message* proto, const FieldInfo& info, const oatpp::Void& value) {
+  const auto& map = value.staticCast<oatpp::UnorderedFields<typename C::StaticType>>();
+  refl->ClearField(proto, info.descriptor);
+  for(auto& pair : *map) {
+    if(!pair.first) {
+      continue;
+    }
+    Message* entry = refl->AddMessage(proto, info.descriptor);
+    const Reflection* entryRefl = entry->GetReflection();
+    if(!Utils::setMapKey(entryRefl, entry, info.mapKey, (const char*) pair.first->getData(), pair.first->getSize())) {
+      throw std::runtime_error("[oatpp::protobuf::reflection::WellKnownTypes::setMapField()]: Error. "
+                               "Invalid key '" + pair.first->std_str() + "' for field '" + info.descriptor->full_name() + "'.");
+    }
+    if(pair.second || info.mapValue->wellKnownType == WellKnownType::VALUE) {
+      C::set(entryRefl->MutableMessage(entry, info.mapValue->descriptor), *info.mapValue, pair.second);
+    }
+  }
+}
+
+/*
+ * `mapValue == nullptr` - plan for a singular or repeated field, else - plan for a map field.
+ */
+template<class C>
+FieldInfo createInfo(const FieldDescriptor* field, WellKnownType type, DynamicClass* nestedClass,
+                     const std::shared_ptr<const FieldInfo>& mapValue)
+{
+  typedef typename C::StaticType StaticType;
+  FieldInfo info;
+  info.descriptor = field;
+  info.nestedClass = nestedClass;
+  info.enumTable = nullptr;
+  info.mapKey = nullptr;
+  info.mapValue = mapValue;
+  if(mapValue) {
+    info.getter = &getMapField<C>;
+    info.setter = &setMapField<C>;
+    info.type = oatpp::UnorderedFields<StaticType>::Class::getType();
+    info.hasPresence = false;
+    info.mapKey = field->message_type()->map_key();
+    info.wellKnownType = WellKnownType::NONE;
+  } else if(field->is_repeated()) {
+    info.getter = &getRepeatedField<C>;
+    info.setter = &setRepeatedField<C>;
+    info.type = oatpp::Vector<StaticType>::Class::getType();
+    info.hasPresence = false;
+    info.wellKnownType = type;
+  } else {
+    info.getter = &getField<C>;
+    info.setter = &setField<C>;
+    info.type = StaticType::Class::getType();
+    info.hasPresence = field->has_presence();
+    info.wellKnownType = type;
+  }
+  return info;
+}
+
+FieldInfo createInfo(const FieldDescriptor* field, WellKnownType type, DynamicClass* nestedClass,
+                     const std::shared_ptr<const FieldInfo>& mapValue)
+{
+  switch(type) {
+    case WellKnownType::TIMESTAMP: return createInfo<TimestampConverter>(field, type, nestedClass, mapValue);
+    case WellKnownType::DURATION: return createInfo<DurationConverter>(field, type, nestedClass, mapValue);
+    case WellKnownType::FIELD_MASK: return createInfo<FieldMaskConverter>(field, type, nestedClass, mapValue);
+    case WellKnownType::DOUBLE_VALUE: return createInfo<WrapperConverter<v_float64>>(field, type, nestedClass, mapValue);
+    case WellKnownType::FLOAT_VALUE: return createInfo<WrapperConverter<v_float32>>(field, type, nestedClass, mapValue);
+    case WellKnownType::INT64_VALUE: return createInfo<WrapperConverter<v_int64>>(field, type, nestedClass, mapValue);
+    case WellKnownType::UINT64_VALUE: return createInfo<WrapperConverter<v_uint64>>(field, type, nestedClass, mapValue);
+    case WellKnownType::INT32_VALUE: return createInfo<WrapperConverter<v_int32>>(field, type, nestedClass, mapValue);
+    case WellKnownType::UINT32_VALUE: return createInfo<WrapperConverter<v_uint32>>(field, type, nestedClass, mapValue);
+    case WellKnownType::BOOL_VALUE: return createInfo<WrapperConverter<bool>>(field, type, nestedClass, mapValue);
+    case WellKnownType::STRING_VALUE:
+    case WellKnownType::BYTES_VALUE: return createInfo<WrapperConverter<std::string>>(field, type, nestedClass, mapValue);
+    case WellKnownType::STRUCT: return createInfo<StructConverter>(field, type, nestedClass, mapValue);
+    case WellKnownType::VALUE: return createInfo<ValueConverter>(field, type, nestedClass, mapValue);
+    case WellKnownType::LIST_VALUE: return createInfo<ListValueConverter>(field, type, nestedClass, mapValue);
+    case WellKnownType::ANY: return createInfo<AnyConverter>(field, type, nestedClass, mapValue);
+    default:
+      throw std::runtime_error("[oatpp::protobuf::reflection::WellKnownTypes::createInfo()]: "
+                               "Error. Not a well-known type - " + field->full_name());
+  }
+}
+
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// WellKnownTypes
+
+WellKnownType WellKnownTypes::getType(const google::protobuf::Descriptor* descriptor) {
+  switch(descriptor->well_known_type()) {
+    case google::protobuf::Descriptor::WELLKNOWNTYPE_TIMESTAMP: return WellKnownType::TIMESTAMP;
+    case google::protobuf::Descriptor::WELLKNOWNTYPE_DURATION: return WellKnownType::DURATION;
+    case google::protobuf::Descriptor::WELLKNOWNTYPE_FIELDMASK: return WellKnownType::FIELD_MASK;
+    case google::protobuf::Descriptor::WELLKNOWNTYPE_DOUBLEVALUE: return WellKnownType::DOUBLE_VALUE;
+    case google::protobuf::Descriptor::WELLKNOWNTYPE_FLOATVALUE: return WellKnownType::FLOAT_VALUE;
+    case google::protobuf::Descriptor::WELLKNOWNTYPE_INT64VALUE: return WellKnownType::INT64_VALUE;
+    case google::protobuf::Descriptor::WELLKNOWNTYPE_UINT64VALUE: return WellKnownType::UINT64_VALUE;
+    case google::protobuf::Descriptor::WELLKNOWNTYPE_INT32VALUE: return WellKnownType::INT32_VALUE;
+    case google::protobuf::Descriptor::WELLKNOWNTYPE_UINT32VALUE: return WellKnownType::UINT32_VALUE;
+    case google::protobuf::Descriptor::WELLKNOWNTYPE_BOOLVALUE: return WellKnownType::BOOL_VALUE;
+    case google::protobuf::Descriptor::WELLKNOWNTYPE_STRINGVALUE: return WellKnownType::STRING_VALUE;
+    case google::protobuf::Descriptor::WELLKNOWNTYPE_BYTESVALUE: return WellKnownType::BYTES_VALUE;
+    case google::protobuf::Descriptor::WELLKNOWNTYPE_STRUCT: return WellKnownType::STRUCT;
+    case google::protobuf::Descriptor::WELLKNOWNTYPE_VALUE: return WellKnownType::VALUE;
+    case google::protobuf::Descriptor::WELLKNOWNTYPE_LISTVALUE: return WellKnownType::LIST_VALUE;
+    case google::protobuf::Descriptor::WELLKNOWNTYPE_ANY: return WellKnownType::ANY;
+    default: return WellKnownType::NONE;
+  }
+}
+
+FieldInfo WellKnownTypes::createFieldInfo(const FieldDescriptor* field, WellKnownType type, DynamicClass* nestedClass) {
+  return createInfo(field, type, nestedClass, nullptr);
+}
+
+FieldInfo WellKnownTypes::createMapFieldInfo(const FieldDescriptor* field, const std::shared_ptr<const FieldInfo>& value) {
+  return createInfo(field, value->wellKnownType, value->nestedClass, value);
+}
+
+void WellKnownTypes::getTime(const Message& message, v_int64& seconds, v_int32& nanos) {
+  const Reflection* refl = message.GetReflection();
+  const google::protobuf::Descriptor* desc = message.GetDescriptor();
+  seconds = refl->GetInt64(message, desc->field(0));
+  nanos = refl->GetInt32(message, desc->field(1));
+}
+
+void WellKnownTypes::setTime(Message* message, v_int64 seconds, v_int32 nanos) {
+  const Reflection* refl = message->GetReflection();
+  const google::protobuf::Descriptor* desc = message->GetDescriptor();
+  refl->SetInt64(message, desc->field(0), seconds);
+  refl->SetInt32(message, desc->field(1), nanos);
+}
+
+v_buff_size WellKnownTypes::formatTimestamp(v_int64 seconds, v_int32 nanos, char* buffer) {
+
+  if(seconds < TIMESTAMP_MIN_SECONDS || seconds > TIMESTAMP_MAX_SECONDS || nanos < 0 || nanos >= NANOS_PER_SECOND) {
+    return -1;
+  }
+
+  v_int64 days = seconds / 86400;
+  v_int64 time = seconds % 86400;
+  if(time < 0) {
+    time += 86400;
+    days --;
+  }
+
+  v_int64 year, month, day;
+  civilFromDays(days, year, month, day);
+
+  char* p = buffer;
+  p = writeDigits(p, year, 4);
+  *p++ = '-';
+  p = writeDigits(p, month, 2);
+  *p++ = '-';
+  p = writeDigits(p, day, 2);
+  *p++ = 'T';
+  p = writeDigits(p, time / 3600, 2);
+  *p++ = ':';
+  p = writeDigits(p, time / 60 % 60, 2);
+  *p++ = ':';
+  p = writeDigits(p, time % 60, 2);
+  p = writeFraction(p, nanos);
+  *p++ = 'Z';
+
+  return p - buffer;
+
+}
+
+bool WellKnownTypes::parseTimestamp(const char* data, v_buff_size size, v_int64& seconds, v_int32& nanos) {
+
+  const char* p = data;
+  const char* end = data + size;
+  v_int64 year, month, day, hour, minute, second;
+
+  if(!readDigits(p, end, 4, year) || !readChar(p, end, '-') ||
+     !readDigits(p, end, 2, month) || !readChar(p, end, '-') ||
+     !readDigits(p, end, 2, day) || !(readChar(p, end, 'T') || readChar(p, end, 't')) ||
+     !readDigits(p, end, 2, hour) || !readChar(p, end, ':') ||
+     !readDigits(p, end, 2, minute) || !readChar(p, end, ':') ||
+     !readDigits(p, end, 2, second) || !readFraction(p, end, nanos))
+  {
+    return false;
+  }
+
+  v_int64 offset = 0;
+  if(!readChar(p, end, 'Z') && !readChar(p, end, 'z')) {
+    v_int64 sign;
+    if(readChar(p, end, '+')) {
+      sign = 1;
+    } else if(readChar(p, end, '-')) {
+      sign = -1;
+    } else {
+      return false;
+    }
+    v_int64 offsetHour, offsetMinute;
+    if(!readDigits(p, end, 2, offsetHour) || !readChar(p, end, ':') || !readDigits(p, end, 2, offsetMinute) ||
+       offsetHour > 23 || offsetMinute > 59)
+    {
+      return false;
+    }
+    offset = sign * (offsetHour * 3600 + offsetMinute * 60);
+  }
+
+  if(p != end || year < 1 || month < 1 || month > 12 || day < 1 || day > daysInMonth(year, month) ||
+     hour > 23 || minute > 59 || second > 59)
+  {
+    return false;
+  }
+
+  seconds = daysFromCivil(year, month, day) * 86400 + hour * 3600 + minute * 60 + second - offset;
+  return seconds >= TIMESTAMP_MIN_SECONDS && seconds <= TIMESTAMP_MAX_SECONDS;
+
+}
+
+v_buff_size WellKnownTypes::formatDuration(v_int64 seconds, v_int32 nanos, char* buffer) {
+
+  if(seconds < -DURATION_MAX_SECONDS || seconds > DURATION_MAX_SECONDS ||
+     nanos <= -NANOS_PER_SECOND || nanos >= NANOS_PER_SECOND ||
+     (seconds < 0 && nanos > 0) || (seconds > 0 && nanos < 0))
+  {
+    return -1;
+  }
+
+  char* p = buffer;
+  if(seconds < 0 || nanos < 0) {
+    *p++ = '-';
+    seconds = -seconds;
+    nanos = -nanos;
+  }
+
+  v_int32 width = 1;
+  for(v_int64 rest = seconds / 10; rest > 0; rest /= 10) {
+    width ++;
+  }
+  p = writeDigits(p, seconds, width);
+  p = writeFraction(p, nanos);
+  *p++ = 's';
+
+  return p - buffer;
+
+}
+
+bool WellKnownTypes::parseDuration(const char* data, v_buff_size size, v_int64& seconds, v_int32& nanos) {
+
+  const char* p = data;
+  const char* end = data + size;
+
+  bool negative = readChar(p, end, '-');
+
+  v_int64 value = 0;
+  v_int32 digits = 0;
+  while(p < end && *p >= '0' && *p <= '9') {
+    if(digits == 12) {
+      return false;
+    }
+    value = value * 10 + (*p - '0');
+    digits ++;
+    p ++;
+  }
+
+  if(digits == 0 || !readFraction(p, end, nanos) || !readChar(p, end, 's') || p != end || value > DURATION_MAX_SECONDS) {
+    return false;
+  }
+
+  seconds = negative ? -value : value;
+  if(negative) {
+    nanos = -nanos;
+  }
+  return true;
+
+}
+
+}}}
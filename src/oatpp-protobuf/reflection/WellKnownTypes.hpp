@@ -0,0 +1,139 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#ifndef oatpp_protobuf_reflection_WellKnownTypes_hpp
+#define oatpp_protobuf_reflection_WellKnownTypes_hpp
+
+#include "Utils.hpp"
+
+namespace oatpp { namespace protobuf { namespace reflection {
+
+/**
+ * Converters of the `google/protobuf` well-known types. <br>
+ * Fields of well-known types are mapped to native oatpp values instead of nested objects:
+ * <ul>
+ *   <li>`Timestamp` - `oatpp::String` in RFC 3339 format - `"1972-01-01T10:00:20.021Z"`.</li>
+ *   <li>`Duration` - `oatpp::String` - `"1.000340012s"`.</li>
+ *   <li>`FieldMask` - `oatpp::String` - comma-separated paths.</li>
+ *   <li>Wrappers (`Int64Value`, `StringValue`, ...) - nullable primitive of the wrapped type.</li>
+ *   <li>`Struct` - `oatpp::UnorderedFields<oatpp::Any>`, `Value` - `oatpp::Any`, `ListValue` - `oatpp::Vector<oatpp::Any>`.</li>
+ *   <li>`Any` - `oatpp::Any` holding the unpacked &id:oatpp::protobuf::reflection::DynamicObject; of the packed type.</li>
+ * </ul>
+ * Same representation is used by the json serializer and deserializer.
+ */
+class WellKnownTypes {
+public:
+
+  /**
+   * Buffer size sufficient for &l:WellKnownTypes::formatTimestamp (); and &l:WellKnownTypes::formatDuration ();.
+   */
+  static constexpr v_buff_size TIME_BUFFER_SIZE = 40;
+
+public:
+
+  /**
+   * Get well-known type of the message.
+   * @param descriptor - message descriptor.
+   * @return - &id:oatpp::protobuf::reflection::WellKnownType;. `NONE` if the message is not a supported well-known type.
+   */
+  static WellKnownType getType(const google::protobuf::Descriptor* descriptor);
+
+  /**
+   * Create conversion plan for the field of well-known type.
+   * @param field - singular or repeated message field.
+   * @param type - well-known type of the field message.
+   * @param nestedClass - class of the field message.
+   * @return - &id:oatpp::protobuf::reflection::FieldInfo;.
+   */
+  static FieldInfo createFieldInfo(const FieldDescriptor* field, WellKnownType type, DynamicClass* nestedClass);
+
+  /**
+   * Create conversion plan for the map field with values of well-known type.
+   * @param field - map field.
+   * @param value - conversion plan of the value field of the map entry.
+   * @return - &id:oatpp::protobuf::reflection::FieldInfo;.
+   */
+  static FieldInfo createMapFieldInfo(const FieldDescriptor* field, const std::shared_ptr<const FieldInfo>& value);
+
+  /**
+   * Read `seconds` and `nanos` of `Timestamp` or `Duration`.
+   * @param message - `Timestamp` or `Duration`.
+   * @param seconds
+   * @param nanos
+   */
+  static void getTime(const Message& message, v_int64& seconds, v_int32& nanos);
+
+  /**
+   * Write `seconds` and `nanos` of `Timestamp` or `Duration`.
+   * @param message - `Timestamp` or `Duration`.
+   * @param seconds
+   * @param nanos
+   */
+  static void setTime(Message* message, v_int64 seconds, v_int32 nanos);
+
+  /**
+   * Format timestamp as RFC 3339 UTC string. <br>
+   * Fractional seconds are written with 0, 3, 6 or 9 digits - whichever is enough.
+   * @param seconds - seconds since unix epoch.
+   * @param nanos - non-negative fraction of the second.
+   * @param buffer - at least &l:WellKnownTypes::TIME_BUFFER_SIZE; bytes.
+   * @return - size of the text. `-1` if the timestamp is out of `[0001-01-01, 9999-12-31]` range.
+   */
+  static v_buff_size formatTimestamp(v_int64 seconds, v_int32 nanos, char* buffer);
+
+  /**
+   * Parse RFC 3339 timestamp. Accepts `Z` and `+hh:mm`/`-hh:mm` offsets.
+   * @param data
+   * @param size
+   * @param seconds - seconds since unix epoch.
+   * @param nanos - fraction of the second.
+   * @return - `false` if the text is not a valid timestamp.
+   */
+  static bool parseTimestamp(const char* data, v_buff_size size, v_int64& seconds, v_int32& nanos);
+
+  /**
+   * Format duration as seconds with `s` suffix - `"-1.5s"`.
+   * @param seconds
+   * @param nanos - same sign as `seconds`.
+   * @param buffer - at least &l:WellKnownTypes::TIME_BUFFER_SIZE; bytes.
+   * @return - size of the text. `-1` if the duration is out of the `+-10000` years range.
+   */
+  static v_buff_size formatDuration(v_int64 seconds, v_int32 nanos, char* buffer);
+
+  /**
+   * Parse duration written as seconds with `s` suffix.
+   * @param data
+   * @param size
+   * @param seconds
+   * @param nanos
+   * @return - `false` if the text is not a valid duration.
+   */
+  static bool parseDuration(const char* data, v_buff_size size, v_int64& seconds, v_int32& nanos);
+
+};
+
+}}}
+
+#endif // oatpp_protobuf_reflection_WellKnownTypes_hpp
@@ -0,0 +1,179 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#ifndef oatpp_protobuf_web_BodyReader_hpp
+#define oatpp_protobuf_web_BodyReader_hpp
+
+#include "oatpp-protobuf/io/MessageParser.hpp"
+#include "oatpp-protobuf/io/MessageStream.hpp"
+
+#include "oatpp/core/async/Coroutine.hpp"
+
+namespace oatpp { namespace protobuf { namespace web {
+
+/**
+ * Reader of binary protobuf bodies. <br>
+ * Body is parsed incrementally as it's being received - see &id:oatpp::protobuf::io::MessageParser;. <br>
+ * Works with any incoming message which has `transferBody()/transferBodyAsync()` methods -
+ * `oatpp::web::protocol::http::incoming::Request` and `oatpp::web::protocol::http::incoming::Response`.
+ */
+class BodyReader {
+private:
+
+  template<class T, class Incoming>
+  class ReadBodyCoroutine : public async::CoroutineWithResult<ReadBodyCoroutine<T, Incoming>, const Object<T>&> {
+  private:
+    std::shared_ptr<Incoming> m_incoming;
+    std::shared_ptr<google::protobuf::Arena> m_arena;
+    std::shared_ptr<io::MessageParser> m_parser;
+  public:
+
+    ReadBodyCoroutine(const std::shared_ptr<Incoming>& incoming, const std::shared_ptr<google::protobuf::Arena>& arena)
+      : m_incoming(incoming)
+      , m_arena(arena)
+    {}
+
+    async::Action act() override {
+      m_parser = std::make_shared<io::MessageParser>(Object<T>::Class::getType(), m_arena);
+      return m_incoming->transferBodyAsync(m_parser).next(this->yieldTo(&ReadBodyCoroutine::onBodyRead));
+    }
+
+    async::Action onBodyRead() {
+      if(!m_parser->finish()) {
+        return this->template error<async::Error>(m_parser->getErrorMessage());
+      }
+      return this->_return(m_parser->getObject().template staticCast<Object<T>>());
+    }
+
+  };
+
+  template<class T, class Incoming>
+  class ReadMessageStreamCoroutine : public async::Coroutine<ReadMessageStreamCoroutine<T, Incoming>> {
+  private:
+    std::shared_ptr<Incoming> m_incoming;
+    std::shared_ptr<io::MessageStreamParser> m_parser;
+  public:
+
+    ReadMessageStreamCoroutine(const std::shared_ptr<Incoming>& incoming,
+                               const std::shared_ptr<io::MessageStreamParser::Listener>& listener)
+      : m_incoming(incoming)
+      , m_parser(std::make_shared<io::MessageStreamParser>(Object<T>::Class::getType(), listener))
+    {}
+
+    async::Action act() override {
+      return m_incoming->transferBodyAsync(m_parser).next(this->yieldTo(&ReadMessageStreamCoroutine::onBodyRead));
+    }
+
+    async::Action onBodyRead() {
+      if(!m_parser->finish()) {
+        return this->template error<async::Error>(m_parser->getErrorMessage());
+      }
+      return this->finish();
+    }
+
+  };
+
+public:
+
+  /**
+   * Read body and parse it to proto object.
+   * @tparam T - proto message type.
+   * @tparam Incoming - incoming request or response type.
+   * @param incoming - incoming request or response.
+   * @param arena - if not `nullptr` - the object is created on this arena. Ex.: arena tied to the request.
+   * @return - &id:oatpp::protobuf::Object;.
+   * @throws - `std::runtime_error` on parsing error.
+   */
+  template<class T, class Incoming>
+  static Object<T> readBody(const std::shared_ptr<Incoming>& incoming,
+                            const std::shared_ptr<google::protobuf::Arena>& arena = nullptr)
+  {
+    io::MessageParser parser(Object<T>::Class::getType(), arena);
+    incoming->transferBody(&parser);
+    if(!parser.finish()) {
+      throw std::runtime_error(parser.getErrorMessage());
+    }
+    return parser.getObject().template staticCast<Object<T>>();
+  }
+
+  /**
+   * Read body and parse it to proto object in Async manner. <br>
+   * Body chunks are parsed as they arrive - nested messages are parsed in place and at most one
+   * leaf record (ex.: one `bytes` value) is buffered at a time.
+   * @tparam T - proto message type.
+   * @tparam Incoming - incoming request or response type.
+   * @param incoming - incoming request or response.
+   * @param arena - if not `nullptr` - the object is created on this arena. Ex.: arena tied to the request.
+   * @return - &id:oatpp::async::CoroutineStarterForResult;.
+   */
+  template<class T, class Incoming>
+  static async::CoroutineStarterForResult<const Object<T>&>
+  readBodyAsync(const std::shared_ptr<Incoming>& incoming, const std::shared_ptr<google::protobuf::Arena>& arena = nullptr) {
+    return ReadBodyCoroutine<T, Incoming>::startForResult(incoming, arena);
+  }
+
+  /**
+   * Read body which is a stream of varint length-delimited proto messages - see &id:oatpp::protobuf::io::MessageStreamParser;. <br>
+   * Each message is passed to the listener as soon as it's received - the body is never buffered.
+   * @tparam T - proto message type.
+   * @tparam Incoming - incoming request or response type.
+   * @param incoming - incoming request or response.
+   * @param listener - &id:oatpp::protobuf::io::MessageStreamParser::Listener;. Called on the reading thread.
+   * @return - number of messages read.
+   * @throws - `std::runtime_error` on parsing error. Messages preceding the error are passed to the listener.
+   */
+  template<class T, class Incoming>
+  static v_int64 readMessageStream(const std::shared_ptr<Incoming>& incoming,
+                                   const std::shared_ptr<io::MessageStreamParser::Listener>& listener)
+  {
+    io::MessageStreamParser parser(Object<T>::Class::getType(), listener);
+    incoming->transferBody(&parser);
+    if(!parser.finish()) {
+      throw std::runtime_error(parser.getErrorMessage());
+    }
+    return parser.getMessagesCount();
+  }
+
+  /**
+   * Read body which is a stream of varint length-delimited proto messages in Async manner. <br>
+   * Reading of the body is suspended while the action returned by the listener is being done.
+   * @tparam T - proto message type.
+   * @tparam Incoming - incoming request or response type.
+   * @param incoming - incoming request or response.
+   * @param listener - &id:oatpp::protobuf::io::MessageStreamParser::Listener;.
+   * @return - &id:oatpp::async::CoroutineStarter;.
+   */
+  template<class T, class Incoming>
+  static async::CoroutineStarter readMessageStreamAsync(const std::shared_ptr<Incoming>& incoming,
+                                                        const std::shared_ptr<io::MessageStreamParser::Listener>& listener)
+  {
+    return ReadMessageStreamCoroutine<T, Incoming>::start(incoming, listener);
+  }
+
+};
+
+}}}
+
+#endif // oatpp_protobuf_web_BodyReader_hpp
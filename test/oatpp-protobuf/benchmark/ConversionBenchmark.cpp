@@ -0,0 +1,259 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#include "ConversionBenchmark.hpp"
+
+#include "benchmark.oatpp.hpp"
+
+#include "oatpp/core/data/stream/BufferStream.hpp"
+
+#include <google/protobuf/util/json_util.h>
+
+#include <algorithm>
+#include <chrono>
+
+namespace oatpp { namespace protobuf { namespace benchmark {
+
+namespace {
+
+typedef oatpp::parser::json::mapping::Serializer JsonSerializer;
+typedef oatpp::parser::json::mapping::Deserializer JsonDeserializer;
+typedef std::chrono::duration<v_float64, std::micro> Microseconds;
+
+const v_int32 WARMUP_ITERATIONS = 10;
+const v_int32 MIN_ITERATIONS = 20;
+const v_int32 MAX_ITERATIONS = 200000;
+const v_float64 TIME_BUDGET_SEC = 0.5;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Message shapes
+
+::test::benchmark::Flat createFlat() {
+  ::test::benchmark::Flat message;
+  message.set_id(12345);
+  message.set_timestamp(1602900000123LL);
+  message.set_name("flat message");
+  message.set_description("a message with a handful of scalar fields");
+  message.set_price(99.95);
+  message.set_ratio(0.75f);
+  message.set_active(true);
+  message.set_count(42);
+  message.set_color(::test::benchmark::BLUE);
+  return message;
+}
+
+::test::benchmark::Nested createNested() {
+  ::test::benchmark::Nested message;
+  ::test::benchmark::Nested* curr = &message;
+  for(v_int32 i = 0; i < 64; i ++) {
+    curr->set_depth(i);
+    curr->set_label("level");
+    curr = curr->mutable_child();
+  }
+  return message;
+}
+
+::test::benchmark::Wide createWide() {
+  ::test::benchmark::Wide message;
+  const google::protobuf::Reflection* refl = message.GetReflection();
+  const google::protobuf::Descriptor* desc = message.GetDescriptor();
+  for(v_int32 i = 0; i < desc->field_count(); i ++) {
+    const google::protobuf::FieldDescriptor* field = desc->field(i);
+    switch(field->cpp_type()) {
+      case google::protobuf::FieldDescriptor::CPPTYPE_INT32: refl->SetInt32(&message, field, i + 1); break;
+      case google::protobuf::FieldDescriptor::CPPTYPE_INT64: refl->SetInt64(&message, field, (i + 1) * 1000000007LL); break;
+      case google::protobuf::FieldDescriptor::CPPTYPE_DOUBLE: refl->SetDouble(&message, field, i * 0.5 + 0.25); break;
+      case google::protobuf::FieldDescriptor::CPPTYPE_BOOL: refl->SetBool(&message, field, true); break;
+      case google::protobuf::FieldDescriptor::CPPTYPE_STRING: refl->SetString(&message, field, "value-" + std::to_string(i)); break;
+      default: break;
+    }
+  }
+  return message;
+}
+
+::test::benchmark::LargeScalars createLargeScalars() {
+  ::test::benchmark::LargeScalars message;
+  for(v_int32 i = 0; i < 10000; i ++) {
+    message.add_ints(i * 7 - 35000);
+    message.add_longs(i * 1000000007LL);
+    message.add_doubles(i * 0.125);
+    message.add_flags((i & 1) == 0);
+  }
+  return message;
+}
+
+::test::benchmark::LargeBytes createLargeBytes() {
+  ::test::benchmark::LargeBytes message;
+  message.set_name("blob");
+  std::string data(1024 * 1024, 'a');
+  for(std::size_t i = 0; i < data.size(); i ++) {
+    data[i] = (char) ('a' + i % 26);
+  }
+  message.set_data(std::move(data));
+  return message;
+}
+
+::test::benchmark::EnumHeavy createEnumHeavy() {
+  ::test::benchmark::EnumHeavy message;
+  message.set_primary(::test::benchmark::RED);
+  message.set_secondary(::test::benchmark::MAGENTA);
+  for(v_int32 i = 0; i < 1000; i ++) {
+    message.add_palette((::test::benchmark::Color) (1 + i % 7));
+    message.add_history((::test::benchmark::Color) (i % 8));
+  }
+  return message;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Measurement
+
+template<class F>
+void measure(const char* TAG, const char* shape, const char* name, v_buff_size bytesPerOp, const F& operation) {
+
+  for(v_int32 i = 0; i < WARMUP_ITERATIONS; i ++) {
+    operation();
+  }
+
+  std::vector<v_float64> latencies;
+  latencies.reserve(1024);
+
+  auto start = std::chrono::steady_clock::now();
+  v_float64 elapsed = 0;
+
+  while((elapsed < TIME_BUDGET_SEC || (v_int32) latencies.size() < MIN_ITERATIONS) &&
+        (v_int32) latencies.size() < MAX_ITERATIONS)
+  {
+    auto opStart = std::chrono::steady_clock::now();
+    operation();
+    auto opEnd = std::chrono::steady_clock::now();
+    latencies.push_back(Microseconds(opEnd - opStart).count());
+    elapsed = std::chrono::duration<v_float64>(opEnd - start).count();
+  }
+
+  std::sort(latencies.begin(), latencies.end());
+  v_float64 p50 = latencies[latencies.size() / 2];
+  v_float64 p99 = latencies[std::min(latencies.size() - 1, latencies.size() * 99 / 100)];
+
+  v_float64 messagesPerSec = latencies.size() / elapsed;
+  v_float64 mbPerSec = messagesPerSec * bytesPerOp / (1024.0 * 1024.0);
+
+  OATPP_LOGD(TAG, "%-14s %-28s msg/s=%12.1f MB/s=%9.2f p50=%10.2fus p99=%10.2fus",
+             shape, name, messagesPerSec, mbPerSec, p50, p99);
+
+}
+
+template<class T>
+void runShape(const char* TAG, const char* shape, const T& message) {
+
+  JsonSerializer serializer;
+  JsonDeserializer deserializer;
+
+  reflection::DynamicClass* clazz = reflection::DynamicClass::registryGetClass<T>();
+  const codec::AbstractCodec* codec = codec::Codec<T>::getInstance();
+
+  oatpp::data::stream::BufferOutputStream stream;
+  json::Serializer::serializeMessage(&serializer, &stream, message, clazz);
+  oatpp::String json = stream.toString();
+
+  google::protobuf::util::JsonPrintOptions printOptions;
+  printOptions.preserve_proto_field_names = true;
+  std::string protobufJson;
+  google::protobuf::util::MessageToJsonString(message, &protobufJson, printOptions);
+
+  v_buff_size protoSize = message.ByteSizeLong();
+
+  /* proto -> json */
+
+  measure(TAG, shape, "proto->json (reflection)", json->getSize(), [&] {
+    stream.setCurrentPosition(0);
+    json::Serializer::serializeMessage(&serializer, &stream, message, clazz);
+  });
+
+  measure(TAG, shape, "proto->json (codec)", json->getSize(), [&] {
+    stream.setCurrentPosition(0);
+    codec->writeJson(&serializer, &stream, message);
+  });
+
+  measure(TAG, shape, "proto->json (libprotobuf)", protobufJson.size(), [&] {
+    std::string out;
+    google::protobuf::util::MessageToJsonString(message, &out, printOptions);
+  });
+
+  /* json -> proto */
+
+  T parsed;
+
+  measure(TAG, shape, "json->proto (reflection)", json->getSize(), [&] {
+    parsed.Clear();
+    oatpp::parser::Caret caret(json);
+    json::Deserializer::deserializeMessage(&deserializer, caret, parsed, clazz);
+  });
+
+  measure(TAG, shape, "json->proto (codec)", json->getSize(), [&] {
+    parsed.Clear();
+    oatpp::parser::Caret caret(json);
+    codec->readJson(&deserializer, caret, parsed);
+  });
+
+  measure(TAG, shape, "json->proto (libprotobuf)", protobufJson.size(), [&] {
+    parsed.Clear();
+    google::protobuf::util::JsonStringToMessage(protobufJson, &parsed);
+  });
+
+  /* proto -> DynamicObject */
+
+  measure(TAG, shape, "proto->DynamicObject", protoSize, [&] {
+    reflection::DynamicObject::createShared(clazz, message);
+  });
+
+  auto owner = std::make_shared<T>(message);
+
+  measure(TAG, shape, "proto->DynamicObject (zc)", protoSize, [&] {
+    reflection::DynamicObject::createShared(clazz, *owner, owner);
+  });
+
+  reflection::DynamicObject::setPoolCapacity(64);
+
+  measure(TAG, shape, "proto->DynamicObject (pool)", protoSize, [&] {
+    reflection::DynamicObject::createShared(clazz, message);
+  });
+
+  reflection::DynamicObject::setPoolCapacity(0);
+  reflection::DynamicObject::clearPool();
+
+}
+
+}
+
+void ConversionBenchmark::onRun() {
+  runShape(TAG, "flat", createFlat());
+  runShape(TAG, "nested(64)", createNested());
+  runShape(TAG, "wide(120)", createWide());
+  runShape(TAG, "scalars(4x10k)", createLargeScalars());
+  runShape(TAG, "bytes(1MB)", createLargeBytes());
+  runShape(TAG, "enums(2x1k)", createEnumHeavy());
+}
+
+}}}
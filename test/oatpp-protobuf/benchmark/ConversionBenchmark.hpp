@@ -0,0 +1,50 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#ifndef oatpp_protobuf_benchmark_ConversionBenchmark_hpp
+#define oatpp_protobuf_benchmark_ConversionBenchmark_hpp
+
+#include "oatpp-test/UnitTest.hpp"
+
+namespace oatpp { namespace protobuf { namespace benchmark {
+
+/**
+ * Measures conversion throughput (messages/sec, MB/sec) and p50/p99 latency
+ * for a set of message shapes: proto->json, json->proto and proto->DynamicObject. <br>
+ * Json conversions are measured via reflection, via generated codecs and via libprotobuf `util` json functions.
+ */
+class ConversionBenchmark : public oatpp::test::UnitTest {
+public:
+
+  ConversionBenchmark() : UnitTest("BENCH[protobuf::ConversionBenchmark]")
+  {}
+
+  void onRun() override;
+
+};
+
+}}}
+
+#endif // oatpp_protobuf_benchmark_ConversionBenchmark_hpp
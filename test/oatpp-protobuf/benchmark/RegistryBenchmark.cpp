@@ -0,0 +1,94 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#include "RegistryBenchmark.hpp"
+
+#include "oatpp-protobuf/reflection/DynamicObject.hpp"
+
+#include "test.pb.h"
+
+#include <chrono>
+#include <thread>
+
+namespace oatpp { namespace protobuf { namespace benchmark {
+
+namespace {
+
+const v_int64 LOOKUPS_PER_THREAD = 10000000;
+
+v_float64 runLookups(v_int32 threadsCount) {
+
+  const google::protobuf::Descriptor* descriptors[] = {
+    ::test::Image::GetDescriptor(),
+    ::test::ImageRotateRequest::GetDescriptor()
+  };
+
+  std::atomic<v_int64> checksum(0);
+  std::vector<std::thread> threads;
+
+  auto start = std::chrono::steady_clock::now();
+
+  for(v_int32 t = 0; t < threadsCount; t++) {
+    threads.push_back(std::thread([&descriptors, &checksum]{
+      v_int64 sum = 0;
+      for(v_int64 i = 0; i < LOOKUPS_PER_THREAD; i++) {
+        auto clazz = reflection::DynamicClass::registryGetClass(descriptors[i & 1]);
+        sum += (clazz != nullptr);
+      }
+      checksum += sum;
+    }));
+  }
+
+  for(auto& thread : threads) {
+    thread.join();
+  }
+
+  auto elapsed = std::chrono::duration_cast<std::chrono::duration<v_float64>>(std::chrono::steady_clock::now() - start);
+  OATPP_ASSERT(checksum.load() == LOOKUPS_PER_THREAD * threadsCount);
+
+  return (LOOKUPS_PER_THREAD * threadsCount) / elapsed.count();
+
+}
+
+}
+
+void RegistryBenchmark::onRun() {
+
+  v_int32 maxThreads = std::thread::hardware_concurrency();
+  if(maxThreads < 1) {
+    maxThreads = 1;
+  }
+
+  v_float64 baseline = runLookups(1);
+  OATPP_LOGD(TAG, "threads=%d, lookups/sec=%.0f, scaling=1.00", 1, baseline);
+
+  for(v_int32 threadsCount = 2; threadsCount <= maxThreads; threadsCount *= 2) {
+    v_float64 lookups = runLookups(threadsCount);
+    OATPP_LOGD(TAG, "threads=%d, lookups/sec=%.0f, scaling=%.2f (ideal %d)", threadsCount, lookups, lookups / baseline, threadsCount);
+  }
+
+}
+
+}}}
@@ -0,0 +1,28 @@
+#include "oatpp-protobuf/benchmark/ConversionBenchmark.hpp"
+#include "oatpp-protobuf/benchmark/RegistryBenchmark.hpp"
+
+#include <iostream>
+
+namespace {
+
+void runBenchmarks() {
+  OATPP_RUN_TEST(oatpp::protobuf::benchmark::RegistryBenchmark);
+  OATPP_RUN_TEST(oatpp::protobuf::benchmark::ConversionBenchmark);
+}
+
+}
+
+int main() {
+
+  oatpp::base::Environment::init();
+
+  runBenchmarks();
+
+  std::cout << "\nEnvironment:\n";
+  std::cout << "objectsCount = " << oatpp::base::Environment::getObjectsCount() << "\n";
+  std::cout << "objectsCreated = " << oatpp::base::Environment::getObjectsCreated() << "\n\n";
+
+  oatpp::base::Environment::destroy();
+
+  return 0;
+}
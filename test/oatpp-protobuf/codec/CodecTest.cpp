@@ -0,0 +1,227 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#include "CodecTest.hpp"
+
+#include "codec.oatpp.hpp"
+#include "legacy.oatpp.hpp"
+
+#include "oatpp/parser/json/mapping/ObjectMapper.hpp"
+#include "oatpp/core/data/stream/BufferStream.hpp"
+
+#include <google/protobuf/util/message_differencer.h>
+
+namespace oatpp { namespace protobuf { namespace codec {
+
+namespace {
+
+typedef oatpp::protobuf::Object<::test::codec::Shape> Shape;
+typedef google::protobuf::util::MessageDifferencer MessageDifferencer;
+
+Shape createShape() {
+
+  Shape shape = std::make_shared<::test::codec::Shape>();
+
+  shape->set_name("Hello \"World\"!\n/\x01");
+  shape->set_kind(::test::codec::Shape_Kind_POLYGON);
+
+  auto point = shape->add_points();
+  point->set_x(1.5);
+  point->set_y(-2);
+  shape->add_points();
+
+  shape->add_labels("a");
+  shape->add_labels("");
+
+  shape->add_kinds(::test::codec::Shape_Kind_CIRCLE);
+  shape->add_kinds(::test::codec::Shape_Kind_UNKNOWN);
+
+  shape->set_id(-1234567890123LL);
+  shape->set_version(18446744073709551615ULL);
+  shape->set_layer(7);
+  shape->set_visible(true);
+  shape->set_payload("\xD0\x9F\xD1\x80");
+  shape->mutable_style()->set_color("red");
+  shape->set_zindex(0);
+  (*shape->mutable_tags())["tag"] = 1;
+  shape->mutable_texture()->set_width(240);
+  shape->add_weights(0.25);
+  shape->set_area("large");
+  shape->set_new_(42);
+
+  return shape;
+
+}
+
+/*
+ * Reflection-based serialization of the same message.
+ */
+oatpp::String serializeViaReflection(oatpp::parser::json::mapping::Serializer* serializer, const Shape& shape) {
+  oatpp::data::stream::BufferOutputStream stream;
+  json::Serializer::serializeMessage(serializer, &stream, *shape,
+                                     reflection::DynamicClass::registryGetClass<::test::codec::Shape>());
+  return stream.toString();
+}
+
+void checkSerializer(const char* TAG, bool includeNullFields, bool enumsAsInt,
+                     json::Serializer::DefaultValues defaultValues = json::Serializer::DefaultValues::AS_NULL)
+{
+
+  auto shape = createShape();
+
+  auto config = json::Serializer::Config::createShared();
+  config->includeNullFields = includeNullFields;
+  config->enumsAsInt = enumsAsInt;
+  config->defaultValues = defaultValues;
+
+  oatpp::parser::json::mapping::ObjectMapper mapper(
+    config, oatpp::parser::json::mapping::Deserializer::Config::createShared()
+  );
+  json::Serializer::enable(mapper.getSerializer().get());
+
+  auto json1 = mapper.writeToString(shape);
+  auto json2 = serializeViaReflection(mapper.getSerializer().get(), shape);
+
+  OATPP_LOGD(TAG, "json='%s'", json1->c_str());
+  OATPP_ASSERT(json1 == json2);
+
+  Shape emptyShape = std::make_shared<::test::codec::Shape>();
+  OATPP_ASSERT(mapper.writeToString(emptyShape) == serializeViaReflection(mapper.getSerializer().get(), emptyShape));
+
+}
+
+/*
+ * Deserialize the same json via generated codec and via reflection. Both must agree on the result.
+ */
+void checkClosedEnum(oatpp::parser::json::mapping::ObjectMapper& mapper, const char* json, bool valid) {
+
+  typedef oatpp::protobuf::Object<::test::legacy::Alarm> Alarm;
+
+  oatpp::parser::Caret codecCaret(json);
+  auto codecAlarm = mapper.read(codecCaret, Alarm::Class::getType()).staticCast<Alarm>();
+
+  ::test::legacy::Alarm reflectionAlarm;
+  oatpp::parser::Caret reflectionCaret(json);
+  json::Deserializer::deserializeMessage(mapper.getDeserializer().get(), reflectionCaret, reflectionAlarm,
+                                         reflection::DynamicClass::registryGetClass<::test::legacy::Alarm>());
+
+  OATPP_ASSERT(codecCaret.hasError() == !valid);
+  OATPP_ASSERT(reflectionCaret.hasError() == !valid);
+
+  if(valid) {
+    OATPP_ASSERT(codecAlarm);
+    OATPP_ASSERT(MessageDifferencer::Equals(*codecAlarm, reflectionAlarm));
+    OATPP_ASSERT(codecAlarm->unknown_fields().empty());
+  } else {
+    OATPP_ASSERT(!codecAlarm);
+  }
+
+}
+
+}
+
+void CodecTest::onRun() {
+
+  {
+    auto dispatcher = static_cast<const __class::AbstractObject::PolymorphicDispatcher*>(Shape::Class::getType()->polymorphicDispatcher);
+    OATPP_ASSERT(dispatcher->getCodec() == Codec<::test::codec::Shape>::getInstance());
+    OATPP_ASSERT(dispatcher->getCodec() != nullptr);
+  }
+
+  checkSerializer(TAG, true, false);
+  checkSerializer(TAG, false, false);
+  checkSerializer(TAG, false, true);
+  checkSerializer(TAG, true, false, json::Serializer::DefaultValues::OMIT);
+  checkSerializer(TAG, true, false, json::Serializer::DefaultValues::EMIT);
+  checkSerializer(TAG, false, false, json::Serializer::DefaultValues::EMIT);
+
+  oatpp::parser::json::mapping::ObjectMapper mapper;
+  json::Serializer::enable(mapper.getSerializer().get());
+  json::Deserializer::enable(mapper.getDeserializer().get());
+
+  auto shape = createShape();
+  auto json = mapper.writeToString(shape);
+
+  {
+    auto clone = mapper.readFromString<Shape>(json);
+    OATPP_ASSERT(clone);
+    OATPP_ASSERT(MessageDifferencer::Equals(*shape, *clone));
+
+    ::test::codec::Shape reflectionClone;
+    oatpp::parser::Caret caret(json);
+    json::Deserializer::deserializeMessage(mapper.getDeserializer().get(), caret, reflectionClone,
+                                           reflection::DynamicClass::registryGetClass<::test::codec::Shape>());
+    OATPP_ASSERT(!caret.hasError());
+    OATPP_ASSERT(MessageDifferencer::Equals(reflectionClone, *clone));
+  }
+
+  {
+    auto clone = mapper.readFromString<Shape>(
+      "{\"unknown\": [1, {\"a\": \"]\"}], \"kind\": 2, \"kinds\": [\"POLYGON\", null, \"7\"], \"zIndex\": null, "
+      "\"radius\": 2.5, \"labels\": null, \"weights\": [1, null, 2]}"
+    );
+    OATPP_ASSERT(clone);
+    OATPP_ASSERT(clone->kind() == ::test::codec::Shape_Kind_CIRCLE);
+    OATPP_ASSERT(clone->kinds_size() == 2);
+    OATPP_ASSERT(clone->kinds(0) == ::test::codec::Shape_Kind_POLYGON);
+    OATPP_ASSERT(clone->kinds(1) == 7);
+    OATPP_ASSERT(!clone->has_zindex());
+    OATPP_ASSERT(clone->radius() == 2.5);
+    OATPP_ASSERT(clone->weights_size() == 2);
+  }
+
+  {
+    oatpp::parser::Caret caret("{\"kind\": \"NO_SUCH_KIND\"}");
+    auto clone = mapper.read(caret, Shape::Class::getType());
+    OATPP_ASSERT(!clone);
+    OATPP_ASSERT(caret.hasError());
+  }
+
+  {
+    mapper.getDeserializer()->getConfig()->allowUnknownFields = false;
+    oatpp::parser::Caret caret("{\"unknown\": 1}");
+    auto clone = mapper.read(caret, Shape::Class::getType());
+    OATPP_ASSERT(!clone);
+    OATPP_ASSERT(caret.hasError());
+  }
+
+  {
+    OATPP_ASSERT(Codec<::test::legacy::Alarm>::getInstance() != nullptr);
+    checkClosedEnum(mapper, "{\"name\": \"a\", \"level\": \"CRITICAL\", \"history\": [1, \"HIGH\", \"5\"]}", true);
+    checkClosedEnum(mapper, "{\"level\": 3}", false);
+    checkClosedEnum(mapper, "{\"level\": \"3\"}", false);
+    checkClosedEnum(mapper, "{\"history\": [1, 4]}", false);
+    checkClosedEnum(mapper, "{\"level\": \"NO_SUCH_LEVEL\"}", false);
+  }
+
+  {
+    oatpp::protobuf::Object<::test::codec::Empty> empty = std::make_shared<::test::codec::Empty>();
+    OATPP_ASSERT(mapper.writeToString(empty) == "{}");
+    OATPP_ASSERT(mapper.readFromString<oatpp::protobuf::Object<::test::codec::Empty>>("{}"));
+  }
+
+}
+
+}}}
@@ -0,0 +1,154 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#include "MessageParserTest.hpp"
+
+#include "oatpp-protobuf/web/BodyReader.hpp"
+
+#include "test.pb.h"
+
+#include <google/protobuf/util/message_differencer.h>
+
+namespace oatpp { namespace protobuf { namespace io {
+
+namespace {
+
+typedef oatpp::protobuf::Object<::test::ImageRotateRequest> Request;
+
+/*
+ * Incoming message which transfers its body in chunks of fixed size.
+ */
+class ChunkedIncoming {
+private:
+  std::string m_body;
+  v_buff_size m_chunkSize;
+public:
+
+  ChunkedIncoming(const std::string& body, v_buff_size chunkSize)
+    : m_body(body)
+    , m_chunkSize(chunkSize)
+  {}
+
+  void transferBody(oatpp::data::stream::WriteCallback* writeCallback) const {
+    v_buff_size pos = 0;
+    while(pos < (v_buff_size) m_body.size()) {
+      v_buff_size size = m_body.size() - pos;
+      if(size > m_chunkSize) size = m_chunkSize;
+      writeCallback->writeSimple(m_body.data() + pos, size);
+      pos += size;
+    }
+  }
+
+};
+
+}
+
+void MessageParserTest::onRun() {
+
+  typedef google::protobuf::util::MessageDifferencer MessageDifferencer;
+
+  Request req = std::make_shared<::test::ImageRotateRequest>();
+
+  req->add_rotation(::test::ImageRotateRequest_Rotation_NINETY_DEG);
+  req->add_rotation(::test::ImageRotateRequest_Rotation_TWO_SEVENTY_DEG);
+
+  for(v_int32 i = 0; i < 10; i ++) {
+    auto image = req->add_image();
+    image->set_color(i % 2 == 0);
+    image->set_data(std::string(100 * i * i, 'a' + i));
+    image->set_width(-i);
+    image->set_height(i * 1000);
+  }
+
+  req->add_intarr(-7);
+  req->add_intarr(42);
+
+  auto body = req->SerializeAsString();
+
+  std::vector<v_buff_size> chunkSizes = {1, 2, 3, 7, 128, 4096, (v_buff_size) body.size()};
+
+  for(v_buff_size chunkSize : chunkSizes) {
+    OATPP_LOGI(TAG, "chunk size %d...", (v_int32) chunkSize);
+    auto incoming = std::make_shared<ChunkedIncoming>(body, chunkSize);
+    auto clone = oatpp::protobuf::web::BodyReader::readBody<::test::ImageRotateRequest>(incoming);
+    OATPP_ASSERT(clone);
+    OATPP_ASSERT(MessageDifferencer::Equals(*req, *clone));
+    OATPP_LOGI(TAG, "OK");
+  }
+
+  {
+    OATPP_LOGI(TAG, "large nested bytes...");
+    Request large = std::make_shared<::test::ImageRotateRequest>();
+    large->mutable_preview()->set_data(std::string(1024 * 1024, 'x'));
+    large->mutable_preview()->set_width(1024);
+    large->add_image()->set_data(std::string(64 * 1024, 'y'));
+    auto largeBody = large->SerializeAsString();
+    auto incoming = std::make_shared<ChunkedIncoming>(largeBody, 4096);
+    auto clone = oatpp::protobuf::web::BodyReader::readBody<::test::ImageRotateRequest>(incoming);
+    OATPP_ASSERT(clone);
+    OATPP_ASSERT(MessageDifferencer::Equals(*large, *clone));
+    OATPP_LOGI(TAG, "OK");
+  }
+
+  {
+    OATPP_LOGI(TAG, "nested record exceeds the enclosing message...");
+    const char data[] = "\x12\x03\x12\x05" "abcd";
+    MessageParser parser(Request::Class::getType());
+    for(v_buff_size i = 0; i < (v_buff_size) sizeof(data) - 1; i ++) {
+      parser.writeSimple(data + i, 1);
+    }
+    OATPP_ASSERT(!parser.finish());
+    OATPP_ASSERT(parser.getErrorMessage());
+    OATPP_LOGI(TAG, "OK");
+  }
+
+  {
+    OATPP_LOGI(TAG, "truncated body...");
+    MessageParser parser(Request::Class::getType());
+    parser.writeSimple(body.data(), body.size() - 1);
+    OATPP_ASSERT(!parser.finish());
+    OATPP_ASSERT(parser.getErrorMessage());
+    OATPP_LOGI(TAG, "OK");
+  }
+
+  {
+    OATPP_LOGI(TAG, "invalid wire type...");
+    MessageParser parser(Request::Class::getType());
+    parser.writeSimple("\x0F\x01", 2);
+    OATPP_ASSERT(!parser.finish());
+    OATPP_LOGI(TAG, "OK");
+  }
+
+  {
+    OATPP_LOGI(TAG, "empty body...");
+    MessageParser parser(Request::Class::getType());
+    OATPP_ASSERT(parser.finish());
+    OATPP_ASSERT(parser.getObject());
+    OATPP_LOGI(TAG, "OK");
+  }
+
+}
+
+}}}
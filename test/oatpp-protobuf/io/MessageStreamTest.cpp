@@ -0,0 +1,236 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#include "MessageStreamTest.hpp"
+
+#include "oatpp-protobuf/web/BodyReader.hpp"
+
+#include "test.pb.h"
+
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
+#include <google/protobuf/util/delimited_message_util.h>
+
+namespace oatpp { namespace protobuf { namespace io {
+
+namespace {
+
+typedef oatpp::protobuf::Object<::test::ImageRotateRequest> Request;
+
+const v_int32 MESSAGES_COUNT = 1000;
+
+Request createRequest(v_int32 index) {
+  Request req = std::make_shared<::test::ImageRotateRequest>();
+  auto image = req->add_image();
+  image->set_width(index);
+  image->set_data(std::string(index % 300, 'a' + index % 26));
+  req->add_intarr(-index);
+  return req;
+}
+
+class Provider : public MessageStreamSerializer::Provider {
+private:
+  v_int32 m_index = 0;
+public:
+
+  oatpp::Void getNext(async::Action& action) override {
+    (void) action;
+    if(m_index < MESSAGES_COUNT) {
+      return createRequest(m_index ++);
+    }
+    return nullptr;
+  }
+
+};
+
+class Listener : public MessageStreamParser::Listener {
+public:
+  v_int32 count = 0;
+  bool valid = true;
+public:
+
+  async::Action onMessage(const oatpp::Void& object) override {
+    auto req = object.staticCast<Request>();
+    auto expected = createRequest(count ++);
+    valid = valid && req->SerializeAsString() == expected->SerializeAsString();
+    return async::Action();
+  }
+
+};
+
+/*
+ * Listener which asks to wait (returns an action) after every message.
+ */
+class BackpressureListener : public Listener {
+public:
+  v_int32 actionsCount = 0;
+public:
+
+  async::Action onMessage(const oatpp::Void& object) override {
+    Listener::onMessage(object);
+    actionsCount ++;
+    return async::Action::createActionByType(async::Action::TYPE_REPEAT);
+  }
+
+};
+
+/*
+ * Write data in chunks of fixed size the way WriteCallback::writeExactSizeDataAsyncInline() does -
+ * data is not advanced when an action is returned and the same chunk is written again once the action is done.
+ */
+void writeAsyncInline(oatpp::data::stream::WriteCallback* writeCallback, const std::string& data, v_buff_size chunkSize) {
+  v_buff_size pos = 0;
+  while(pos < (v_buff_size) data.size()) {
+    v_buff_size size = data.size() - pos;
+    if(size > chunkSize) size = chunkSize;
+    while(size > 0) {
+      async::Action action;
+      auto res = writeCallback->write(data.data() + pos, size, action);
+      if(!action.isNone()) {
+        continue;
+      }
+      OATPP_ASSERT(res > 0);
+      pos += res;
+      size -= res;
+    }
+  }
+}
+
+/*
+ * Incoming message which transfers its body in chunks of fixed size.
+ */
+class ChunkedIncoming {
+private:
+  std::string m_body;
+  v_buff_size m_chunkSize;
+public:
+
+  ChunkedIncoming(const std::string& body, v_buff_size chunkSize)
+    : m_body(body)
+    , m_chunkSize(chunkSize)
+  {}
+
+  void transferBody(oatpp::data::stream::WriteCallback* writeCallback) const {
+    v_buff_size pos = 0;
+    while(pos < (v_buff_size) m_body.size()) {
+      v_buff_size size = m_body.size() - pos;
+      if(size > m_chunkSize) size = m_chunkSize;
+      writeCallback->writeSimple(m_body.data() + pos, size);
+      pos += size;
+    }
+  }
+
+};
+
+std::string readAll(MessageStreamSerializer& serializer, v_buff_size bufferSize) {
+  std::string result;
+  std::unique_ptr<char[]> buffer(new char[bufferSize]);
+  async::Action action;
+  v_io_size res;
+  while((res = serializer.read(buffer.get(), bufferSize, action)) > 0) {
+    result.append(buffer.get(), res);
+  }
+  return result;
+}
+
+}
+
+void MessageStreamTest::onRun() {
+
+  /* same framing as google::protobuf::util::SerializeDelimitedToZeroCopyStream() */
+  std::string expected;
+  {
+    google::protobuf::io::StringOutputStream output(&expected);
+    for(v_int32 i = 0; i < MESSAGES_COUNT; i ++) {
+      google::protobuf::util::SerializeDelimitedToZeroCopyStream(*createRequest(i), &output);
+    }
+  }
+
+  for(v_buff_size chunkSize : {1, 64, 4096}) {
+    OATPP_LOGI(TAG, "serialize - chunk size %d...", (v_int32) chunkSize);
+    MessageStreamSerializer serializer(Request::Class::getType(), std::make_shared<Provider>(), chunkSize);
+    OATPP_ASSERT(readAll(serializer, 7) == expected);
+    OATPP_ASSERT(serializer.getMessagesCount() == MESSAGES_COUNT);
+    OATPP_LOGI(TAG, "OK");
+  }
+
+  std::vector<v_buff_size> chunkSizes = {1, 2, 3, 7, 128, 4096, (v_buff_size) expected.size()};
+
+  for(v_buff_size chunkSize : chunkSizes) {
+    OATPP_LOGI(TAG, "parse - chunk size %d...", (v_int32) chunkSize);
+    auto incoming = std::make_shared<ChunkedIncoming>(expected, chunkSize);
+    auto listener = std::make_shared<Listener>();
+    auto count = oatpp::protobuf::web::BodyReader::readMessageStream<::test::ImageRotateRequest>(incoming, listener);
+    OATPP_ASSERT(count == MESSAGES_COUNT);
+    OATPP_ASSERT(listener->count == MESSAGES_COUNT);
+    OATPP_ASSERT(listener->valid);
+    OATPP_LOGI(TAG, "OK");
+  }
+
+  for(v_buff_size chunkSize : chunkSizes) {
+    OATPP_LOGI(TAG, "parse with backpressure - chunk size %d...", (v_int32) chunkSize);
+    auto listener = std::make_shared<BackpressureListener>();
+    MessageStreamParser parser(Request::Class::getType(), listener);
+    writeAsyncInline(&parser, expected, chunkSize);
+    OATPP_ASSERT(parser.finish());
+    OATPP_ASSERT(parser.getMessagesCount() == MESSAGES_COUNT);
+    OATPP_ASSERT(listener->count == MESSAGES_COUNT);
+    OATPP_ASSERT(listener->actionsCount == MESSAGES_COUNT);
+    OATPP_ASSERT(listener->valid);
+    OATPP_LOGI(TAG, "OK");
+  }
+
+  {
+    OATPP_LOGI(TAG, "truncated stream...");
+    auto listener = std::make_shared<Listener>();
+    MessageStreamParser parser(Request::Class::getType(), listener);
+    parser.writeSimple(expected.data(), expected.size() - 1);
+    OATPP_ASSERT(!parser.finish());
+    OATPP_ASSERT(parser.getErrorMessage());
+    OATPP_ASSERT(listener->count == MESSAGES_COUNT - 1);
+    OATPP_LOGI(TAG, "OK");
+  }
+
+  {
+    OATPP_LOGI(TAG, "invalid message...");
+    auto listener = std::make_shared<Listener>();
+    MessageStreamParser parser(Request::Class::getType(), listener);
+    parser.writeSimple("\x02\x0F\x01", 3);
+    OATPP_ASSERT(!parser.finish());
+    OATPP_ASSERT(listener->count == 0);
+    OATPP_LOGI(TAG, "OK");
+  }
+
+  {
+    OATPP_LOGI(TAG, "empty stream...");
+    auto listener = std::make_shared<Listener>();
+    MessageStreamParser parser(Request::Class::getType(), listener);
+    OATPP_ASSERT(parser.finish());
+    OATPP_ASSERT(parser.getMessagesCount() == 0);
+    OATPP_LOGI(TAG, "OK");
+  }
+
+}
+
+}}}
@@ -0,0 +1,299 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#include "DeserializerTest.hpp"
+
+#include "oatpp-protobuf/json/Deserializer.hpp"
+#include "oatpp-protobuf/json/Serializer.hpp"
+
+#include "oatpp/parser/json/mapping/ObjectMapper.hpp"
+
+#include "test.pb.h"
+
+#include <google/protobuf/util/message_differencer.h>
+
+namespace oatpp { namespace protobuf { namespace json {
+
+void DeserializerTest::onRun() {
+
+  typedef oatpp::protobuf::Object<::test::ImageRotateRequest> Request;
+  typedef google::protobuf::util::MessageDifferencer MessageDifferencer;
+
+  Request req = std::make_shared<::test::ImageRotateRequest>();
+
+  req->add_rotation(::test::ImageRotateRequest_Rotation_TWO_SEVENTY_DEG);
+
+  auto image = req->add_image();
+  image->set_color(true);
+  image->set_data("Hello \"World\"!\n\xD0\x9F");
+  image->set_width(-1);
+  image->set_height(240);
+  req->add_image();
+
+  req->add_intarr(-7);
+  req->add_intarr(42);
+
+  oatpp::parser::json::mapping::ObjectMapper interMapper;
+  oatpp::parser::json::mapping::ObjectMapper directMapper;
+
+  interMapper.getSerializer()->getConfig()->enabledInterpretations = {"protobuf"};
+  interMapper.getDeserializer()->getConfig()->enabledInterpretations = {"protobuf"};
+
+  Serializer::enable(directMapper.getSerializer().get());
+  Deserializer::enable(directMapper.getDeserializer().get());
+
+  auto json = directMapper.writeToString(req);
+  OATPP_LOGD(TAG, "json='%s'", json->c_str());
+
+  {
+    auto clone = directMapper.readFromString<Request>(json);
+    OATPP_ASSERT(clone);
+    OATPP_ASSERT(MessageDifferencer::Equals(*req, *clone));
+
+    auto interClone = interMapper.readFromString<Request>(json);
+    OATPP_ASSERT(MessageDifferencer::Equals(*interClone, *clone));
+  }
+
+  {
+    auto clone = directMapper.readFromString<Request>(
+      "{\"unknown\": {\"a\": [1, \"}]\\\"\"], \"b\": null}, \"rotation\": [\"NINETY_DEG\"], \"image\": null, \"intArr\" : [ 1 , null, 2 ]}"
+    );
+    OATPP_ASSERT(clone);
+    OATPP_ASSERT(clone->rotation_size() == 1);
+    OATPP_ASSERT(clone->rotation(0) == ::test::ImageRotateRequest_Rotation_NINETY_DEG);
+    OATPP_ASSERT(clone->image_size() == 0);
+    OATPP_ASSERT(clone->intarr_size() == 2);
+    OATPP_ASSERT(clone->intarr(1) == 2);
+  }
+
+  {
+    auto config = Deserializer::Config::createShared();
+    config->useArena = true;
+
+    oatpp::parser::json::mapping::ObjectMapper arenaMapper(
+      oatpp::parser::json::mapping::Serializer::Config::createShared(), config
+    );
+    Deserializer::enable(arenaMapper.getDeserializer().get());
+
+    auto clone = arenaMapper.readFromString<Request>(json);
+    OATPP_ASSERT(clone);
+    OATPP_ASSERT(clone->GetArena() != nullptr);
+    OATPP_ASSERT(clone->image(0).GetArena() == clone->GetArena());
+    OATPP_ASSERT(MessageDifferencer::Equals(*req, *clone));
+
+    interMapper.getDeserializer()->getConfig()->enabledInterpretations = {"protobuf-arena"};
+    auto interClone = interMapper.readFromString<Request>(json);
+    OATPP_ASSERT(interClone->GetArena() != nullptr);
+    OATPP_ASSERT(MessageDifferencer::Equals(*req, *interClone));
+  }
+
+  {
+    oatpp::parser::Caret caret("null");
+    auto clone = directMapper.read(caret, Request::Class::getType());
+    OATPP_ASSERT(!clone);
+    OATPP_ASSERT(!caret.hasError());
+  }
+
+  {
+    auto clone = directMapper.readFromString<Request>("{\"rotation\": [3, \"ONE_EIGHTY_DEG\", \"1\", 42]}");
+    OATPP_ASSERT(clone);
+    OATPP_ASSERT(clone->rotation_size() == 4);
+    OATPP_ASSERT(clone->rotation(0) == ::test::ImageRotateRequest_Rotation_TWO_SEVENTY_DEG);
+    OATPP_ASSERT(clone->rotation(1) == ::test::ImageRotateRequest_Rotation_ONE_EIGHTY_DEG);
+    OATPP_ASSERT(clone->rotation(2) == ::test::ImageRotateRequest_Rotation_NINETY_DEG);
+    OATPP_ASSERT(clone->rotation(3) == 42);
+  }
+
+  {
+    oatpp::parser::Caret caret("{\"rotation\": [\"NO_SUCH_ROTATION\"]}");
+    auto clone = directMapper.read(caret, Request::Class::getType());
+    OATPP_ASSERT(!clone);
+    OATPP_ASSERT(caret.hasError());
+  }
+
+  {
+    typedef oatpp::protobuf::Object<::test::Catalog> Catalog;
+
+    auto catalog = directMapper.readFromString<Catalog>(
+      "{\"images\": {\"a\": {\"width\": 1}, \"b\": {\"width\": 2}, \"c\": null},"
+      " \"names\": {\"-5\": \"minus five\"}, \"flags\": {\"false\": \"TWO_SEVENTY_DEG\"},"
+      " \"weights\": {\"18446744073709551615\": 0.25}}"
+    );
+    OATPP_ASSERT(catalog);
+    OATPP_ASSERT(catalog->images_size() == 2);
+    OATPP_ASSERT(catalog->images().at("b").width() == 2);
+    OATPP_ASSERT(catalog->names().at(-5) == "minus five");
+    OATPP_ASSERT(catalog->flags().at(false) == ::test::ImageRotateRequest_Rotation_TWO_SEVENTY_DEG);
+    OATPP_ASSERT(catalog->weights().at(18446744073709551615ULL) == 0.25);
+
+    auto clone = directMapper.readFromString<Catalog>(directMapper.writeToString(catalog));
+    OATPP_ASSERT(MessageDifferencer::Equals(*catalog, *clone));
+  }
+
+  {
+    oatpp::parser::Caret caret("{\"names\": {\"2147483648\": \"overflow\"}}");
+    auto clone = directMapper.read(caret, oatpp::protobuf::Object<::test::Catalog>::Class::getType());
+    OATPP_ASSERT(!clone);
+    OATPP_ASSERT(caret.hasError());
+  }
+
+  {
+    typedef oatpp::protobuf::Object<::test::Event> Event;
+
+    auto event = directMapper.readFromString<Event>(
+      "{\"time\": \"1972-01-01T10:00:20.021+01:30\", \"elapsed\": \"-0.000001s\", \"count\": 0, \"note\": null,"
+      " \"flag\": false, \"mask\": \"name,time\", \"attributes\": {\"n\": 1.5, \"o\": {\"list\": [null, \"s\"]}, \"z\": null},"
+      " \"payload\": true, \"history\": [\"1970-01-01T00:00:00Z\", null], \"timeouts\": {\"read\": \"30s\"}}"
+    );
+    OATPP_ASSERT(event);
+    OATPP_ASSERT(event->time().seconds() == 63102620);
+    OATPP_ASSERT(event->time().nanos() == 21000000);
+    OATPP_ASSERT(event->elapsed().seconds() == 0);
+    OATPP_ASSERT(event->elapsed().nanos() == -1000);
+    OATPP_ASSERT(event->has_count() && event->count().value() == 0);
+    OATPP_ASSERT(!event->has_note());
+    OATPP_ASSERT(event->has_flag() && !event->flag().value());
+    OATPP_ASSERT(event->mask().paths_size() == 2);
+    OATPP_ASSERT(event->mask().paths(1) == "time");
+    OATPP_ASSERT(event->attributes().fields().at("n").number_value() == 1.5);
+    OATPP_ASSERT(event->attributes().fields().at("o").struct_value().fields().at("list").list_value().values(0).has_null_value());
+    OATPP_ASSERT(event->attributes().fields().at("z").has_null_value());
+    OATPP_ASSERT(event->payload().bool_value());
+    OATPP_ASSERT(event->history_size() == 1);
+    OATPP_ASSERT(event->timeouts().at("read").seconds() == 30);
+
+    auto clone = directMapper.readFromString<Event>(directMapper.writeToString(event));
+    OATPP_ASSERT(MessageDifferencer::Equals(*event, *clone));
+  }
+
+  {
+    oatpp::parser::Caret caret("{\"time\": \"2021-02-29T00:00:00Z\"}");
+    auto clone = directMapper.read(caret, oatpp::protobuf::Object<::test::Event>::Class::getType());
+    OATPP_ASSERT(!clone);
+    OATPP_ASSERT(caret.hasError());
+  }
+
+  {
+    typedef oatpp::protobuf::Object<::test::Envelope> Envelope;
+
+    auto envelope = directMapper.readFromString<Envelope>(
+      "{\"head\": {\"@type\": \"type.googleapis.com/google.protobuf.Duration\", \"value\": \"2s\"},"
+      " \"events\": [{\"@type\": \"type.googleapis.com/test.Image\", \"width\": 5},"
+      " {\"height\": 7, \"@type\": \"type.googleapis.com/test.Image\"}, {}]}"
+    );
+    OATPP_ASSERT(envelope);
+
+    google::protobuf::Duration head;
+    OATPP_ASSERT(envelope->head().UnpackTo(&head));
+    OATPP_ASSERT(head.seconds() == 2);
+
+    ::test::Image image;
+    OATPP_ASSERT(envelope->events_size() == 3);
+    OATPP_ASSERT(envelope->events(0).UnpackTo(&image) && image.width() == 5);
+    OATPP_ASSERT(envelope->events(1).UnpackTo(&image) && image.height() == 7);
+    OATPP_ASSERT(envelope->events(2).type_url().empty());
+
+    auto clone = directMapper.readFromString<Envelope>(directMapper.writeToString(envelope));
+    OATPP_ASSERT(MessageDifferencer::Equals(*envelope, *clone));
+  }
+
+  {
+    oatpp::parser::Caret caret("{\"head\": {\"@type\": \"type.googleapis.com/test.NoSuchMessage\"}}");
+    auto clone = directMapper.read(caret, oatpp::protobuf::Object<::test::Envelope>::Class::getType());
+    OATPP_ASSERT(!clone);
+    OATPP_ASSERT(caret.hasError());
+  }
+
+  {
+    Request target = std::make_shared<::test::ImageRotateRequest>(*req);
+    target->mutable_preview()->set_data("preview");
+    target->mutable_preview()->set_width(32);
+    target->mutable_preview()->set_height(24);
+    const ::test::Image* preview = &target->preview();
+
+    oatpp::parser::Caret caret("{\"preview\": {\"width\": 64, \"data\": null}, \"intArr\": [1], \"rotation\": null}");
+    Deserializer::merge(directMapper.getDeserializer().get(), caret, target);
+    OATPP_ASSERT(!caret.hasError());
+
+    /* nested message is updated in place, absent fields are untouched */
+    OATPP_ASSERT(&target->preview() == preview);
+    OATPP_ASSERT(target->preview().width() == 64);
+    OATPP_ASSERT(target->preview().height() == 24);
+    OATPP_ASSERT(target->preview().data().empty());
+    OATPP_ASSERT(target->intarr_size() == 1 && target->intarr(0) == 1);
+    OATPP_ASSERT(target->rotation_size() == 0);
+    OATPP_ASSERT(MessageDifferencer::Equals(target->image(0), req->image(0)));
+    OATPP_ASSERT(target->image_size() == 2);
+  }
+
+  {
+    oatpp::protobuf::Object<::test::Event> event = std::make_shared<::test::Event>();
+    event->set_name("event");
+    event->mutable_time()->set_seconds(5);
+    event->mutable_time()->set_nanos(7);
+    event->mutable_count()->set_value(3);
+
+    oatpp::parser::Caret caret("{\"time\": \"1970-01-01T00:00:01Z\", \"count\": null}");
+    Deserializer::merge(directMapper.getDeserializer().get(), caret, event);
+    OATPP_ASSERT(!caret.hasError());
+
+    /* well-known values are replaced, not merged */
+    OATPP_ASSERT(event->time().seconds() == 1);
+    OATPP_ASSERT(event->time().nanos() == 0);
+    OATPP_ASSERT(!event->has_count());
+    OATPP_ASSERT(event->name() == "event");
+  }
+
+  {
+    oatpp::protobuf::Object<::test::Catalog> catalog = std::make_shared<::test::Catalog>();
+    (*catalog->mutable_images())["a"].set_width(1);
+    (*catalog->mutable_images())["b"].set_width(2);
+    (*catalog->mutable_names())[1] = "one";
+    (*catalog->mutable_weights())[7] = 0.5;
+
+    oatpp::parser::Caret caret("{\"images\": {\"b\": {\"height\": 3}, \"c\": {\"width\": 4}}, \"names\": null}");
+    Deserializer::merge(directMapper.getDeserializer().get(), caret, catalog);
+    OATPP_ASSERT(!caret.hasError());
+
+    /* map fields are replaced as a whole - entries are not merged key by key */
+    OATPP_ASSERT(catalog->images_size() == 2);
+    OATPP_ASSERT(catalog->images().count("a") == 0);
+    OATPP_ASSERT(catalog->images().at("b").width() == 0);
+    OATPP_ASSERT(catalog->images().at("b").height() == 3);
+    OATPP_ASSERT(catalog->images().at("c").width() == 4);
+    OATPP_ASSERT(catalog->names_size() == 0);
+    OATPP_ASSERT(catalog->weights_size() == 1 && catalog->weights().at(7) == 0.5);
+  }
+
+  {
+    Request target = std::make_shared<::test::ImageRotateRequest>(*req);
+    oatpp::parser::Caret caret("{\"rotation\": [\"NO_SUCH_ROTATION\"]}");
+    Deserializer::merge(directMapper.getDeserializer().get(), caret, target);
+    OATPP_ASSERT(caret.hasError());
+  }
+
+}
+
+}}}
@@ -0,0 +1,394 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#include "SerializerTest.hpp"
+
+#include "oatpp-protobuf/json/Serializer.hpp"
+#include "oatpp-protobuf/json/StreamingSerializer.hpp"
+
+#include "oatpp/parser/json/mapping/ObjectMapper.hpp"
+#include "oatpp/core/data/stream/BufferStream.hpp"
+
+#include "test.pb.h"
+
+namespace oatpp { namespace protobuf { namespace json {
+
+namespace {
+
+oatpp::protobuf::Object<::test::ImageRotateRequest> createRequest() {
+
+  oatpp::protobuf::Object<::test::ImageRotateRequest> req = std::make_shared<::test::ImageRotateRequest>();
+
+  req->add_rotation(::test::ImageRotateRequest_Rotation_NINETY_DEG);
+  req->add_rotation(::test::ImageRotateRequest_Rotation_ONE_EIGHTY_DEG);
+
+  auto image1 = req->add_image();
+  image1->set_data("Hello \"World\"!\n/\x01");
+  image1->set_width(-1);
+  image1->set_height(240);
+
+  auto image2 = req->add_image();
+  image2->set_color(true);
+  image2->set_data("\xD0\x9F\xD1\x80\xD0\xB8\xD0\xB2\xD0\xB5\xD1\x82");
+
+  req->add_intarr(1);
+  req->add_intarr(2);
+  req->add_intarr(3);
+
+  return req;
+
+}
+
+void checkSameOutput(const char* TAG, bool includeNullFields, bool useBeautifier) {
+
+  auto req = createRequest();
+
+  oatpp::parser::json::mapping::ObjectMapper interMapper;
+  oatpp::parser::json::mapping::ObjectMapper directMapper;
+
+  for(auto mapper : {&interMapper, &directMapper}) {
+    auto config = mapper->getSerializer()->getConfig();
+    config->enabledInterpretations = {"protobuf"};
+    config->includeNullFields = includeNullFields;
+    config->useBeautifier = useBeautifier;
+  }
+
+  Serializer::enable(directMapper.getSerializer().get());
+
+  auto json1 = interMapper.writeToString(req);
+  auto json2 = directMapper.writeToString(req);
+
+  OATPP_LOGD(TAG, "json='%s'", json2->c_str());
+  OATPP_ASSERT(json1 == json2);
+
+  interMapper.getSerializer()->getConfig()->enabledInterpretations = {"protobuf-zero-copy"};
+  OATPP_ASSERT(interMapper.writeToString(req) == json2);
+
+  oatpp::protobuf::Object<::test::ImageRotateRequest> nullReq;
+  OATPP_ASSERT(directMapper.writeToString(nullReq) == "null");
+
+}
+
+void checkEnumsAsInt(const char* TAG) {
+
+  auto req = createRequest();
+
+  auto config = Serializer::Config::createShared();
+  config->enumsAsInt = true;
+
+  oatpp::parser::json::mapping::ObjectMapper mapper(
+    config, oatpp::parser::json::mapping::Deserializer::Config::createShared()
+  );
+  Serializer::enable(mapper.getSerializer().get());
+
+  auto json = mapper.writeToString(req);
+  OATPP_LOGD(TAG, "json='%s'", json->c_str());
+  OATPP_ASSERT(json->std_str().find("\"rotation\":[1,2]") != std::string::npos);
+
+  req->add_rotation((::test::ImageRotateRequest_Rotation) 42);
+  config->enumsAsInt = false;
+  json = mapper.writeToString(req);
+  OATPP_ASSERT(json->std_str().find("\"rotation\":[\"NINETY_DEG\",\"ONE_EIGHTY_DEG\",\"42\"]") != std::string::npos);
+
+}
+
+void checkMaps(const char* TAG) {
+
+  oatpp::protobuf::Object<::test::Catalog> catalog = std::make_shared<::test::Catalog>();
+  (*catalog->mutable_images())["preview"].set_width(32);
+  (*catalog->mutable_names())[-7] = "minus seven";
+  (*catalog->mutable_flags())[true] = ::test::ImageRotateRequest_Rotation_NINETY_DEG;
+  (*catalog->mutable_weights())[42] = 0.5;
+
+  oatpp::parser::json::mapping::ObjectMapper interMapper;
+  oatpp::parser::json::mapping::ObjectMapper directMapper;
+
+  for(auto mapper : {&interMapper, &directMapper}) {
+    auto config = mapper->getSerializer()->getConfig();
+    config->enabledInterpretations = {"protobuf"};
+    config->includeNullFields = false;
+  }
+
+  Serializer::enable(directMapper.getSerializer().get());
+
+  auto json = directMapper.writeToString(catalog);
+  OATPP_LOGD(TAG, "json='%s'", json->c_str());
+  OATPP_ASSERT(json == interMapper.writeToString(catalog));
+  OATPP_ASSERT(json->std_str().find("{\"images\":{\"preview\":{\"width\":32}},\"names\":{\"-7\":\"minus seven\"},"
+                                   "\"flags\":{\"true\":\"NINETY_DEG\"},\"weights\":{\"42\":") == 0);
+
+}
+
+void checkWellKnownTypes(const char* TAG) {
+
+  oatpp::protobuf::Object<::test::Event> event = std::make_shared<::test::Event>();
+  event->set_name("deploy");
+  event->mutable_time()->set_seconds(63108020);
+  event->mutable_time()->set_nanos(21000000);
+  event->mutable_elapsed()->set_seconds(-1);
+  event->mutable_elapsed()->set_nanos(-500000000);
+  event->mutable_count()->set_value(0);
+  event->mutable_mask()->add_paths("name");
+  event->mutable_mask()->add_paths("time");
+  (*event->mutable_attributes()->mutable_fields())["ok"].set_bool_value(true);
+  event->mutable_payload()->mutable_list_value()->add_values()->set_string_value("x");
+  event->mutable_payload()->mutable_list_value()->add_values()->set_null_value(google::protobuf::NULL_VALUE);
+  event->add_history();
+
+  oatpp::parser::json::mapping::ObjectMapper interMapper;
+  oatpp::parser::json::mapping::ObjectMapper directMapper;
+
+  for(auto mapper : {&interMapper, &directMapper}) {
+    auto config = mapper->getSerializer()->getConfig();
+    config->enabledInterpretations = {"protobuf"};
+    config->includeNullFields = false;
+  }
+
+  Serializer::enable(directMapper.getSerializer().get());
+
+  auto json = directMapper.writeToString(event);
+  OATPP_LOGD(TAG, "json='%s'", json->c_str());
+  OATPP_ASSERT(json == interMapper.writeToString(event));
+  OATPP_ASSERT(json == "{\"name\":\"deploy\",\"time\":\"1972-01-01T10:00:20.021Z\",\"elapsed\":\"-1.5s\",\"count\":0,"
+                       "\"mask\":\"name,time\",\"attributes\":{\"ok\":true},\"payload\":[\"x\",null],"
+                       "\"history\":[\"1970-01-01T00:00:00Z\"],\"timeouts\":{}}");
+
+}
+
+void checkAny(const char* TAG) {
+
+  ::test::Image image;
+  image.set_width(5);
+
+  google::protobuf::Timestamp time;
+  time.set_seconds(1);
+
+  oatpp::protobuf::Object<::test::Envelope> envelope = std::make_shared<::test::Envelope>();
+  envelope->add_events()->PackFrom(image);
+  envelope->add_events()->PackFrom(time);
+  envelope->add_events();
+
+  oatpp::parser::json::mapping::ObjectMapper mapper;
+  mapper.getSerializer()->getConfig()->includeNullFields = false;
+  Serializer::enable(mapper.getSerializer().get());
+
+  auto json = mapper.writeToString(envelope);
+  OATPP_LOGD(TAG, "json='%s'", json->c_str());
+  OATPP_ASSERT(json == "{\"events\":[{\"@type\":\"type.googleapis.com/test.Image\",\"width\":5},"
+                       "{\"@type\":\"type.googleapis.com/google.protobuf.Timestamp\",\"value\":\"1970-01-01T00:00:01Z\"},{}]}");
+
+  envelope->mutable_head()->set_type_url("type.googleapis.com/test.NoSuchMessage");
+  bool thrown = false;
+  try {
+    mapper.writeToString(envelope);
+  } catch (const std::runtime_error&) {
+    thrown = true;
+  }
+  OATPP_ASSERT(thrown);
+
+}
+
+void checkDefaultValues(const char* TAG) {
+
+  oatpp::protobuf::Object<::test::Image> image = std::make_shared<::test::Image>();
+  image->set_width(5);
+
+  oatpp::protobuf::Object<::test::ImageRotateRequest> req = std::make_shared<::test::ImageRotateRequest>();
+
+  auto config = Serializer::Config::createShared();
+  config->includeNullFields = true;
+
+  oatpp::parser::json::mapping::ObjectMapper mapper(
+    config, oatpp::parser::json::mapping::Deserializer::Config::createShared()
+  );
+  Serializer::enable(mapper.getSerializer().get());
+
+  OATPP_ASSERT(mapper.writeToString(image) == "{\"color\":null,\"data\":null,\"width\":5,\"height\":null}");
+
+  config->defaultValues = Serializer::DefaultValues::OMIT;
+  OATPP_LOGD(TAG, "omit='%s'", mapper.writeToString(image)->c_str());
+  OATPP_ASSERT(mapper.writeToString(image) == "{\"width\":5}");
+  /* fields with presence are still null */
+  OATPP_ASSERT(mapper.writeToString(req) == "{\"preview\":null}");
+
+  config->defaultValues = Serializer::DefaultValues::EMIT;
+  OATPP_LOGD(TAG, "emit='%s'", mapper.writeToString(image)->c_str());
+  OATPP_ASSERT(mapper.writeToString(image) == "{\"color\":false,\"data\":\"\",\"width\":5,\"height\":0}");
+  OATPP_ASSERT(mapper.writeToString(req) == "{\"rotation\":[],\"image\":[],\"intArr\":[],\"preview\":null}");
+
+  config->includeNullFields = false;
+  OATPP_ASSERT(mapper.writeToString(req) == "{\"rotation\":[],\"image\":[],\"intArr\":[]}");
+
+}
+
+void checkFieldMask(const char* TAG) {
+
+  auto req = createRequest();
+  req->mutable_preview()->set_width(4);
+  req->mutable_preview()->set_height(5);
+
+  oatpp::parser::json::mapping::ObjectMapper interMapper;
+  oatpp::parser::json::mapping::ObjectMapper directMapper;
+
+  for(auto mapper : {&interMapper, &directMapper}) {
+    auto config = mapper->getSerializer()->getConfig();
+    config->enabledInterpretations = {"protobuf"};
+    config->includeNullFields = false;
+  }
+
+  Serializer::enable(directMapper.getSerializer().get());
+
+  /* sub-paths of scalar fields and unknown fields are ignored */
+  auto mask = reflection::FieldMask::parse(" image.width, preview,intArr.x , image.noSuchField,noSuchField");
+
+  oatpp::data::stream::BufferOutputStream stream;
+  Serializer::serialize(directMapper.getSerializer().get(), &stream, req, *mask);
+  auto json = stream.toString();
+
+  OATPP_LOGD(TAG, "json='%s'", json->c_str());
+  OATPP_ASSERT(json == "{\"image\":[{\"width\":-1},{}],\"intArr\":[1,2,3],\"preview\":{\"width\":4,\"height\":5}}");
+
+  /* projected DynamicObject gives the same output via the generic serializer - masked-out fields are not written */
+  auto clazz = reflection::DynamicClass::registryGetClass<::test::ImageRotateRequest>();
+  auto obj = reflection::DynamicObject::createShared(clazz, *req, nullptr, mask);
+  OATPP_ASSERT(!obj->getField("rotation"));
+  OATPP_ASSERT(obj->getObjectType() != clazz->getType());
+  OATPP_ASSERT(obj->getObjectType() == clazz->getProjectedType(mask.get()));
+  OATPP_ASSERT(interMapper.writeToString(oatpp::Void(obj, obj->getObjectType())) == json);
+
+  for(auto mapper : {&interMapper, &directMapper}) {
+    mapper->getSerializer()->getConfig()->includeNullFields = true;
+  }
+  oatpp::data::stream::BufferOutputStream nullStream;
+  Serializer::serialize(directMapper.getSerializer().get(), &nullStream, req, *mask);
+  auto nullJson = nullStream.toString();
+  OATPP_LOGD(TAG, "json='%s'", nullJson->c_str());
+  OATPP_ASSERT(nullJson->std_str().find("rotation") == std::string::npos);
+  OATPP_ASSERT(interMapper.writeToString(oatpp::Void(obj, obj->getObjectType())) == nullJson);
+  for(auto mapper : {&interMapper, &directMapper}) {
+    mapper->getSerializer()->getConfig()->includeNullFields = false;
+  }
+
+  /* mask in the serializer config applies to every proto object written by the object mapper */
+  auto maskConfig = Serializer::Config::createShared();
+  maskConfig->includeNullFields = false;
+  maskConfig->fieldMask = mask;
+  oatpp::parser::json::mapping::ObjectMapper maskMapper(
+    maskConfig, oatpp::parser::json::mapping::Deserializer::Config::createShared()
+  );
+  Serializer::enable(maskMapper.getSerializer().get());
+  OATPP_ASSERT(maskMapper.writeToString(req) == json);
+
+  /* a field selected as a whole is not narrowed by its sub-paths */
+  OATPP_ASSERT(reflection::FieldMask::parse("preview.width,preview")->getField("preview")->isAll());
+  OATPP_ASSERT(reflection::FieldMask::parse("preview,preview.width")->getField("preview")->isAll());
+  OATPP_ASSERT(!reflection::FieldMask::parse("preview.width")->getField("preview")->isAll());
+
+  /* empty mask - all fields, generated codec is used if any */
+  auto all = reflection::FieldMask::parse("");
+  OATPP_ASSERT(all->isAll());
+  oatpp::data::stream::BufferOutputStream allStream;
+  Serializer::serialize(directMapper.getSerializer().get(), &allStream, req, *all);
+  OATPP_ASSERT(allStream.toString() == directMapper.writeToString(req));
+
+  oatpp::protobuf::Object<::test::Catalog> catalog = std::make_shared<::test::Catalog>();
+  (*catalog->mutable_images())["a"].set_width(1);
+  (*catalog->mutable_images())["a"].set_height(2);
+  (*catalog->mutable_names())[1] = "one";
+
+  oatpp::data::stream::BufferOutputStream catalogStream;
+  Serializer::serialize(directMapper.getSerializer().get(), &catalogStream, catalog,
+                        *reflection::FieldMask::createShared({"images.height"}));
+  OATPP_ASSERT(catalogStream.toString() == "{\"images\":{\"a\":{\"height\":2}}}");
+
+}
+
+oatpp::String readAll(StreamingSerializer& callback, v_buff_size bufferSize) {
+  oatpp::data::stream::BufferOutputStream stream;
+  std::unique_ptr<v_char8[]> buffer(new v_char8[bufferSize]);
+  oatpp::async::Action action;
+  v_io_size res;
+  while((res = callback.read(buffer.get(), bufferSize, action)) > 0) {
+    stream.writeSimple(buffer.get(), res);
+  }
+  return stream.toString();
+}
+
+void checkStreaming(const char* TAG, bool includeNullFields) {
+
+  auto req = createRequest();
+  req->mutable_preview()->set_width(4);
+  for(v_int32 i = 0; i < 1000; i ++) {
+    auto image = req->add_image();
+    image->set_width(i);
+    image->set_data("image");
+  }
+
+  oatpp::parser::json::mapping::ObjectMapper mapper;
+  auto config = mapper.getSerializer()->getConfig();
+  config->enabledInterpretations = {"protobuf"};
+  config->includeNullFields = includeNullFields;
+  Serializer::enable(mapper.getSerializer().get());
+
+  auto expected = mapper.writeToString(req);
+
+  /* buffer size and chunk size don't affect the output */
+  for(v_buff_size bufferSize : {1, 7, 4096}) {
+    for(v_buff_size chunkSize : {1, 64, 4096}) {
+      StreamingSerializer callback(mapper.getSerializer().get(), req, nullptr, chunkSize);
+      OATPP_ASSERT(readAll(callback, bufferSize) == expected);
+    }
+  }
+
+  auto mask = reflection::FieldMask::parse("image.width,preview");
+  oatpp::data::stream::BufferOutputStream stream;
+  Serializer::serialize(mapper.getSerializer().get(), &stream, req, *mask);
+  auto masked = StreamingSerializer::createShared(mapper.getSerializer().get(), req, mask, 128);
+  OATPP_ASSERT(readAll(*masked, 100) == stream.toString());
+
+  StreamingSerializer nullCallback(mapper.getSerializer().get(), oatpp::protobuf::Object<::test::ImageRotateRequest>());
+  OATPP_ASSERT(readAll(nullCallback, 16) == "null");
+
+  OATPP_LOGD(TAG, "streamed %d bytes", (int) expected->getSize());
+
+}
+
+}
+
+void SerializerTest::onRun() {
+  checkSameOutput(TAG, true, false);
+  checkSameOutput(TAG, false, false);
+  checkSameOutput(TAG, true, true);
+  checkEnumsAsInt(TAG);
+  checkMaps(TAG);
+  checkWellKnownTypes(TAG);
+  checkAny(TAG);
+  checkDefaultValues(TAG);
+  checkFieldMask(TAG);
+  checkStreaming(TAG, true);
+  checkStreaming(TAG, false);
+}
+
+}}}
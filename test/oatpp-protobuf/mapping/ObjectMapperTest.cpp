@@ -0,0 +1,163 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#include "ObjectMapperTest.hpp"
+
+#include "oatpp-protobuf/mapping/ObjectMapper.hpp"
+
+#include "test.pb.h"
+
+#include <google/protobuf/util/message_differencer.h>
+
+#include <cstring>
+#include <limits>
+
+namespace oatpp { namespace protobuf { namespace mapping {
+
+namespace {
+
+/*
+ * Stream which gives away data in small portions and doesn't expose its memory.
+ */
+class ChunkedReader : public oatpp::data::stream::ReadCallback {
+private:
+  std::string m_data;
+  v_buff_size m_position;
+public:
+
+  ChunkedReader(const std::string& data)
+    : m_data(data)
+    , m_position(0)
+  {}
+
+  v_io_size read(void* buffer, v_buff_size count, async::Action& action) override {
+    (void) action;
+    v_buff_size size = m_data.size() - m_position;
+    if(size > 3) size = 3;
+    if(size > count) size = count;
+    std::memcpy(buffer, m_data.data() + m_position, size);
+    m_position += size;
+    return size;
+  }
+
+};
+
+}
+
+void ObjectMapperTest::onRun() {
+
+  typedef oatpp::protobuf::Object<::test::ImageRotateRequest> Request;
+  typedef google::protobuf::util::MessageDifferencer MessageDifferencer;
+
+  Request req = std::make_shared<::test::ImageRotateRequest>();
+
+  req->add_rotation(::test::ImageRotateRequest_Rotation_NINETY_DEG);
+  req->add_intarr(-7);
+  req->add_intarr(42);
+
+  auto image = req->add_image();
+  image->set_color(true);
+  image->set_data(std::string(10000, 'x'));
+  image->set_width(320);
+  image->set_height(240);
+
+  ObjectMapper mapper;
+  OATPP_ASSERT(std::strcmp(mapper.getInfo().http_content_type, "application/x-protobuf") == 0);
+
+  auto data = mapper.writeToString(req);
+  OATPP_ASSERT(data->std_str() == req->SerializeAsString());
+
+  {
+    OATPP_LOGI(TAG, "read from caret...");
+    auto clone = mapper.readFromString<Request>(data);
+    OATPP_ASSERT(clone);
+    OATPP_ASSERT(MessageDifferencer::Equals(*req, *clone));
+    OATPP_LOGI(TAG, "OK");
+  }
+
+  {
+    OATPP_LOGI(TAG, "read from buffer stream...");
+    oatpp::data::stream::BufferInputStream stream(data);
+    auto clone = mapper.readFromStream<Request>(&stream);
+    OATPP_ASSERT(clone);
+    OATPP_ASSERT(MessageDifferencer::Equals(*req, *clone));
+    OATPP_LOGI(TAG, "OK");
+  }
+
+  {
+    OATPP_LOGI(TAG, "read from chunked stream...");
+    ChunkedReader stream(data->std_str());
+    auto clone = mapper.readFromStream<Request>(&stream);
+    OATPP_ASSERT(clone);
+    OATPP_ASSERT(MessageDifferencer::Equals(*req, *clone));
+    OATPP_LOGI(TAG, "OK");
+  }
+
+  {
+    OATPP_LOGI(TAG, "read to arena...");
+    auto config = ObjectMapper::Config::createShared();
+    config->useArena = true;
+    ObjectMapper arenaMapper(config);
+    auto clone = arenaMapper.readFromString<Request>(data);
+    OATPP_ASSERT(clone);
+    OATPP_ASSERT(clone->GetArena() != nullptr);
+    OATPP_ASSERT(MessageDifferencer::Equals(*req, *clone));
+    OATPP_LOGI(TAG, "OK");
+  }
+
+  {
+    OATPP_LOGI(TAG, "read corrupted data...");
+    oatpp::parser::Caret caret((const char*) data->getData(), data->getSize() - 1);
+    auto clone = mapper.read(caret, Request::Class::getType());
+    OATPP_ASSERT(!clone);
+    OATPP_ASSERT(caret.hasError());
+    OATPP_LOGI(TAG, "OK");
+  }
+
+  {
+    OATPP_LOGI(TAG, "read too large data...");
+    /* the size is rejected before the data is touched */
+    oatpp::parser::Caret caret((const char*) data->getData(), (v_buff_size) std::numeric_limits<int>::max() + 1);
+    auto clone = mapper.read(caret, Request::Class::getType());
+    OATPP_ASSERT(!clone);
+    OATPP_ASSERT(caret.hasError());
+    OATPP_LOGI(TAG, "OK");
+  }
+
+  {
+    OATPP_LOGI(TAG, "write unsupported type...");
+    bool thrown = false;
+    try {
+      mapper.writeToString(oatpp::String("Hello"));
+    } catch (const std::runtime_error&) {
+      thrown = true;
+    }
+    OATPP_ASSERT(thrown);
+    OATPP_LOGI(TAG, "OK");
+  }
+
+}
+
+}}}
@@ -0,0 +1,180 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#include "DescriptorSetTest.hpp"
+
+#include "oatpp-protobuf/reflection/DescriptorSet.hpp"
+#include "oatpp-protobuf/json/Deserializer.hpp"
+#include "oatpp-protobuf/json/Serializer.hpp"
+
+#include "oatpp/parser/json/mapping/ObjectMapper.hpp"
+#include "oatpp/core/data/stream/BufferStream.hpp"
+
+#include "test.pb.h"
+
+#include <google/protobuf/descriptor.pb.h>
+
+#include <cstdio>
+#include <fstream>
+#include <unordered_set>
+
+namespace oatpp { namespace protobuf { namespace reflection {
+
+namespace {
+
+void addFile(google::protobuf::FileDescriptorSet& set,
+             std::unordered_set<std::string>& added,
+             const google::protobuf::FileDescriptor* file)
+{
+  if(!added.insert(file->name()).second) {
+    return;
+  }
+  for(int i = 0; i < file->dependency_count(); i ++) {
+    addFile(set, added, file->dependency(i));
+  }
+  file->CopyTo(set.add_file());
+}
+
+}
+
+void DescriptorSetTest::onRun() {
+
+  oatpp::parser::json::mapping::ObjectMapper mapper;
+  json::Serializer::enable(mapper.getSerializer().get());
+  json::Deserializer::enable(mapper.getDeserializer().get());
+
+  ::test::Event event;
+  event.set_name("runtime");
+  event.mutable_time()->set_seconds(1);
+  event.mutable_count()->set_value(7);
+  event.add_history()->set_nanos(5000000);
+  (*event.mutable_timeouts())["read"].set_seconds(30);
+
+  auto expected = mapper.writeToString(oatpp::protobuf::Object<::test::Event>(std::make_shared<::test::Event>(event)));
+
+  {
+    OATPP_LOGD(TAG, "set without imports...");
+
+    /* only test.proto - imports are taken from the generated pool */
+    google::protobuf::FileDescriptorSet files;
+    ::test::Event::descriptor()->file()->CopyTo(files.add_file());
+
+    auto set = DescriptorSet::loadData(files.SerializeAsString());
+    auto clazz = set->getClass("test.Event");
+
+    OATPP_ASSERT(clazz == set->getClass("test.Event"));
+    OATPP_ASSERT(clazz != DynamicClass::registryGetClass<::test::Event>());
+    OATPP_ASSERT(clazz->getDescriptor()->file()->pool() == set->getPool());
+
+    auto proto = clazz->createProto();
+    OATPP_ASSERT(proto->GetDescriptor() == clazz->getDescriptor());
+    OATPP_ASSERT(DescriptorSet::registryGetFactory(set->getPool()) == set->getFactory());
+
+    oatpp::parser::Caret caret(expected);
+    json::Deserializer::deserializeMessage(mapper.getDeserializer().get(), caret, *proto, clazz);
+    OATPP_ASSERT(!caret.hasError());
+    OATPP_ASSERT(proto->SerializeAsString() == event.SerializeAsString());
+
+    oatpp::data::stream::BufferOutputStream stream;
+    json::Serializer::serializeMessage(mapper.getSerializer().get(), &stream, *proto, clazz);
+    OATPP_ASSERT(stream.toString() == expected);
+
+    auto obj = DynamicObject::createShared(*proto);
+    OATPP_ASSERT(obj->getField("name").staticCast<oatpp::String>() == "runtime");
+    auto back = obj->toProto();
+    OATPP_ASSERT(back->GetDescriptor() == clazz->getDescriptor());
+    OATPP_ASSERT(back->SerializeAsString() == event.SerializeAsString());
+
+    bool thrown = false;
+    try {
+      set->getClass("test.NoSuchMessage");
+    } catch (const std::runtime_error&) {
+      thrown = true;
+    }
+    OATPP_ASSERT(thrown);
+  }
+
+  {
+    OATPP_LOGD(TAG, "memory-mapped set...");
+
+    google::protobuf::FileDescriptorSet files;
+    std::unordered_set<std::string> added;
+    addFile(files, added, ::test::Envelope::descriptor()->file());
+
+    const char* path = "descriptor-set-test.desc";
+    {
+      std::ofstream file(path, std::ios::out | std::ios::binary);
+      files.SerializeToOstream(&file);
+    }
+
+    auto set = DescriptorSet::loadFile(path);
+    std::remove(path);
+
+    set->registerAll(2);
+
+    auto clazz = set->getClass("test.Envelope");
+    OATPP_ASSERT(clazz->getDescriptor() != ::test::Envelope::descriptor());
+
+    /* google.protobuf.Any of the set is a well-known type of its own pool */
+    const auto& fields = clazz->getFields();
+    OATPP_ASSERT(fields[0].wellKnownType == WellKnownType::ANY);
+
+    ::test::Envelope envelope;
+    envelope.mutable_head()->PackFrom(event);
+
+    auto proto = clazz->createProto(std::make_shared<google::protobuf::Arena>());
+    OATPP_ASSERT(proto->GetArena() != nullptr);
+    OATPP_ASSERT(proto->ParseFromString(envelope.SerializeAsString()));
+
+    oatpp::data::stream::BufferOutputStream stream;
+    json::Serializer::serializeMessage(mapper.getSerializer().get(), &stream, *proto, clazz);
+    OATPP_ASSERT(stream.toString() == mapper.writeToString(
+      oatpp::protobuf::Object<::test::Envelope>(std::make_shared<::test::Envelope>(envelope))
+    ));
+  }
+
+  {
+    bool thrown = false;
+    try {
+      DescriptorSet::loadData("not a descriptor set");
+    } catch (const std::runtime_error&) {
+      thrown = true;
+    }
+    OATPP_ASSERT(thrown);
+  }
+
+  {
+    bool thrown = false;
+    try {
+      DescriptorSet::loadFile("no-such-descriptor-set.desc");
+    } catch (const std::runtime_error&) {
+      thrown = true;
+    }
+    OATPP_ASSERT(thrown);
+  }
+
+}
+
+}}}
@@ -0,0 +1,387 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#include "DynamicObjectTest.hpp"
+
+#include "oatpp-protobuf/Object.hpp"
+
+#include "test.pb.h"
+
+#include <google/protobuf/util/message_differencer.h>
+
+namespace oatpp { namespace protobuf { namespace reflection {
+
+void DynamicObjectTest::onRun() {
+
+  typedef google::protobuf::util::MessageDifferencer MessageDifferencer;
+
+  auto req = std::make_shared<::test::ImageRotateRequest>();
+
+  req->add_rotation(::test::ImageRotateRequest_Rotation_NINETY_DEG);
+  req->add_intarr(1);
+  req->add_intarr(2);
+
+  auto image = req->add_image();
+  image->set_data("Hello World!");
+  image->set_width(320);
+
+  auto preview = req->mutable_preview();
+  preview->set_data("Hi!");
+  preview->set_width(32);
+
+  typedef oatpp::data::mapping::type::__class::AbstractObject::PolymorphicDispatcher ObjectDispatcher;
+
+  {
+    OATPP_LOGI(TAG, "lazy access...");
+
+    auto obj = DynamicObject::createLazy(req);
+    OATPP_ASSERT(obj->isLazy());
+
+    auto dispatcher = static_cast<const ObjectDispatcher*>(obj->getClass()->getType()->polymorphicDispatcher);
+    const auto& properties = dispatcher->getProperties()->getMap();
+
+    /* fields are not converted until accessed */
+    OATPP_ASSERT(!properties.at("intArr")->get(obj.get()));
+    OATPP_ASSERT(!properties.at("image")->get(obj.get()));
+
+    auto intArr = obj->getField("intArr").staticCast<oatpp::Vector<oatpp::Int32>>();
+    OATPP_ASSERT(intArr);
+    OATPP_ASSERT(intArr->size() == 2);
+    OATPP_ASSERT(intArr[1] == 2);
+    OATPP_ASSERT(properties.at("intArr")->get(obj.get()));
+    OATPP_ASSERT(!properties.at("image")->get(obj.get()));
+
+    auto nested = obj->getField("preview").staticCast<AbstractDynamicObject>();
+    OATPP_ASSERT(nested);
+    OATPP_ASSERT(nested->isLazy());
+    OATPP_ASSERT(nested->getField("width").staticCast<oatpp::Int32>() == 32);
+
+    OATPP_LOGI(TAG, "OK");
+  }
+
+  {
+    OATPP_LOGI(TAG, "lazy object to proto...");
+
+    auto obj = DynamicObject::createLazy(req);
+    obj->getField("preview");
+    obj->setField("intArr", oatpp::Vector<oatpp::Int32>({3}));
+
+    auto proto = std::static_pointer_cast<::test::ImageRotateRequest>(obj->toProto());
+    OATPP_ASSERT(proto->intarr_size() == 1);
+    OATPP_ASSERT(proto->intarr(0) == 3);
+
+    proto->clear_intarr();
+    proto->add_intarr(1);
+    proto->add_intarr(2);
+    OATPP_ASSERT(MessageDifferencer::Equals(*req, *proto));
+
+    OATPP_LOGI(TAG, "OK");
+  }
+
+  {
+    OATPP_LOGI(TAG, "null elements of repeated fields...");
+
+    /* contiguous (numeric), enum and message elements - all are rejected, none is skipped */
+    std::vector<std::pair<const char*, oatpp::Void>> fields = {
+      {"intArr", oatpp::Vector<oatpp::Int32>({1, nullptr, 3})},
+      {"rotation", oatpp::Vector<oatpp::String>({"NINETY_DEG", nullptr})}
+    };
+
+    auto images = DynamicObject::createShared(req)->getField("image");
+    images.staticCast<oatpp::Vector<AbstractDynamicObject>>()->push_back(nullptr);
+    fields.push_back({"image", images});
+
+    for(auto& field : fields) {
+      auto obj = DynamicObject::createShared(req);
+      obj->setField(field.first, field.second);
+      bool thrown = false;
+      try {
+        obj->toProto();
+      } catch (const std::runtime_error&) {
+        thrown = true;
+      }
+      OATPP_ASSERT(thrown);
+    }
+
+    /* well-known types - null is valid for google.protobuf.Value only */
+    {
+      auto obj = DynamicObject::createShared(::test::Event());
+      obj->setField("history", oatpp::Vector<oatpp::String>({"2000-01-01T00:00:00Z", nullptr}));
+      bool thrown = false;
+      try {
+        obj->toProto();
+      } catch (const std::runtime_error&) {
+        thrown = true;
+      }
+      OATPP_ASSERT(thrown);
+    }
+
+    OATPP_LOGI(TAG, "OK");
+  }
+
+  {
+    OATPP_LOGI(TAG, "zero-copy strings...");
+
+    auto obj = DynamicObject::createShared(std::static_pointer_cast<const Message>(req));
+    auto images = obj->getField("image").staticCast<oatpp::Vector<AbstractDynamicObject>>();
+    auto data = images[0]->getField("data").staticCast<oatpp::String>();
+    OATPP_ASSERT(data == "Hello World!");
+    OATPP_ASSERT(data->getData() == (p_char8) req->image(0).data().data());
+
+    auto copy = DynamicObject::createShared(*req);
+    images = copy->getField("image").staticCast<oatpp::Vector<AbstractDynamicObject>>();
+    data = images[0]->getField("data").staticCast<oatpp::String>();
+    OATPP_ASSERT(data == "Hello World!");
+    OATPP_ASSERT(data->getData() != (p_char8) req->image(0).data().data());
+
+    OATPP_LOGI(TAG, "OK");
+  }
+
+  {
+    OATPP_LOGI(TAG, "materialize...");
+
+    auto lazy = DynamicObject::createLazy(req);
+    lazy->materialize();
+
+    auto eager = DynamicObject::createShared(*req);
+
+    auto dispatcher = static_cast<const ObjectDispatcher*>(eager->getClass()->getType()->polymorphicDispatcher);
+    for(auto& property : dispatcher->getProperties()->getList()) {
+      OATPP_ASSERT((bool) property->get(lazy.get()) == (bool) property->get(eager.get()));
+    }
+
+    auto proto = lazy->toProto();
+    OATPP_ASSERT(MessageDifferencer::Equals(*req, *proto));
+
+    OATPP_LOGI(TAG, "OK");
+  }
+
+  {
+    OATPP_LOGI(TAG, "map fields...");
+
+    ::test::Catalog catalog;
+    for(v_int32 i = 0; i < 100; i ++) {
+      (*catalog.mutable_names())[i - 50] = "name-" + std::to_string(i);
+    }
+    (*catalog.mutable_images())["preview"].set_width(32);
+    (*catalog.mutable_flags())[true] = ::test::ImageRotateRequest_Rotation_NINETY_DEG;
+    (*catalog.mutable_weights())[18446744073709551615ULL] = 0.5;
+
+    auto obj = DynamicObject::createShared(catalog);
+
+    auto names = obj->getField("names").staticCast<oatpp::UnorderedFields<oatpp::String>>();
+    OATPP_ASSERT(names->size() == 100);
+    OATPP_ASSERT(names->at("-50") == "name-0");
+    OATPP_ASSERT(names->at("49") == "name-99");
+
+    auto images = obj->getField("images").staticCast<oatpp::UnorderedFields<AbstractDynamicObject>>();
+    OATPP_ASSERT(images->size() == 1);
+    OATPP_ASSERT(images->at("preview")->getField("width").staticCast<oatpp::Int32>() == 32);
+
+    auto flags = obj->getField("flags").staticCast<oatpp::UnorderedFields<oatpp::String>>();
+    OATPP_ASSERT(flags->at("true") == "NINETY_DEG");
+
+    auto weights = obj->getField("weights").staticCast<oatpp::UnorderedFields<oatpp::Float64>>();
+    OATPP_ASSERT(weights->at("18446744073709551615") == 0.5);
+
+    auto proto = obj->toProto();
+    OATPP_ASSERT(MessageDifferencer::Equals(catalog, *proto));
+
+    names->clear();
+    (*names)["not-a-number"] = "x";
+    bool thrown = false;
+    try {
+      obj->toProto();
+    } catch (const std::runtime_error&) {
+      thrown = true;
+    }
+    OATPP_ASSERT(thrown);
+
+    OATPP_LOGI(TAG, "OK");
+  }
+
+  {
+    OATPP_LOGI(TAG, "well-known types...");
+
+    ::test::Event event;
+    event.mutable_time()->set_seconds(63108020);
+    event.mutable_time()->set_nanos(21000000);
+    event.mutable_elapsed()->set_seconds(90);
+    event.mutable_count()->set_value(0);
+    event.mutable_mask()->add_paths("name");
+    (*event.mutable_attributes()->mutable_fields())["ok"].set_bool_value(true);
+    event.mutable_payload()->set_number_value(0.5);
+    event.add_history()->set_seconds(-1);
+    (*event.mutable_timeouts())["read"].set_nanos(1000000);
+
+    auto obj = DynamicObject::createShared(event);
+
+    OATPP_ASSERT(obj->getField("time").staticCast<oatpp::String>() == "1972-01-01T10:00:20.021Z");
+    OATPP_ASSERT(obj->getField("elapsed").staticCast<oatpp::String>() == "90s");
+    /* wrapper holding the default value is not null */
+    auto count = obj->getField("count").staticCast<oatpp::Int64>();
+    OATPP_ASSERT(count && *count == 0);
+    OATPP_ASSERT(!obj->getField("note"));
+    OATPP_ASSERT(obj->getField("mask").staticCast<oatpp::String>() == "name");
+    OATPP_ASSERT(obj->getField("payload").staticCast<oatpp::Any>().retrieve<oatpp::Float64>() == 0.5);
+
+    auto attributes = obj->getField("attributes").staticCast<oatpp::UnorderedFields<oatpp::Any>>();
+    OATPP_ASSERT(attributes->at("ok").retrieve<oatpp::Boolean>() == true);
+
+    auto history = obj->getField("history").staticCast<oatpp::Vector<oatpp::String>>();
+    OATPP_ASSERT(history->size() == 1);
+    OATPP_ASSERT(history[0] == "1969-12-31T23:59:59Z");
+
+    auto timeouts = obj->getField("timeouts").staticCast<oatpp::UnorderedFields<oatpp::String>>();
+    OATPP_ASSERT(timeouts->at("read") == "0.001s");
+
+    auto proto = obj->toProto();
+    OATPP_ASSERT(MessageDifferencer::Equals(event, *proto));
+
+    obj->setField("time", oatpp::String("2000-01-01T00:00:00+02:00"));
+    obj->setField("note", oatpp::String(""));
+    (*attributes)["list"] = oatpp::Vector<oatpp::Any>({oatpp::Any(oatpp::Int32(7)), nullptr});
+    auto patched = std::static_pointer_cast<::test::Event>(obj->toProto());
+    OATPP_ASSERT(patched->time().seconds() == 946677600);
+    OATPP_ASSERT(patched->has_note() && patched->note().value().empty());
+    const auto& list = patched->attributes().fields().at("list").list_value();
+    OATPP_ASSERT(list.values_size() == 2);
+    OATPP_ASSERT(list.values(0).number_value() == 7);
+    OATPP_ASSERT(list.values(1).has_null_value());
+
+    obj->setField("elapsed", oatpp::String("1 minute"));
+    bool thrown = false;
+    try {
+      obj->toProto();
+    } catch (const std::runtime_error&) {
+      thrown = true;
+    }
+    OATPP_ASSERT(thrown);
+
+    OATPP_LOGI(TAG, "OK");
+  }
+
+  {
+    OATPP_LOGI(TAG, "any fields...");
+
+    ::test::Image image;
+    image.set_width(5);
+
+    ::test::Envelope envelope;
+    envelope.mutable_head()->PackFrom(image);
+    for(v_int32 i = 0; i < 10; i ++) {
+      image.set_height(i);
+      envelope.add_events()->PackFrom(image);
+    }
+
+    auto imageClass = DynamicClass::registryGetClass<::test::Image>();
+    OATPP_ASSERT(DynamicClass::registryGetClassByTypeUrl("type.googleapis.com/test.Image") == imageClass);
+    OATPP_ASSERT(DynamicClass::registryGetClassByTypeUrl("type.googleapis.com/test.NoSuchMessage") == nullptr);
+
+    auto obj = DynamicObject::createShared(envelope);
+
+    auto head = obj->getField("head").staticCast<oatpp::Any>();
+    OATPP_ASSERT(head.getStoredType() == imageClass->getType());
+    OATPP_ASSERT(std::static_pointer_cast<DynamicObject>(head->ptr)->getField("width").staticCast<oatpp::Int32>() == 5);
+
+    auto events = obj->getField("events").staticCast<oatpp::Vector<oatpp::Any>>();
+    OATPP_ASSERT(events->size() == 10);
+    OATPP_ASSERT(std::static_pointer_cast<DynamicObject>(events[9]->ptr)->getField("height").staticCast<oatpp::Int32>() == 9);
+
+    auto proto = obj->toProto();
+    OATPP_ASSERT(MessageDifferencer::Equals(envelope, *proto));
+
+    obj->setField("head", oatpp::Any(oatpp::String("not a proto")));
+    bool thrown = false;
+    try {
+      obj->toProto();
+    } catch (const std::runtime_error&) {
+      thrown = true;
+    }
+    OATPP_ASSERT(thrown);
+
+    OATPP_LOGI(TAG, "OK");
+  }
+
+  {
+    OATPP_LOGI(TAG, "warm-up...");
+
+    DynamicClass::registerAll(::test::Envelope::descriptor()->file(), 4);
+    DynamicClass::registerAll("test");
+    DynamicClass::registerAll("no.such.package");
+
+    auto clazz = DynamicClass::registryGetClass<::test::Catalog>();
+    auto dispatcher = static_cast<const ObjectDispatcher*>(clazz->getType()->polymorphicDispatcher);
+    OATPP_ASSERT(dispatcher->getProperties()->getList().size() == clazz->getFields().size());
+    OATPP_ASSERT(clazz->getVectorType()->params.front() == clazz->getType());
+
+    OATPP_LOGI(TAG, "OK");
+  }
+
+  {
+    OATPP_LOGI(TAG, "object pool...");
+
+    DynamicObject::setPoolCapacity(2);
+
+    ::test::ImageRotateRequest req;
+    for(v_int32 i = 0; i < 3; i ++) {
+      req.add_image()->set_width(i);
+    }
+
+    auto obj = DynamicObject::createShared(req);
+    auto images = obj->getField("image").staticCast<oatpp::Vector<oatpp::Void>>();
+    DynamicObject* first = obj.get();
+    DynamicObject* image = static_cast<DynamicObject*>(images[0].get());
+    images = nullptr;
+    obj.reset();
+
+    /* released objects are reused - with up to 2 free objects per class */
+    req.mutable_image(0)->set_width(7);
+    auto clone = DynamicObject::createShared(req);
+    OATPP_ASSERT(clone.get() == first);
+    OATPP_ASSERT(!clone->isLazy());
+    OATPP_ASSERT(MessageDifferencer::Equals(req, *clone->toProto()));
+
+    auto cloneImages = clone->getField("image").staticCast<oatpp::Vector<oatpp::Void>>();
+    OATPP_ASSERT(cloneImages[0].get() == image || cloneImages[1].get() == image);
+    OATPP_ASSERT(static_cast<DynamicObject*>(cloneImages[0].get())->getField("width").staticCast<oatpp::Int32>() == 7);
+
+    /* recycled objects hold no values of the previous use */
+    cloneImages = nullptr;
+    clone.reset();
+    auto type = DynamicClass::registryGetClass<::test::ImageRotateRequest>()->getType();
+    auto empty = static_cast<const ObjectDispatcher*>(type->polymorphicDispatcher)->createObject();
+    OATPP_ASSERT(empty.get() == first);
+    OATPP_ASSERT(!static_cast<DynamicObject*>(empty.get())->getField("image"));
+
+    DynamicObject::setPoolCapacity(0);
+    DynamicObject::clearPool();
+
+    OATPP_LOGI(TAG, "OK");
+  }
+
+}
+
+}}}
@@ -0,0 +1,233 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#include "StatisticsTest.hpp"
+
+#include "oatpp-protobuf/json/Deserializer.hpp"
+#include "oatpp-protobuf/json/Serializer.hpp"
+#include "oatpp-protobuf/json/StreamingSerializer.hpp"
+
+#include "oatpp/core/data/stream/BufferStream.hpp"
+
+#include "codec.oatpp.hpp"
+#include "test.pb.h"
+
+namespace oatpp { namespace protobuf { namespace reflection {
+
+namespace {
+
+Statistics::Snapshot getSnapshot(const std::string& className) {
+  for(auto& snapshot : DynamicClass::registryGetStatistics()) {
+    if(snapshot.className == className) {
+      return snapshot;
+    }
+  }
+  Statistics::Snapshot empty = Statistics::Snapshot();
+  empty.className = className;
+  return empty;
+}
+
+}
+
+void StatisticsTest::onRun() {
+
+  auto req = std::make_shared<::test::ImageRotateRequest>();
+
+  req->add_rotation(::test::ImageRotateRequest_Rotation_NINETY_DEG);
+  req->add_intarr(1);
+  req->add_intarr(2);
+
+  auto image = req->add_image();
+  image->set_data("Hello World!");
+  image->set_width(320);
+
+  auto preview = req->mutable_preview();
+  preview->set_data("Hi!");
+  preview->set_width(32);
+
+  DynamicClass* reqClass = DynamicClass::registryGetClass<::test::ImageRotateRequest>();
+
+  {
+    OATPP_LOGI(TAG, "disabled...");
+
+    Statistics::setEnabled(false);
+    DynamicClass::registryResetStatistics();
+
+    DynamicObject::createShared(reqClass, *req);
+
+    OATPP_ASSERT(getSnapshot("test.ImageRotateRequest").conversions[Statistics::PROTO_TO_OBJECT] == 0);
+    OATPP_ASSERT(getSnapshot("test.Image").conversions[Statistics::PROTO_TO_OBJECT] == 0);
+    OATPP_LOGI(TAG, "OK");
+  }
+
+  Statistics::setEnabled(true);
+
+  {
+    OATPP_LOGI(TAG, "proto -> DynamicObject...");
+
+    DynamicClass::registryResetStatistics();
+
+    auto obj = DynamicObject::createShared(reqClass, *req);
+
+    auto reqStats = getSnapshot("test.ImageRotateRequest");
+    OATPP_ASSERT(reqStats.conversions[Statistics::PROTO_TO_OBJECT] == 1);
+    OATPP_ASSERT(reqStats.conversions[Statistics::PROTO_TO_JSON] == 0);
+    OATPP_ASSERT(reqStats.fieldsVisited == 4);
+    OATPP_ASSERT(reqStats.objectsAllocated == 1);
+    OATPP_ASSERT(reqStats.stringsAllocated == 1); // rotation enum name
+    OATPP_ASSERT(reqStats.bytesCopied == 0);
+
+    /* nested messages are accounted to their own class */
+    auto imageStats = getSnapshot("test.Image");
+    OATPP_ASSERT(imageStats.conversions[Statistics::PROTO_TO_OBJECT] == 2);
+    OATPP_ASSERT(imageStats.fieldsVisited == 8);
+    OATPP_ASSERT(imageStats.objectsAllocated == 2);
+    OATPP_ASSERT(imageStats.stringsAllocated == 2);
+    OATPP_ASSERT(imageStats.bytesCopied == 15);
+
+    OATPP_LOGI(TAG, "DynamicObject -> proto...");
+
+    obj->toProto();
+
+    reqStats = getSnapshot("test.ImageRotateRequest");
+    imageStats = getSnapshot("test.Image");
+    OATPP_ASSERT(reqStats.conversions[Statistics::OBJECT_TO_PROTO] == 1);
+    OATPP_ASSERT(imageStats.conversions[Statistics::OBJECT_TO_PROTO] == 2);
+    OATPP_ASSERT(imageStats.bytesCopied == 30);
+
+    OATPP_LOGI(TAG, "OK");
+  }
+
+  {
+    OATPP_LOGI(TAG, "proto -> DynamicObject (zero-copy)...");
+
+    DynamicClass::registryResetStatistics();
+
+    DynamicObject::createShared(req);
+
+    auto imageStats = getSnapshot("test.Image");
+    OATPP_ASSERT(imageStats.conversions[Statistics::PROTO_TO_OBJECT] == 2);
+    OATPP_ASSERT(imageStats.stringsAllocated == 2);
+    OATPP_ASSERT(imageStats.bytesCopied == 0);
+
+    OATPP_LOGI(TAG, "OK");
+  }
+
+  {
+    OATPP_LOGI(TAG, "json...");
+
+    DynamicClass::registryResetStatistics();
+
+    oatpp::parser::json::mapping::Serializer serializer;
+    oatpp::parser::json::mapping::Deserializer deserializer;
+
+    oatpp::data::stream::BufferOutputStream stream;
+    json::Serializer::serializeMessage(&serializer, &stream, *req, reqClass);
+    auto jsonText = stream.toString();
+
+    ::test::ImageRotateRequest parsed;
+    oatpp::parser::Caret caret(jsonText);
+    json::Deserializer::deserializeMessage(&deserializer, caret, parsed, reqClass);
+    OATPP_ASSERT(!caret.hasError());
+
+    auto reqStats = getSnapshot("test.ImageRotateRequest");
+    OATPP_ASSERT(reqStats.conversions[Statistics::PROTO_TO_JSON] == 1);
+    OATPP_ASSERT(reqStats.conversions[Statistics::JSON_TO_PROTO] == 1);
+    OATPP_ASSERT(reqStats.conversions[Statistics::PROTO_TO_OBJECT] == 0);
+
+    auto imageStats = getSnapshot("test.Image");
+    OATPP_ASSERT(imageStats.conversions[Statistics::PROTO_TO_JSON] == 2);
+    OATPP_ASSERT(imageStats.conversions[Statistics::JSON_TO_PROTO] == 2);
+    OATPP_ASSERT(imageStats.bytesCopied == 15);
+
+    OATPP_LOGI(TAG, "json (streaming)...");
+
+    DynamicClass::registryResetStatistics();
+
+    oatpp::protobuf::Object<::test::ImageRotateRequest> object = req;
+    json::StreamingSerializer streaming(&serializer, object, nullptr, 1);
+    std::unique_ptr<v_char8[]> buffer(new v_char8[8]);
+    async::Action action;
+    while(streaming.read(buffer.get(), 8, action) > 0) {}
+
+    /* the same counters as of the direct serializer */
+    reqStats = getSnapshot("test.ImageRotateRequest");
+    imageStats = getSnapshot("test.Image");
+    OATPP_ASSERT(reqStats.conversions[Statistics::PROTO_TO_JSON] == 1);
+    OATPP_ASSERT(reqStats.fieldsVisited == 4);
+    OATPP_ASSERT(imageStats.conversions[Statistics::PROTO_TO_JSON] == 2);
+    OATPP_ASSERT(imageStats.fieldsVisited == 8);
+    OATPP_ASSERT(imageStats.bytesCopied == 0);
+
+    OATPP_LOGI(TAG, "OK");
+  }
+
+  {
+    OATPP_LOGI(TAG, "json (generated codec)...");
+
+    DynamicClass::registryResetStatistics();
+
+    ::test::codec::Shape shape;
+    shape.set_name("shape");
+    shape.add_points()->set_x(1);
+    shape.add_points()->set_y(2);
+    shape.mutable_style()->set_color("red");
+
+    oatpp::parser::json::mapping::Serializer serializer;
+    oatpp::parser::json::mapping::Deserializer deserializer;
+    auto codec = codec::Codec<::test::codec::Shape>::getInstance();
+
+    oatpp::data::stream::BufferOutputStream stream;
+    codec->writeJson(&serializer, &stream, shape);
+    auto jsonText = stream.toString();
+
+    ::test::codec::Shape parsed;
+    oatpp::parser::Caret caret(jsonText);
+    codec->readJson(&deserializer, caret, parsed);
+    OATPP_ASSERT(!caret.hasError());
+
+    /* nested messages are accounted to their own class - the same as via reflection */
+    auto shapeStats = getSnapshot("test.codec.Shape");
+    OATPP_ASSERT(shapeStats.conversions[Statistics::PROTO_TO_JSON] == 1);
+    OATPP_ASSERT(shapeStats.conversions[Statistics::JSON_TO_PROTO] == 1);
+    OATPP_ASSERT(shapeStats.fieldsVisited > 0);
+
+    auto pointStats = getSnapshot("test.codec.Point");
+    OATPP_ASSERT(pointStats.conversions[Statistics::PROTO_TO_JSON] == 2);
+    OATPP_ASSERT(pointStats.conversions[Statistics::JSON_TO_PROTO] == 2);
+
+    auto styleStats = getSnapshot("test.codec.Shape.Style");
+    OATPP_ASSERT(styleStats.conversions[Statistics::PROTO_TO_JSON] == 1);
+    OATPP_ASSERT(styleStats.conversions[Statistics::JSON_TO_PROTO] == 1);
+
+    OATPP_LOGI(TAG, "OK");
+  }
+
+  Statistics::setEnabled(false);
+  DynamicClass::registryResetStatistics();
+
+}
+
+}}}
@@ -1,4 +1,15 @@
 
+#include "oatpp-protobuf/codec/CodecTest.hpp"
+#include "oatpp-protobuf/io/MessageParserTest.hpp"
+#include "oatpp-protobuf/io/MessageStreamTest.hpp"
+#include "oatpp-protobuf/json/DeserializerTest.hpp"
+#include "oatpp-protobuf/json/SerializerTest.hpp"
+#include "oatpp-protobuf/mapping/ObjectMapperTest.hpp"
+#include "oatpp-protobuf/reflection/DescriptorSetTest.hpp"
+#include "oatpp-protobuf/reflection/DynamicObjectTest.hpp"
+#include "oatpp-protobuf/reflection/StatisticsTest.hpp"
+#include "oatpp-protobuf/web/BodyReaderTest.hpp"
+
 #include "oatpp-test/UnitTest.hpp"
 
 #include "oatpp-protobuf/Object.hpp"
@@ -60,6 +71,16 @@ public:
 
 void runTests() {
   OATPP_RUN_TEST(Test);
+  OATPP_RUN_TEST(oatpp::protobuf::json::SerializerTest);
+  OATPP_RUN_TEST(oatpp::protobuf::json::DeserializerTest);
+  OATPP_RUN_TEST(oatpp::protobuf::mapping::ObjectMapperTest);
+  OATPP_RUN_TEST(oatpp::protobuf::io::MessageParserTest);
+  OATPP_RUN_TEST(oatpp::protobuf::io::MessageStreamTest);
+  OATPP_RUN_TEST(oatpp::protobuf::web::BodyReaderTest);
+  OATPP_RUN_TEST(oatpp::protobuf::reflection::DynamicObjectTest);
+  OATPP_RUN_TEST(oatpp::protobuf::reflection::StatisticsTest);
+  OATPP_RUN_TEST(oatpp::protobuf::reflection::DescriptorSetTest);
+  OATPP_RUN_TEST(oatpp::protobuf::codec::CodecTest);
 }
 
 }
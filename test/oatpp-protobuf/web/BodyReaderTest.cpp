@@ -0,0 +1,276 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#include "BodyReaderTest.hpp"
+
+#include "oatpp-protobuf/web/BodyReader.hpp"
+
+#include "oatpp/core/async/Executor.hpp"
+
+#include "test.pb.h"
+
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
+#include <google/protobuf/util/delimited_message_util.h>
+#include <google/protobuf/util/message_differencer.h>
+
+namespace oatpp { namespace protobuf { namespace web {
+
+namespace {
+
+typedef oatpp::protobuf::Object<::test::ImageRotateRequest> Request;
+
+const v_int32 MESSAGES_COUNT = 100;
+
+Request createRequest(v_int32 index) {
+  Request req = std::make_shared<::test::ImageRotateRequest>();
+  auto image = req->add_image();
+  image->set_width(index);
+  image->set_data(std::string(index * 3, 'a' + index % 26));
+  req->add_intarr(-index);
+  req->mutable_preview()->set_height(index);
+  return req;
+}
+
+/*
+ * Incoming message which transfers its body in chunks of fixed size in Async manner -
+ * the same way as oatpp transfers the body of incoming request - via WriteCallback::writeExactSizeDataAsyncInline().
+ */
+class ChunkedIncoming {
+private:
+
+  class TransferCoroutine : public async::Coroutine<TransferCoroutine> {
+  private:
+    std::string m_body;
+    v_buff_size m_chunkSize;
+    std::shared_ptr<oatpp::data::stream::WriteCallback> m_writeCallback;
+    v_buff_size m_position;
+    const void* m_chunk;
+    v_buff_size m_chunkLeft;
+  public:
+
+    TransferCoroutine(const std::string& body,
+                      v_buff_size chunkSize,
+                      const std::shared_ptr<oatpp::data::stream::WriteCallback>& writeCallback)
+      : m_body(body)
+      , m_chunkSize(chunkSize)
+      , m_writeCallback(writeCallback)
+      , m_position(0)
+      , m_chunk(nullptr)
+      , m_chunkLeft(0)
+    {}
+
+    async::Action act() override {
+      if(m_position >= (v_buff_size) m_body.size()) {
+        return finish();
+      }
+      m_chunk = m_body.data() + m_position;
+      m_chunkLeft = m_body.size() - m_position;
+      if(m_chunkLeft > m_chunkSize) m_chunkLeft = m_chunkSize;
+      m_position += m_chunkLeft;
+      return yieldTo(&TransferCoroutine::writeChunk);
+    }
+
+    async::Action writeChunk() {
+      return m_writeCallback->writeExactSizeDataAsyncInline(m_chunk, m_chunkLeft, yieldTo(&TransferCoroutine::act));
+    }
+
+  };
+
+private:
+  std::string m_body;
+  v_buff_size m_chunkSize;
+public:
+
+  ChunkedIncoming(const std::string& body, v_buff_size chunkSize)
+    : m_body(body)
+    , m_chunkSize(chunkSize)
+  {}
+
+  async::CoroutineStarter transferBodyAsync(const std::shared_ptr<oatpp::data::stream::WriteCallback>& writeCallback) const {
+    return TransferCoroutine::start(m_body, m_chunkSize, writeCallback);
+  }
+
+};
+
+struct Result {
+  Request object;
+  v_int64 messagesCount = 0;
+  bool valid = true;
+  bool error = false;
+  bool done = false;
+};
+
+class ReadBodyCoroutine : public async::Coroutine<ReadBodyCoroutine> {
+private:
+  std::shared_ptr<ChunkedIncoming> m_incoming;
+  std::shared_ptr<Result> m_result;
+public:
+
+  ReadBodyCoroutine(const std::shared_ptr<ChunkedIncoming>& incoming, const std::shared_ptr<Result>& result)
+    : m_incoming(incoming)
+    , m_result(result)
+  {}
+
+  async::Action act() override {
+    return BodyReader::readBodyAsync<::test::ImageRotateRequest>(m_incoming).callbackTo(&ReadBodyCoroutine::onBody);
+  }
+
+  async::Action onBody(const Request& object) {
+    m_result->object = object;
+    m_result->done = true;
+    return finish();
+  }
+
+  async::Action handleError(async::Error* error) override {
+    m_result->error = true;
+    return error;
+  }
+
+};
+
+/*
+ * Listener which asks to wait (returns an action) after every other message.
+ */
+class Listener : public io::MessageStreamParser::Listener {
+private:
+  std::shared_ptr<Result> m_result;
+public:
+
+  Listener(const std::shared_ptr<Result>& result)
+    : m_result(result)
+  {}
+
+  async::Action onMessage(const oatpp::Void& object) override {
+    auto expected = createRequest(m_result->messagesCount ++);
+    m_result->valid = m_result->valid && object.staticCast<Request>()->SerializeAsString() == expected->SerializeAsString();
+    if(m_result->messagesCount % 2 == 0) {
+      return async::Action::createActionByType(async::Action::TYPE_REPEAT);
+    }
+    return async::Action();
+  }
+
+};
+
+class ReadMessageStreamCoroutine : public async::Coroutine<ReadMessageStreamCoroutine> {
+private:
+  std::shared_ptr<ChunkedIncoming> m_incoming;
+  std::shared_ptr<Result> m_result;
+public:
+
+  ReadMessageStreamCoroutine(const std::shared_ptr<ChunkedIncoming>& incoming, const std::shared_ptr<Result>& result)
+    : m_incoming(incoming)
+    , m_result(result)
+  {}
+
+  async::Action act() override {
+    return BodyReader::readMessageStreamAsync<::test::ImageRotateRequest>(m_incoming, std::make_shared<Listener>(m_result))
+      .next(yieldTo(&ReadMessageStreamCoroutine::onDone));
+  }
+
+  async::Action onDone() {
+    m_result->done = true;
+    return finish();
+  }
+
+  async::Action handleError(async::Error* error) override {
+    m_result->error = true;
+    return error;
+  }
+
+};
+
+}
+
+void BodyReaderTest::onRun() {
+
+  typedef google::protobuf::util::MessageDifferencer MessageDifferencer;
+
+  Request req = createRequest(7);
+  for(v_int32 i = 0; i < 10; i ++) {
+    auto image = req->add_image();
+    image->set_data(std::string(100 * i, 'a' + i));
+    image->set_height(i);
+  }
+  auto body = req->SerializeAsString();
+
+  std::string stream;
+  {
+    google::protobuf::io::StringOutputStream output(&stream);
+    for(v_int32 i = 0; i < MESSAGES_COUNT; i ++) {
+      google::protobuf::util::SerializeDelimitedToZeroCopyStream(*createRequest(i), &output);
+    }
+  }
+
+  oatpp::async::Executor executor(1, 1, 1);
+
+  std::vector<v_buff_size> chunkSizes = {1, 3, 64, 4096};
+  std::vector<std::shared_ptr<Result>> bodyResults;
+  std::vector<std::shared_ptr<Result>> streamResults;
+
+  for(v_buff_size chunkSize : chunkSizes) {
+
+    auto bodyResult = std::make_shared<Result>();
+    executor.execute<ReadBodyCoroutine>(std::make_shared<ChunkedIncoming>(body, chunkSize), bodyResult);
+    bodyResults.push_back(bodyResult);
+
+    auto streamResult = std::make_shared<Result>();
+    executor.execute<ReadMessageStreamCoroutine>(std::make_shared<ChunkedIncoming>(stream, chunkSize), streamResult);
+    streamResults.push_back(streamResult);
+
+  }
+
+  auto truncatedBody = std::make_shared<Result>();
+  executor.execute<ReadBodyCoroutine>(std::make_shared<ChunkedIncoming>(body.substr(0, body.size() - 1), 16), truncatedBody);
+
+  auto invalidBody = std::make_shared<Result>();
+  executor.execute<ReadBodyCoroutine>(std::make_shared<ChunkedIncoming>(std::string("\x0F\x01", 2), 1), invalidBody);
+
+  auto truncatedStream = std::make_shared<Result>();
+  executor.execute<ReadMessageStreamCoroutine>(std::make_shared<ChunkedIncoming>(stream.substr(0, stream.size() - 1), 16), truncatedStream);
+
+  executor.waitTasksFinished();
+  executor.stop();
+  executor.join();
+
+  for(v_uint32 i = 0; i < chunkSizes.size(); i ++) {
+    OATPP_LOGI(TAG, "chunk size %d...", (v_int32) chunkSizes[i]);
+    OATPP_ASSERT(bodyResults[i]->done && !bodyResults[i]->error);
+    OATPP_ASSERT(MessageDifferencer::Equals(*req, *bodyResults[i]->object));
+    OATPP_ASSERT(streamResults[i]->done && !streamResults[i]->error);
+    OATPP_ASSERT(streamResults[i]->messagesCount == MESSAGES_COUNT);
+    OATPP_ASSERT(streamResults[i]->valid);
+    OATPP_LOGI(TAG, "OK");
+  }
+
+  OATPP_LOGI(TAG, "truncated and invalid bodies...");
+  OATPP_ASSERT(truncatedBody->error && !truncatedBody->done);
+  OATPP_ASSERT(invalidBody->error && !invalidBody->done);
+  OATPP_ASSERT(truncatedStream->error && !truncatedStream->done);
+  OATPP_ASSERT(truncatedStream->messagesCount == MESSAGES_COUNT - 1);
+  OATPP_LOGI(TAG, "OK");
+
+}
+
+}}}
@@ -0,0 +1,702 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#include "CodecGenerator.hpp"
+
+#include <google/protobuf/descriptor.pb.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
+
+#include <unordered_set>
+
+namespace oatpp { namespace protobuf { namespace codegen {
+
+namespace {
+
+/* accessors of fields named after C++ keywords get '_' suffix - same list as in protoc C++ generator */
+const std::unordered_set<std::string> CPP_KEYWORDS = {
+  "NULL", "alignas", "alignof", "and", "and_eq", "asm", "auto", "bitand", "bitor", "bool", "break", "case", "catch",
+  "char", "class", "compl", "const", "constexpr", "const_cast", "continue", "decltype", "default", "delete", "do",
+  "double", "dynamic_cast", "else", "enum", "explicit", "export", "extern", "false", "float", "for", "friend",
+  "goto", "if", "inline", "int", "long", "mutable", "namespace", "new", "noexcept", "not", "not_eq", "nullptr",
+  "operator", "or", "or_eq", "private", "protected", "public", "register", "reinterpret_cast", "return", "short",
+  "signed", "sizeof", "static", "static_assert", "static_cast", "struct", "switch", "template", "this",
+  "thread_local", "throw", "true", "try", "typedef", "typeid", "typename", "union", "unsigned", "using",
+  "virtual", "void", "volatile", "wchar_t", "while", "xor", "xor_eq"
+};
+
+std::string replaceAll(std::string str, const std::string& what, const std::string& with) {
+  std::string::size_type pos = 0;
+  while((pos = str.find(what, pos)) != std::string::npos) {
+    str.replace(pos, what.size(), with);
+    pos += with.size();
+  }
+  return str;
+}
+
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Naming
+
+std::string CodecGenerator::toCppNamespace(const std::string& package) {
+  if(package.empty()) {
+    return "";
+  }
+  return "::" + replaceAll(package, ".", "::");
+}
+
+std::string CodecGenerator::getQualifiedName(const FileDescriptor* file, const std::string& fullName) {
+  std::string name = fullName;
+  if(!file->package().empty()) {
+    name = name.substr(file->package().size() + 1);
+  }
+  return toCppNamespace(file->package()) + "::" + replaceAll(name, ".", "_");
+}
+
+std::string CodecGenerator::getHeaderName(const FileDescriptor* file) {
+  std::string name = file->name();
+  const std::string suffix = ".proto";
+  if(name.size() > suffix.size() && name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0) {
+    name = name.substr(0, name.size() - suffix.size());
+  }
+  return name + ".oatpp.hpp";
+}
+
+std::string CodecGenerator::getClassName(const Descriptor* descriptor) {
+  return getQualifiedName(descriptor->file(), descriptor->full_name());
+}
+
+std::string CodecGenerator::getEnumName(const EnumDescriptor* descriptor) {
+  return getQualifiedName(descriptor->file(), descriptor->full_name());
+}
+
+std::string CodecGenerator::getFieldName(const FieldDescriptor* field) {
+  std::string name = field->name();
+  for(auto& c : name) {
+    if(c >= 'A' && c <= 'Z') {
+      c = c - 'A' + 'a';
+    }
+  }
+  if(CPP_KEYWORDS.find(name) != CPP_KEYWORDS.end()) {
+    name += "_";
+  }
+  return name;
+}
+
+std::string CodecGenerator::getScalarType(const FieldDescriptor* field) {
+  switch(field->cpp_type()) {
+    case FieldDescriptor::CPPTYPE_INT32: return "v_int32";
+    case FieldDescriptor::CPPTYPE_UINT32: return "v_uint32";
+    case FieldDescriptor::CPPTYPE_INT64: return "v_int64";
+    case FieldDescriptor::CPPTYPE_UINT64: return "v_uint64";
+    case FieldDescriptor::CPPTYPE_FLOAT: return "v_float32";
+    case FieldDescriptor::CPPTYPE_DOUBLE: return "v_float64";
+    case FieldDescriptor::CPPTYPE_BOOL: return "bool";
+    default: return "";
+  }
+}
+
+/*
+ * Same semantics as of `Reflection::HasField()`.
+ */
+std::string CodecGenerator::getPresenceCheck(const FieldDescriptor* field) {
+
+  std::string name = getFieldName(field);
+
+  if(field->has_presence()) {
+    return "message.has_" + name + "()";
+  }
+
+  switch(field->cpp_type()) {
+    case FieldDescriptor::CPPTYPE_STRING: return "!message." + name + "().empty()";
+    case FieldDescriptor::CPPTYPE_BOOL: return "message." + name + "()";
+    case FieldDescriptor::CPPTYPE_FLOAT:
+    case FieldDescriptor::CPPTYPE_DOUBLE: return "(message." + name + "() != 0 || std::signbit(message." + name + "()))";
+    default: return "message." + name + "() != 0";
+  }
+
+}
+
+bool CodecGenerator::isStatic(const FieldDescriptor* field) {
+  if(field->is_map() || field->type() == FieldDescriptor::TYPE_GROUP) {
+    return false;
+  }
+  if(field->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE) {
+    return field->message_type()->file() == field->file();
+  }
+  return true;
+}
+
+void CodecGenerator::collectMessages(const Descriptor* descriptor, std::vector<const Descriptor*>& messages) {
+  if(descriptor->options().map_entry()) {
+    return;
+  }
+  messages.push_back(descriptor);
+  for(int i = 0; i < descriptor->nested_type_count(); i ++) {
+    collectMessages(descriptor->nested_type(i), messages);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Declaration
+
+void CodecGenerator::generateDeclaration(Printer& printer, const Descriptor* descriptor) {
+
+  bool hasReflectedFields = false;
+  for(int i = 0; i < descriptor->field_count(); i ++) {
+    hasReflectedFields = hasReflectedFields || !isStatic(descriptor->field(i));
+  }
+
+  printer.Print(
+    "template<>\n"
+    "class Codec<$type$> : public AbstractCodec {\n"
+    "public:\n"
+    "  typedef $type$ Type;\n",
+    "type", getClassName(descriptor)
+  );
+
+  printer.Print(
+    "private:\n"
+    "\n"
+    "  /*\n"
+    "   * Conversion counters of the class - nested messages are accounted to their own classes.\n"
+    "   */\n"
+    "  static reflection::Statistics* getStatistics() {\n"
+    "    static reflection::Statistics* statistics = reflection::DynamicClass::registryGetClass<Type>()->getStatistics();\n"
+    "    return statistics;\n"
+    "  }\n"
+    "\n"
+  );
+
+  if(hasReflectedFields) {
+    printer.Print(
+      "  /*\n"
+      "   * Conversion plan of fields converted via reflection.\n"
+      "   */\n"
+      "  static const std::vector<reflection::FieldInfo>& getFields() {\n"
+      "    static const std::vector<reflection::FieldInfo>& fields = reflection::DynamicClass::registryGetClass<Type>()->getFields();\n"
+      "    return fields;\n"
+      "  }\n"
+      "\n"
+    );
+  }
+
+  printer.Print(
+    "public:\n"
+    "\n"
+    "  static const AbstractCodec* getInstance() {\n"
+    "    static Codec instance;\n"
+    "    return &instance;\n"
+    "  }\n"
+    "\n"
+    "  static void serialize(const json::Serializer::Options& options, ConsistentOutputStream* stream, const Type& message);\n"
+    "  static void deserialize(JsonDeserializer* deserializer, parser::Caret& caret, Type& message);\n"
+    "\n"
+    "  void writeJson(JsonSerializer* serializer, ConsistentOutputStream* stream, const reflection::Message& message) const override {\n"
+    "    serialize(json::Serializer::getOptions(serializer), stream, static_cast<const Type&>(message));\n"
+    "  }\n"
+    "\n"
+    "  void readJson(JsonDeserializer* deserializer, parser::Caret& caret, reflection::Message& message) const override {\n"
+    "    deserialize(deserializer, caret, static_cast<Type&>(message));\n"
+    "  }\n"
+    "\n"
+    "};\n"
+    "\n"
+  );
+
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Serializer
+
+void CodecGenerator::generateFieldSerializer(Printer& printer, const FieldDescriptor* field) {
+
+  std::string name = getFieldName(field);
+  std::string key = "\"" + field->name() + "\":";
+
+  std::map<std::string, std::string> vars;
+  vars["name"] = name;
+  vars["key"] = replaceAll(key, "\"", "\\\"");
+  vars["keySize"] = std::to_string(key.size());
+  vars["nullKeySize"] = std::to_string(key.size() + 4);
+  vars["index"] = std::to_string(field->index());
+  vars["presence"] = getPresenceCheck(field);
+  vars["size"] = field->is_map() ? "message." + name + "().size()" : "message." + name + "_size()";
+  if(field->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE) {
+    vars["nested"] = getClassName(field->message_type());
+  }
+  if(field->cpp_type() == FieldDescriptor::CPPTYPE_ENUM) {
+    vars["enum"] = getEnumName(field->enum_type());
+  }
+
+  if(field->is_repeated()) {
+
+    printer.Print(vars,
+      "if(!options.omitDefaults || $size$ > 0) {\n"
+      "  (first) ? first = false : stream->writeCharSimple(',');\n"
+      "  stream->writeSimple(\"$key$\", $keySize$);\n"
+    );
+    printer.Indent();
+
+    if(!isStatic(field)) {
+      printer.Print(vars, "json::Serializer::serializeRepeated(options, stream, message, getFields()[$index$]);\n");
+      printer.Outdent();
+      printer.Print("}\n");
+      return;
+    }
+
+    switch(field->cpp_type()) {
+
+      case FieldDescriptor::CPPTYPE_STRING:
+        printer.Print(vars,
+          "stream->writeCharSimple('[');\n"
+          "for(int i = 0; i < message.$name$_size(); i ++) {\n"
+          "  if(i > 0) {\n"
+          "    stream->writeCharSimple(',');\n"
+          "  }\n"
+          "  const auto& str = message.$name$(i);\n"
+          "  json::Serializer::serializeString(stream, str.data(), str.size());\n"
+          "}\n"
+          "stream->writeCharSimple(']');\n"
+        );
+        break;
+
+      case FieldDescriptor::CPPTYPE_ENUM:
+        printer.Print(vars,
+          "{\n"
+          "  static const reflection::EnumTable* table = reflection::EnumTable::get($enum$_descriptor());\n"
+          "  stream->writeCharSimple('[');\n"
+          "  for(int i = 0; i < message.$name$_size(); i ++) {\n"
+          "    if(i > 0) {\n"
+          "      stream->writeCharSimple(',');\n"
+          "    }\n"
+          "    json::Serializer::serializeEnum(options, stream, table, message.$name$(i));\n"
+          "  }\n"
+          "  stream->writeCharSimple(']');\n"
+          "}\n"
+        );
+        break;
+
+      case FieldDescriptor::CPPTYPE_MESSAGE:
+        printer.Print(vars,
+          "stream->writeCharSimple('[');\n"
+          "for(int i = 0; i < message.$name$_size(); i ++) {\n"
+          "  if(i > 0) {\n"
+          "    stream->writeCharSimple(',');\n"
+          "  }\n"
+          "  Codec<$nested$>::serialize(options, stream, message.$name$(i));\n"
+          "}\n"
+          "stream->writeCharSimple(']');\n"
+        );
+        break;
+
+      default:
+        printer.Print(vars, "json::Serializer::serializeScalars(stream, message.$name$());\n");
+
+    }
+
+    printer.Outdent();
+    printer.Print("}\n");
+    return;
+
+  }
+
+  /* fields without presence may be written with the default value */
+  printer.Print(vars,
+    field->has_presence() ? "if($presence$) {\n" : "if($presence$ || options.emitDefaults) {\n"
+  );
+  printer.Print(vars,
+    "  (first) ? first = false : stream->writeCharSimple(',');\n"
+    "  stream->writeSimple(\"$key$\", $keySize$);\n"
+  );
+  printer.Indent();
+
+  if(!isStatic(field)) {
+    printer.Print(vars, "json::Serializer::serializeValue(options, stream, message, getFields()[$index$]);\n");
+  } else {
+
+    switch(field->cpp_type()) {
+
+      case FieldDescriptor::CPPTYPE_STRING:
+        printer.Print(vars,
+          "const auto& str = message.$name$();\n"
+          "json::Serializer::serializeString(stream, str.data(), str.size());\n"
+        );
+        break;
+
+      case FieldDescriptor::CPPTYPE_ENUM:
+        printer.Print(vars,
+          "static const reflection::EnumTable* table = reflection::EnumTable::get($enum$_descriptor());\n"
+          "json::Serializer::serializeEnum(options, stream, table, message.$name$());\n"
+        );
+        break;
+
+      case FieldDescriptor::CPPTYPE_MESSAGE:
+        printer.Print(vars, "Codec<$nested$>::serialize(options, stream, message.$name$());\n");
+        break;
+
+      default:
+        printer.Print(vars, "stream->writeAsString(message.$name$());\n");
+
+    }
+
+  }
+
+  printer.Outdent();
+  printer.Print(vars,
+    field->has_presence() ? "} else if(options.includeNullFields) {\n" : "} else if(options.nullDefaults) {\n"
+  );
+  printer.Print(vars,
+    "  (first) ? first = false : stream->writeCharSimple(',');\n"
+    "  stream->writeSimple(\"$key$null\", $nullKeySize$);\n"
+    "}\n"
+  );
+
+}
+
+void CodecGenerator::generateSerializer(Printer& printer, const Descriptor* descriptor) {
+
+  printer.Print(
+    "inline void Codec<$type$>::serialize(const json::Serializer::Options& options, ConsistentOutputStream* stream, const Type& message) {\n"
+    "\n",
+    "type", getClassName(descriptor)
+  );
+  printer.Indent();
+
+  printer.Print(
+    "reflection::Statistics::Tracker tracker(getStatistics(), reflection::Statistics::PROTO_TO_JSON);\n"
+    "reflection::Statistics::onFieldsVisited($count$);\n"
+    "\n",
+    "count", std::to_string(descriptor->field_count())
+  );
+
+  if(descriptor->field_count() == 0) {
+    printer.Print("(void) options;\n(void) message;\n");
+  } else {
+    printer.Print("bool first = true;\n");
+  }
+  printer.Print("stream->writeCharSimple('{');\n\n");
+
+  for(int i = 0; i < descriptor->field_count(); i ++) {
+    generateFieldSerializer(printer, descriptor->field(i));
+    printer.Print("\n");
+  }
+
+  printer.Print("stream->writeCharSimple('}');\n\n");
+  printer.Outdent();
+  printer.Print("}\n\n");
+
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Deserializer
+
+void CodecGenerator::generateFieldDeserializer(Printer& printer, const FieldDescriptor* field) {
+
+  std::map<std::string, std::string> vars;
+  vars["name"] = getFieldName(field);
+  vars["index"] = std::to_string(field->index());
+  vars["scalar"] = getScalarType(field);
+  if(field->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE) {
+    vars["nested"] = getClassName(field->message_type());
+  }
+  if(field->cpp_type() == FieldDescriptor::CPPTYPE_ENUM) {
+    vars["enum"] = getEnumName(field->enum_type());
+  }
+
+  if(!isStatic(field)) {
+    if(field->is_repeated()) {
+      printer.Print(vars, "json::Deserializer::deserializeRepeated(deserializer, caret, message, getFields()[$index$]);\n");
+    } else {
+      printer.Print(vars, "json::Deserializer::deserializeValue(deserializer, caret, message, getFields()[$index$]);\n");
+    }
+    return;
+  }
+
+  if(field->is_repeated()) {
+
+    switch(field->cpp_type()) {
+
+      case FieldDescriptor::CPPTYPE_STRING:
+        printer.Print(vars,
+          "message.clear_$name$();\n"
+          "json::Deserializer::deserializeItems(caret, [&] {\n"
+          "  auto value = oatpp::parser::json::Utils::parseStringToStdString(caret);\n"
+          "  if(!caret.hasError()) {\n"
+          "    message.add_$name$(std::move(value));\n"
+          "  }\n"
+          "});\n"
+        );
+        break;
+
+      case FieldDescriptor::CPPTYPE_ENUM: {
+        printer.Print(vars,
+          "static const reflection::EnumTable* table = reflection::EnumTable::get($enum$_descriptor());\n"
+          "message.clear_$name$();\n"
+          "json::Deserializer::deserializeItems(caret, [&] {\n"
+          "  int value;\n"
+          "  if(json::Deserializer::parseEnum(caret, table, value)) {\n"
+          "    message.add_$name$(static_cast<$enum$>(value));\n"
+          "  }\n"
+          "});\n"
+        );
+        break;
+      }
+
+      case FieldDescriptor::CPPTYPE_MESSAGE:
+        printer.Print(vars,
+          "message.clear_$name$();\n"
+          "json::Deserializer::deserializeItems(caret, [&] {\n"
+          "  Codec<$nested$>::deserialize(deserializer, caret, *message.add_$name$());\n"
+          "});\n"
+        );
+        break;
+
+      default:
+        printer.Print(vars,
+          "message.clear_$name$();\n"
+          "json::Deserializer::deserializeScalars(caret, message.mutable_$name$());\n"
+        );
+
+    }
+
+    return;
+
+  }
+
+  switch(field->cpp_type()) {
+
+    case FieldDescriptor::CPPTYPE_STRING:
+      printer.Print(vars,
+        "auto value = oatpp::parser::json::Utils::parseStringToStdString(caret);\n"
+        "if(!caret.hasError()) {\n"
+        "  message.set_$name$(std::move(value));\n"
+        "}\n"
+      );
+      break;
+
+    case FieldDescriptor::CPPTYPE_ENUM: {
+      printer.Print(vars,
+        "static const reflection::EnumTable* table = reflection::EnumTable::get($enum$_descriptor());\n"
+        "int value;\n"
+        "if(json::Deserializer::parseEnum(caret, table, value)) {\n"
+        "  message.set_$name$(static_cast<$enum$>(value));\n"
+        "}\n"
+      );
+      break;
+    }
+
+    case FieldDescriptor::CPPTYPE_MESSAGE:
+      printer.Print(vars, "Codec<$nested$>::deserialize(deserializer, caret, *message.mutable_$name$());\n");
+      break;
+
+    default:
+      printer.Print(vars,
+        "auto value = json::Deserializer::parseScalar<$scalar$>(caret);\n"
+        "if(!caret.hasError()) {\n"
+        "  message.set_$name$(value);\n"
+        "}\n"
+      );
+
+  }
+
+}
+
+void CodecGenerator::generateDeserializer(Printer& printer, const Descriptor* descriptor) {
+
+  printer.Print(
+    "inline void Codec<$type$>::deserialize(JsonDeserializer* deserializer, parser::Caret& caret, Type& message) {\n"
+    "\n",
+    "type", getClassName(descriptor)
+  );
+  printer.Indent();
+
+  printer.Print("reflection::Statistics::Tracker tracker(getStatistics(), reflection::Statistics::JSON_TO_PROTO);\n\n");
+
+  if(descriptor->field_count() == 0) {
+    printer.Print(
+      "(void) message;\n"
+      "json::Deserializer::deserializeFields(deserializer, caret, [](const std::string& /* key */) -> bool {\n"
+      "  return false;\n"
+      "});\n"
+    );
+    printer.Outdent();
+    printer.Print("\n}\n\n");
+    return;
+  }
+
+  /* group fields by key size - the key is matched with a single comparison in most cases */
+  std::map<std::size_t, std::vector<const FieldDescriptor*>> fieldsBySize;
+  for(int i = 0; i < descriptor->field_count(); i ++) {
+    const FieldDescriptor* field = descriptor->field(i);
+    fieldsBySize[field->name().size()].push_back(field);
+  }
+
+  printer.Print(
+    "json::Deserializer::deserializeFields(deserializer, caret, [&](const std::string& key) -> bool {\n"
+    "\n"
+    "  switch(key.size()) {\n"
+    "\n"
+  );
+  printer.Indent();
+  printer.Indent();
+
+  for(const auto& group : fieldsBySize) {
+
+    printer.Print("case $size$:\n", "size", std::to_string(group.first));
+    printer.Indent();
+
+    for(const FieldDescriptor* field : group.second) {
+      printer.Print(
+        "if(key == \"$key$\") {\n"
+        "  reflection::Statistics::onFieldsVisited(1);\n"
+        "  if(!caret.isAtText(\"null\", true)) {\n",
+        "key", field->name()
+      );
+      printer.Indent();
+      printer.Indent();
+      generateFieldDeserializer(printer, field);
+      printer.Outdent();
+      printer.Outdent();
+      printer.Print(
+        "  }\n"
+        "  return true;\n"
+        "}\n"
+      );
+    }
+
+    printer.Print("break;\n\n");
+    printer.Outdent();
+
+  }
+
+  printer.Outdent();
+  printer.Print(
+    "}\n"
+    "\n"
+    "return false;\n"
+    "\n"
+  );
+  printer.Outdent();
+  printer.Print("});\n\n");
+
+  printer.Outdent();
+  printer.Print("}\n\n");
+
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Header
+
+std::string CodecGenerator::generateHeader(const FileDescriptor* file) {
+
+  std::vector<const Descriptor*> messages;
+  for(int i = 0; i < file->message_type_count(); i ++) {
+    collectMessages(file->message_type(i), messages);
+  }
+
+  std::string guard = "oatpp_codec_" + file->name();
+  for(auto& c : guard) {
+    if(!((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9'))) {
+      c = '_';
+    }
+  }
+
+  std::string pbHeader = getHeaderName(file);
+  pbHeader = pbHeader.substr(0, pbHeader.size() - std::string(".oatpp.hpp").size()) + ".pb.h";
+
+  std::string result;
+  {
+
+    google::protobuf::io::StringOutputStream output(&result);
+    Printer printer(&output, '$');
+
+    printer.Print(
+      "// Generated by protoc-gen-oatpp. DO NOT EDIT!\n"
+      "// source: $source$\n"
+      "\n"
+      "#ifndef $guard$\n"
+      "#define $guard$\n"
+      "\n"
+      "#include \"$pbHeader$\"\n"
+      "\n"
+      "#include \"oatpp-protobuf/json/Deserializer.hpp\"\n"
+      "#include \"oatpp-protobuf/json/Serializer.hpp\"\n"
+      "\n"
+      "#include <cmath>\n"
+      "\n"
+      "namespace oatpp { namespace protobuf { namespace codec {\n"
+      "\n",
+      "source", file->name(),
+      "guard", guard,
+      "pbHeader", pbHeader
+    );
+
+    for(const Descriptor* descriptor : messages) {
+      generateDeclaration(printer, descriptor);
+    }
+
+    for(const Descriptor* descriptor : messages) {
+      generateSerializer(printer, descriptor);
+      generateDeserializer(printer, descriptor);
+    }
+
+    if(!messages.empty()) {
+      /* every translation unit which includes the header registers the codecs - registering twice is a no-op */
+      printer.Print(
+        "namespace {\n"
+        "\n"
+        "const bool $guard$_registered =\n",
+        "guard", guard
+      );
+      for(std::size_t i = 0; i < messages.size(); i ++) {
+        printer.Print(
+          "  AbstractCodec::registryAddCodec(\"$name$\", Codec<$type$>::getInstance())$end$\n",
+          "name", messages[i]->full_name(),
+          "type", getClassName(messages[i]),
+          "end", i + 1 < messages.size() ? " &&" : ";"
+        );
+      }
+      printer.Print(
+        "\n"
+        "}\n"
+        "\n"
+      );
+    }
+
+    printer.Print(
+      "}}}\n"
+      "\n"
+      "#endif // $guard$\n",
+      "guard", guard
+    );
+
+  }
+
+  return result;
+
+}
+
+}}}
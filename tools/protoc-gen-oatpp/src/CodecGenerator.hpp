@@ -0,0 +1,98 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#ifndef oatpp_protobuf_codegen_CodecGenerator_hpp
+#define oatpp_protobuf_codegen_CodecGenerator_hpp
+
+#include <google/protobuf/descriptor.h>
+#include <google/protobuf/io/printer.h>
+
+#include <string>
+
+namespace oatpp { namespace protobuf { namespace codegen {
+
+/**
+ * Generator of `oatpp::protobuf::codec::Codec<T>` specializations. <br>
+ * For each message of the proto file generates a header-only codec which converts the message to/from json
+ * via generated accessors. <br>
+ * Fields which can't be accessed statically (map fields, groups, messages declared in other files) fall back
+ * to the reflection-based `oatpp::protobuf::json::Serializer/Deserializer`.
+ */
+class CodecGenerator {
+public:
+  typedef google::protobuf::FileDescriptor FileDescriptor;
+  typedef google::protobuf::Descriptor Descriptor;
+  typedef google::protobuf::FieldDescriptor FieldDescriptor;
+  typedef google::protobuf::EnumDescriptor EnumDescriptor;
+  typedef google::protobuf::io::Printer Printer;
+private:
+  static std::string toCppNamespace(const std::string& package);
+  static std::string getQualifiedName(const FileDescriptor* file, const std::string& fullName);
+  static std::string getFieldName(const FieldDescriptor* field);
+  static std::string getScalarType(const FieldDescriptor* field);
+  static std::string getPresenceCheck(const FieldDescriptor* field);
+  static bool isStatic(const FieldDescriptor* field);
+  static void collectMessages(const Descriptor* descriptor, std::vector<const Descriptor*>& messages);
+private:
+  static void generateDeclaration(Printer& printer, const Descriptor* descriptor);
+  static void generateFieldSerializer(Printer& printer, const FieldDescriptor* field);
+  static void generateSerializer(Printer& printer, const Descriptor* descriptor);
+  static void generateFieldDeserializer(Printer& printer, const FieldDescriptor* field);
+  static void generateDeserializer(Printer& printer, const Descriptor* descriptor);
+public:
+
+  /**
+   * Get name of the generated header. `path/name.proto` -> `path/name.oatpp.hpp`.
+   * @param file
+   * @return
+   */
+  static std::string getHeaderName(const FileDescriptor* file);
+
+  /**
+   * Get C++ class name of the message. Ex.: `::package::Outer_Inner`.
+   * @param descriptor
+   * @return
+   */
+  static std::string getClassName(const Descriptor* descriptor);
+
+  /**
+   * Get C++ type name of the enum. Ex.: `::package::Outer_Enum`.
+   * @param descriptor
+   * @return
+   */
+  static std::string getEnumName(const EnumDescriptor* descriptor);
+
+  /**
+   * Generate header with codecs for all messages of the file.
+   * @param file
+   * @return - header contents.
+   */
+  static std::string generateHeader(const FileDescriptor* file);
+
+};
+
+}}}
+
+#endif // oatpp_protobuf_codegen_CodecGenerator_hpp
@@ -0,0 +1,68 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#include "CodecGenerator.hpp"
+
+#include <google/protobuf/compiler/code_generator.h>
+#include <google/protobuf/compiler/plugin.h>
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream.h>
+
+#include <memory>
+
+namespace {
+
+/**
+ * protoc plugin entry. Writes `<name>.oatpp.hpp` next to `<name>.pb.h` for each proto file.
+ */
+class Generator : public google::protobuf::compiler::CodeGenerator {
+public:
+
+  bool Generate(const google::protobuf::FileDescriptor* file,
+                const std::string& parameter,
+                google::protobuf::compiler::GeneratorContext* context,
+                std::string* error) const override
+  {
+    (void) parameter;
+    (void) error;
+    typedef oatpp::protobuf::codegen::CodecGenerator CodecGenerator;
+    std::unique_ptr<google::protobuf::io::ZeroCopyOutputStream> output(context->Open(CodecGenerator::getHeaderName(file)));
+    google::protobuf::io::CodedOutputStream stream(output.get());
+    stream.WriteString(CodecGenerator::generateHeader(file));
+    return !stream.HadError();
+  }
+
+  uint64_t GetSupportedFeatures() const override {
+    return FEATURE_PROTO3_OPTIONAL;
+  }
+
+};
+
+}
+
+int main(int argc, char* argv[]) {
+  Generator generator;
+  return google::protobuf::compiler::PluginMain(argc, argv, &generator);
+}